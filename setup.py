@@ -76,11 +76,16 @@ class BuildExt(setuptools.command.build_ext.build_ext):
     #: Preferred NetCDF prefix
     NETCDF_DIR = None
 
+    #: Instruction set of the vectorized kernels
+    SIMD = None
+
     user_options = setuptools.command.build_ext.build_ext.user_options + [
         ('boost-root=', None, 'Preferred Boost installation prefix'),
         ('cxx-compiler=', None, 'Preferred C++ compiler'),
         ('netcdf-dir=', None, 'Preferred NETCDF installation prefix'),
         ('reconfigure', None, 'Forces CMake to reconfigure this project'),
+        ('simd=', None, 'Instruction set of the vectorized kernels: native, '
+         'avx2, avx512 or off (default)'),
         ('udunits2-root=', None, 'Preferred UDUNITS-2 installation prefix'),
     ]
 
@@ -91,6 +96,7 @@ class BuildExt(setuptools.command.build_ext.build_ext):
         self.cxx_compiler = None
         self.netcdf_dir = None
         self.reconfigure = None
+        self.simd = None
         self.udunits2_root = None
 
     def finalize_options(self):
@@ -104,6 +110,8 @@ class BuildExt(setuptools.command.build_ext.build_ext):
             BuildExt.NETCDF_DIR = self.netcdf_dir
         if self.reconfigure is not None:
             BuildExt.RECONFIGURE = True
+        if self.simd is not None:
+            BuildExt.SIMD = self.simd
         if self.udunits2_root is not None:
             BuildExt.UDUNITS2_ROOT = self.udunits2_root
 
@@ -195,6 +203,9 @@ class BuildExt(setuptools.command.build_ext.build_ext):
         elif is_conda:
             result.append(self.netcdf())
 
+        if self.SIMD is not None:
+            result.append('-DLAGRANGIAN_SIMD=' + self.SIMD)
+
         if is_conda:
             result.append('-DCMAKE_PREFIX_PATH=' + sys.prefix)
 
@@ -12,14 +12,20 @@
 //
 // You should have received a copy of GNU Lesser General Public License
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #include "datetime.hpp"
 #include "lagrangian/field/time_serie.hpp"
 #include "lagrangian/field/vonkarman.hpp"
+#include "vectorize.hpp"
 
 namespace py = pybind11;
 
@@ -28,11 +34,22 @@ class Python : public lagrangian::Field {
   Python(py::object parent, const UnitType unit_type,
          const CoordinatesType coordinates_type)
       : lagrangian::Field(unit_type, coordinates_type),
-        parent_(std::move(std::move(parent))) {}
+        parent_(std::move(std::move(parent))),
+        compute_(Implements(parent_, "compute")),
+        compute_many_(Implements(parent_, "compute_many")),
+        fetch_(Implements(parent_, "fetch")) {}
 
   auto Compute(const double t, const double x, const double y, double &u,
-               double &v, lagrangian::CellProperties & /*cell*/) const
+               double &v, lagrangian::CellProperties &cell) const
       -> bool override {
+    // A field implementing only the batched protocol evaluates a single
+    // point as a batch of one point.
+    if (!compute_ && compute_many_) {
+      ComputeMany(t, 1, &x, &y, &u, &v, cell);
+      return !std::isnan(u) && !std::isnan(v);
+    }
+    // The field can be evaluated by threads not holding the GIL.
+    py::gil_scoped_acquire acquire;
     auto method = parent_.attr("compute");
     auto datetime = to_datetime(lagrangian::DateTime::FromUnixTime(t));
     py::object result = method(datetime, x, y);
@@ -48,7 +65,45 @@ class Python : public lagrangian::Field {
     return false;
   }
 
+  void ComputeMany(const double t, const size_t n, const double *const x,
+                   const double *const y, double *const u, double *const v,
+                   lagrangian::CellProperties &cell) const override {
+    if (!compute_many_) {
+      lagrangian::Field::ComputeMany(t, n, x, y, u, v, cell);
+      return;
+    }
+    py::gil_scoped_acquire acquire;
+    auto method = parent_.attr("compute_many");
+    auto datetime = to_datetime(lagrangian::DateTime::FromUnixTime(t));
+
+    // The coordinates are copied: the buffers of the caller must not be
+    // referenced by the arrays kept by the Python code.
+    const auto size = static_cast<py::ssize_t>(n);
+    auto result = method(datetime, py::array_t<double>(size, x),
+                         py::array_t<double>(size, y))
+                      .cast<py::tuple>();
+    if (result.size() != 2) {
+      throw std::invalid_argument(
+          "compute_many must return the tuple of the arrays (u, v)");
+    }
+    auto u_many = vectorize::Array::ensure(result[0]);
+    auto v_many = vectorize::Array::ensure(result[1]);
+    if (!u_many || !v_many || static_cast<size_t>(u_many.size()) != n ||
+        static_cast<size_t>(v_many.size()) != n) {
+      throw std::invalid_argument(
+          "compute_many must return two arrays of " + std::to_string(n) +
+          " velocities");
+    }
+    std::copy(u_many.data(), u_many.data() + n, u);
+    std::copy(v_many.data(), v_many.data() + n, v);
+  }
+
   void Fetch(const double t0, const double t1) override {
+    // A field without data to load does not implement this method.
+    if (!fetch_) {
+      return;
+    }
+    py::gil_scoped_acquire acquire;
     auto method = parent_.attr("fetch");
     method(to_datetime(lagrangian::DateTime::FromUnixTime(t0)),
            to_datetime(lagrangian::DateTime::FromUnixTime(t1)));
@@ -56,6 +111,25 @@ class Python : public lagrangian::Field {
 
  private:
   py::object parent_;
+
+  /// True if the Python class implements the evaluation of a point
+  bool compute_;
+
+  /// True if the Python class implements the evaluation of a set of points
+  bool compute_many_;
+
+  /// True if the Python class implements the loading of the data
+  bool fetch_;
+
+  // Test if the class of the Python object implements a method, instead of
+  // inheriting it from the class Field.
+  static auto Implements(const py::object &self, const char *const name)
+      -> bool {
+    auto method = py::getattr(py::type::of(self), name, py::none());
+    return !method.is_none() &&
+           !method.is(py::getattr(py::type::of<lagrangian::Field>(), name,
+                                  py::none()));
+  }
 };
 
 void init_field(pybind11::module &m) {
@@ -139,6 +213,66 @@ Args:
 Returns:
     tuple, optional: U and V components of the velocities evaluated or None if
     the velocity is undefined for the requested space-time position
+)__doc__")
+      .def(
+          "compute",
+          [](const lagrangian::Field &self, const py::object &t,
+             const vectorize::Array &x, const vectorize::Array &y,
+             const int num_threads) -> py::tuple {
+            vectorize::CheckShape(x, y);
+            auto dates = vectorize::UnixTime(t, x);
+            auto u = vectorize::Empty<double>(x);
+            auto v = vectorize::Empty<double>(x);
+            auto mask = vectorize::Empty<bool>(x);
+            const auto *const t0 = dates.data();
+            const auto *const x0 = x.data();
+            const auto *const y0 = y.data();
+            auto *const u1 = u.mutable_data();
+            auto *const v1 = v.mutable_data();
+            auto *const defined = mask.mutable_data();
+            const auto single_date = dates.size() == 1;
+
+            vectorize::ParallelFor(
+                x.size(), num_threads,
+                [&](const size_t first, const size_t last,
+                    lagrangian::CellProperties &cell) {
+                  if (single_date) {
+                    self.ComputeMany(*t0, last - first, x0 + first,
+                                     y0 + first, u1 + first, v1 + first,
+                                     cell);
+                  } else {
+                    for (auto ix = first; ix < last; ++ix) {
+                      if (!self.Compute(t0[ix], x0[ix], y0[ix], u1[ix],
+                                        v1[ix], cell)) {
+                        u1[ix] = v1[ix] =
+                            std::numeric_limits<double>::quiet_NaN();
+                      }
+                    }
+                  }
+                  vectorize::Mask(first, last, u1, v1, defined);
+                });
+            return py::make_tuple(u, v, mask);
+          },
+          py::arg("t"), py::arg("x"), py::arg("y"), py::arg("num_threads") = 0,
+          R"__doc__(
+Interpolates the velocity of a set of points. The points are processed in
+parallel, without holding the GIL.
+
+Args:
+    t (datetime.datetime, numpy.ndarray): Date to evaluate, or the dates of
+        each point (e.g. an array of numpy.datetime64)
+    x (numpy.ndarray): Longitudes expressed as degree
+    y (numpy.ndarray): Latitudes expressed as degree, with the shape of the
+        longitudes
+    num_threads (int): Number of threads used, all the CPUs if 0.
+
+Returns:
+    tuple: U and V components of the velocities evaluated, ``nan`` if the
+    velocity is undefined for the requested space-time position, and the mask
+    of the velocities defined.
+
+Raises:
+    ValueError: if the coordinates, or the dates, have different shapes.
 )__doc__");
 
   py::module field = m.def_submodule("field");
@@ -148,11 +282,13 @@ Returns:
       .def(
           py::init<std::string, lagrangian::Field::UnitType,
                    lagrangian::Field::CoordinatesType,
-                   lagrangian::reader::Factory::Type>(),
+                   lagrangian::reader::Factory::Type,
+                   lagrangian::Grid::Storage>(),
           py::arg("configuration_file"),
           py::arg("unit_type") = lagrangian::Field::kMetric,
           py::arg("coordinates_type") = lagrangian::Field::kSphericalEquatorial,
           py::arg("reader_type") = lagrangian::reader::Factory::kNetCDF,
+          py::arg("storage") = lagrangian::Grid::kFloat64,
           R"__doc__(
  Default constructor
 
@@ -163,6 +299,29 @@ Returns:
     coordniates_type (lagrangian.CoordinatesType) : Type of coordinates
     reader_type (lagrangian.reader.Type) The reader used to read grids
         containing velocities.
+    storage (lagrangian.reader.Storage) Type used to store the grids
+        loaded into memory.
+)__doc__")
+      .def("set_bounding_box", &lagrangian::field::TimeSerie::SetBoundingBox,
+           py::arg("x_min"), py::arg("x_max"), py::arg("y_min"),
+           py::arg("y_max"), py::arg("distance") = 0, R"__doc__(
+Restricts the grids read to the region that the particles can reach. The
+velocities outside this region are undefined.
+
+Args:
+    x_min (float): Minimum longitude in degrees
+    x_max (float): Maximum longitude in degrees
+    y_min (float): Minimum latitude in degrees
+    y_max (float): Maximum latitude in degrees
+    distance (float): Maximum distance, in meters, travelled by the
+        particles, widening the region.
+)__doc__")
+      .def_property("time_slabs", &lagrangian::field::TimeSerie::time_slabs,
+                    &lagrangian::field::TimeSerie::set_time_slabs,
+                    R"__doc__(
+True if the grids are interpolated in time once per time step of the
+integration, the velocities of the particles being then interpolated in a
+single grid. This option requires to keep three more grids in memory.
 )__doc__")
       .def("start_time", &lagrangian::field::TimeSerie::StartTime,
            "Returns the date of the first grid constituting the time series.")
@@ -174,7 +333,16 @@ Returns:
       .def(py::init<>());
 
   py::class_<Python, lagrangian::Field>(
-      field, "Python", "Class to implement a velocity field in Python")
+      field, "Python", R"__doc__(Class to implement a velocity field in Python
+
+The derived class implements the method ``compute(t, x, y)``, returning the
+tuple ``(u, v)`` of the velocity at the point requested or None if it is
+undefined, and/or the method ``compute_many(t, x, y)``, returning the tuple
+of the arrays ``(u, v)`` of the velocities of the arrays of points requested,
+``nan`` where the velocity is undefined. If ``compute_many`` is implemented,
+the integration evaluates the field with one call per block of points and
+per step of the Runge-Kutta method instead of one call per point.
+)__doc__")
       .def(py::init<py::object, lagrangian::Field::UnitType,
                     lagrangian::Field::CoordinatesType>(),
            py::arg("self"), py::arg("unit_type") = lagrangian::Field::kMetric,
@@ -18,9 +18,15 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "datetime.hpp"
+#include "lagrangian/trajectories.hpp"
+#include "vectorize.hpp"
 
 namespace py = pybind11;
 
@@ -67,6 +73,66 @@ Returns:
     tuple, optional: A tuple that contains the longitude/latitude after the
     shift or None if the velocity field is undefined for the requested
     position
+)__doc__")
+      .def(
+          "compute",
+          [](const lagrangian::RungeKutta &self, const py::object &t,
+             const vectorize::Array &x, const vectorize::Array &y,
+             const int num_threads) -> py::tuple {
+            vectorize::CheckShape(x, y);
+            auto dates = vectorize::UnixTime(t, x);
+            auto xi = vectorize::Empty<double>(x);
+            auto yi = vectorize::Empty<double>(x);
+            auto mask = vectorize::Empty<bool>(x);
+            const auto *const t0 = dates.data();
+            const auto *const x0 = x.data();
+            const auto *const y0 = y.data();
+            auto *const x1 = xi.mutable_data();
+            auto *const y1 = yi.mutable_data();
+            auto *const defined = mask.mutable_data();
+            const auto single_date = dates.size() == 1;
+
+            vectorize::ParallelFor(
+                x.size(), num_threads,
+                [&](const size_t first, const size_t last,
+                    lagrangian::CellProperties &cell) {
+                  if (single_date) {
+                    self.ComputeMany(*t0, last - first, x0 + first,
+                                     y0 + first, x1 + first, y1 + first,
+                                     cell);
+                  } else {
+                    for (auto ix = first; ix < last; ++ix) {
+                      if (!self.Compute(t0[ix], x0[ix], y0[ix], x1[ix],
+                                        y1[ix], cell)) {
+                        x1[ix] = y1[ix] =
+                            std::numeric_limits<double>::quiet_NaN();
+                      }
+                    }
+                  }
+                  vectorize::Mask(first, last, x1, y1, defined);
+                });
+            return py::make_tuple(xi, yi, mask);
+          },
+          py::arg("t"), py::arg("x"), py::arg("y"), py::arg("num_threads") = 0,
+          R"__doc__(
+Move a set of points in a velocity field. The points are processed in
+parallel, without holding the GIL.
+
+Args:
+    t (datetime.datetime, numpy.ndarray): Date, or the dates of each point
+        (e.g. an array of numpy.datetime64)
+    x (numpy.ndarray): Longitudes in degrees
+    y (numpy.ndarray): Latitudes in degrees, with the shape of the
+        longitudes
+    num_threads (int): Number of threads used, all the CPUs if 0.
+
+Returns:
+    tuple: The longitudes/latitudes after the shift, ``nan`` if the velocity
+    field is undefined for the requested position, and the mask of the
+    points moved.
+
+Raises:
+    ValueError: if the coordinates, or the dates, have different shapes.
 )__doc__");
 
   py::enum_<lagrangian::FiniteLyapunovExponentsIntegration::Mode>(
@@ -83,7 +149,11 @@ Returns:
              "Define a stencil with 3 points")
       .value("QUINTUPLET",
              lagrangian::FiniteLyapunovExponentsIntegration::kQuintuplet,
-             "Define a stencil with 5 points");
+             "Define a stencil with 5 points")
+      .value("VARIATIONAL",
+             lagrangian::FiniteLyapunovExponentsIntegration::kVariational,
+             "Define a stencil with one point moved with the gradient of the "
+             "flow map");
 
   py::class_<lagrangian::Position>(
       m, "Position", "Define the position of N points Mᵢ = (xᵢ, yᵢ)")
@@ -214,6 +284,33 @@ Args:
            R"__doc__(
 Construct a new object defining the position of the 5 points
 
+Args:
+    x (float): Longitude of the initial point
+    y (float): Latitude of the initial point
+    delta (float): Initial separation in degrees of neighboring
+    start_time (datetime.datetime): Advection starting time particles
+    spherical_equatorial (bool): True if the coordinates system is Lon/lat
+        otherwise false
+)__doc__");
+
+  py::class_<lagrangian::Variational, lagrangian::Triplet>(
+      m, "Variational",
+      "Define the position of 3 points moved by the linearized flow around "
+      "the first one")
+      .def(py::init<>())
+      .def(py::init([](const double x, const double y, const double delta,
+                       const lagrangian::DateTime &date,
+                       const bool spherical_equatorial) {
+             return std::make_unique<lagrangian::Variational>(
+                 x, y, delta, date.ToUnixTime(), spherical_equatorial);
+           }),
+           py::arg("x"), py::arg("y"), py::arg("delta"), py::arg("start_time"),
+           py::arg("spherical_equatorial") = true,
+           R"__doc__(
+Construct a new object defining the position of a point and of its two
+neighbours, placed by the gradient of the flow map integrated along the
+trajectory of the point
+
 Args:
     x (float): Longitude of the initial point
     y (float): Latitude of the initial point
@@ -297,6 +394,15 @@ Args:
 Returns:
     tuple, optional: the position updated otherwise None if new position
     is undefined
+)__doc__")
+      .def_property("fast_spherical",
+                    &lagrangian::Integration::fast_spherical,
+                    &lagrangian::Integration::set_fast_spherical,
+                    R"__doc__(
+True to move the points of a metric field defined in a spherical equatorial
+coordinates system with polynomials evaluating the increments of longitude
+and latitude instead of trigonometric functions. The positions are identical
+up to the rounding errors.
 )__doc__");
 
   py::class_<lagrangian::Path, lagrangian::Integration>(
@@ -316,6 +422,124 @@ Args:
 )__doc__",
            py::keep_alive<1, 5>());
 
+  py::class_<lagrangian::Trajectories>(m, "Trajectories", R"__doc__(
+Trajectories of a set of particles (e.g. drifting buoys)
+
+The positions of the particles are stored in contiguous arrays and all the
+particles are moved in parallel at each time step of the integration. A
+particle whose velocity becomes undefined is no longer tracked: its positions
+are then set to ``nan``.
+)__doc__")
+      .def(py::init([](const vectorize::Array &x, const vectorize::Array &y) {
+             vectorize::CheckShape(x, y);
+             return lagrangian::Trajectories(
+                 std::vector<double>(x.data(), x.data() + x.size()),
+                 std::vector<double>(y.data(), y.data() + y.size()));
+           }),
+           py::arg("x"), py::arg("y"), R"__doc__(
+Default constructor
+
+Args:
+    x (numpy.ndarray): Initial longitudes of the particles in degrees
+    y (numpy.ndarray): Initial latitudes of the particles in degrees
+
+Raises:
+    ValueError: if the longitudes and latitudes have different shapes.
+)__doc__")
+      .def("__len__", &lagrangian::Trajectories::size,
+           "Returns the number of particles")
+      .def_static("steps", &lagrangian::Trajectories::Steps,
+                  py::arg("integration"), R"__doc__(
+Returns the number of dates of an integration, i.e. the number of positions
+computed for each particle.
+
+Args:
+    integration (lagrangian.Integration): Integration properties
+
+Returns:
+    int: The number of dates
+)__doc__")
+      .def(
+          "compute",
+          [](lagrangian::Trajectories &self,
+             lagrangian::Integration &integration,
+             const int num_threads) -> py::tuple {
+            const auto steps = lagrangian::Trajectories::Steps(integration);
+            const auto size = self.size();
+            auto dates = py::array_t<int64_t>(
+                py::array::ShapeContainer({static_cast<py::ssize_t>(steps)}));
+            auto x = py::array_t<double>(py::array::ShapeContainer(
+                {static_cast<py::ssize_t>(steps),
+                 static_cast<py::ssize_t>(size)}));
+            auto y = py::array_t<double>(py::array::ShapeContainer(
+                {static_cast<py::ssize_t>(steps),
+                 static_cast<py::ssize_t>(size)}));
+            auto *dates_ = dates.mutable_data();
+            auto *x_ = x.mutable_data();
+            auto *y_ = y.mutable_data();
+            {
+              auto gil = py::gil_scoped_release();
+              self.Compute(integration, num_threads,
+                           [&](const double t, const double *const xi,
+                               const double *const yi) {
+                             *dates_++ = std::llround(t * 1e6);
+                             x_ = std::copy(xi, xi + size, x_);
+                             y_ = std::copy(yi, yi + size, y_);
+                           });
+            }
+            return py::make_tuple(dates.attr("view")("datetime64[us]"), x, y);
+          },
+          py::arg("integration"), py::arg("num_threads") = 0, R"__doc__(
+Compute the trajectories of the particles.
+
+Args:
+    integration (lagrangian.Integration): Integration properties (e.g.
+        :py:class:`lagrangian.Path`)
+    num_threads (int, optional): The number of threads to use for the
+        computation. If 0 all CPUs are used. If 1 is given, no parallel
+        computing code is used at all, which is useful for debugging.
+        Defaults to 0.
+
+Returns:
+    tuple: The dates of the integration (numpy.datetime64) and the matrices
+    of the longitudes and latitudes of the particles at these dates, of shape
+    (dates, particles).
+)__doc__")
+      .def(
+          "compute",
+          [](lagrangian::Trajectories &self,
+             lagrangian::Integration &integration, const py::function &callback,
+             const int num_threads) -> void {
+            const auto size = static_cast<py::ssize_t>(self.size());
+            auto gil = py::gil_scoped_release();
+            self.Compute(integration, num_threads,
+                         [&](const double t, const double *const xi,
+                             const double *const yi) {
+                           py::gil_scoped_acquire acquire;
+                           callback(
+                               to_datetime(
+                                   lagrangian::DateTime::FromUnixTime(t)),
+                               py::array_t<double>(size, xi),
+                               py::array_t<double>(size, yi));
+                         });
+          },
+          py::arg("integration"), py::arg("callback"),
+          py::arg("num_threads") = 0, R"__doc__(
+Compute the trajectories of the particles, handing out their positions to a
+function at each date of the integration instead of keeping them in memory.
+
+Args:
+    integration (lagrangian.Integration): Integration properties (e.g.
+        :py:class:`lagrangian.Path`)
+    callback (callable): Function called at each date with the date
+        (datetime.datetime) and the arrays of the longitudes and latitudes of
+        the particles at this date.
+    num_threads (int, optional): The number of threads to use for the
+        computation. If 0 all CPUs are used. If 1 is given, no parallel
+        computing code is used at all, which is useful for debugging.
+        Defaults to 0.
+)__doc__");
+
   py::class_<lagrangian::FiniteLyapunovExponents>(
       m, "FiniteLyapunovExponents", "Storing Lyapunov coefficients calculated")
       .def(py::init<>())
@@ -421,7 +645,11 @@ Args:
 )__doc__",
            py::keep_alive<1, 8>())
       .def("set_initial_point",
-           &lagrangian::FiniteLyapunovExponentsIntegration::SetInitialPoint,
+           py::overload_cast<
+               double, double,
+               lagrangian::FiniteLyapunovExponentsIntegration::Stencil, bool>(
+               &lagrangian::FiniteLyapunovExponentsIntegration::SetInitialPoint,
+               py::const_),
            py::arg("x"), py::arg("y"), py::arg("stencil"),
            py::arg("spherical_equatorial") = true, R"__doc__(
 Set the value of the initial point
@@ -437,7 +665,9 @@ Returns:
     lagrangian.Position: The position of the initial point
 )__doc__")
       .def("separation",
-           &lagrangian::FiniteLyapunovExponentsIntegration::Separation,
+           py::overload_cast<const lagrangian::Position *const>(
+               &lagrangian::FiniteLyapunovExponentsIntegration::Separation,
+               py::const_),
            py::arg("position"), R"__doc__(
 Determine whether the particle is deemed to be separate
 
@@ -470,7 +700,10 @@ Returns:
     True if the integration is defined otherwise false
 )__doc__")
       .def("exponents",
-           &lagrangian::FiniteLyapunovExponentsIntegration::ComputeExponents,
+           py::overload_cast<const lagrangian::Position *,
+                             lagrangian::FiniteLyapunovExponents &>(
+               &lagrangian::FiniteLyapunovExponentsIntegration::
+                   ComputeExponents),
            py::arg("position"), py::arg("fsle"), R"__doc__(
 Compute the eigenvalue and the orientation of the eigenvectors of the
 Cauchy-Green strain tensor
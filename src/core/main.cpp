@@ -15,6 +15,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "lagrangian/grid_cache.hpp"
 #include "lagrangian/trace.hpp"
 
 namespace py = pybind11;
@@ -53,5 +54,15 @@ Args:
 
 Args:
   message (str): Message to display
+)__doc__")
+      .def("set_shared_memory", &lagrangian::GridCache::SetSharedMemory,
+           py::arg("value"),
+           R"__doc__(Enable or disable the sharing of the grids loaded into
+memory between the processes running on the same node. The first process
+reading a grid stores it in a POSIX shared memory segment, the others map
+this segment instead of reading the file again.
+
+Args:
+  value (bool): True to store the grids in shared memory
 )__doc__");
 }
@@ -14,12 +14,33 @@
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
 #include "lagrangian/map.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "datetime.hpp"
+
 namespace py = pybind11;
 
+// Exposes a map to NumPy without copying its values. The array returned owns
+// the map, which is released when the array is destroyed.
+static auto to_array(std::unique_ptr<lagrangian::Map<double>> map)
+    -> py::array_t<double> {
+  auto *data = map->data();
+  auto shape = py::array::ShapeContainer({map->get_nx(), map->get_ny()});
+  auto owner = py::capsule(map.get(), [](void *ptr) {
+    delete static_cast<lagrangian::Map<double> *>(ptr);
+  });
+  // From now on, the capsule is responsible for the release of the map
+  map.release();
+  return py::array_t<double>(shape, data, owner);
+}
+
 class MapOfFiniteLyapunovExponents {
  private:
   lagrangian::MapOfFiniteLyapunovExponents map_;
@@ -30,103 +51,263 @@ class MapOfFiniteLyapunovExponents {
       const lagrangian::MapProperties &map_properties,
       const lagrangian::FiniteLyapunovExponentsIntegration &fle,
       const lagrangian::FiniteLyapunovExponentsIntegration::Stencil &stencil,
-      const lagrangian::Reader *reader = nullptr)
+      const lagrangian::Reader *reader = nullptr,
+      const bool shared_nodes = false)
       : map_(map_properties.get_nx(), map_properties.get_ny(),
              map_properties.get_x_min(), map_properties.get_y_min(),
              map_properties.get_step()),
         fle_(fle) {
     if (reader != nullptr) {
-      map_.Initialize(fle_, reader, stencil);
+      map_.Initialize(fle_, reader, stencil, shared_nodes);
     } else {
-      map_.Initialize(fle_, stencil);
+      map_.Initialize(fle_, stencil, shared_nodes);
     }
   }
 
-  void compute(const int num_threads) {
+  void compute(const int num_threads, lagrangian::Checkpoint *checkpoint) {
+    auto gil = py::gil_scoped_release();
+    map_.Compute(fle_, num_threads, checkpoint);
+  }
+
+  void restart(const std::string &filename) {
     auto gil = py::gil_scoped_release();
-    map_.Compute(fle_, num_threads);
+    map_.Restart(fle_, filename);
   }
 
   auto get_map_of_lambda1(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfLambda1(nan, fle_));
+    return get_map(
+        nan, &lagrangian::MapOfFiniteLyapunovExponents::GetMapOfLambda1);
   }
 
   auto get_map_of_lambda2(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfLambda2(nan, fle_));
+    return get_map(
+        nan, &lagrangian::MapOfFiniteLyapunovExponents::GetMapOfLambda2);
   }
 
   auto get_map_of_theta1(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfTheta1(nan, fle_));
+    return get_map(
+        nan, &lagrangian::MapOfFiniteLyapunovExponents::GetMapOfTheta1);
   }
 
   auto get_map_of_theta2(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfTheta2(nan, fle_));
+    return get_map(
+        nan, &lagrangian::MapOfFiniteLyapunovExponents::GetMapOfTheta2);
   }
 
   auto get_map_of_delta_t(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfDeltaT(nan, fle_));
+    return get_map(
+        nan, &lagrangian::MapOfFiniteLyapunovExponents::GetMapOfDeltaT);
   }
 
   auto get_map_of_final_separation(const double nan) -> py::array_t<double> {
-    return get_map(nan, map_.GetMapOfFinalSeparation(nan, fle_));
+    return get_map(nan, &lagrangian::MapOfFiniteLyapunovExponents::
+                            GetMapOfFinalSeparation);
   }
 
- private:
-  static inline auto get_map(const double fill_value,
-                             lagrangian::Map<double> *map)
-      -> py::array_t<double> {
-    auto result = py::array_t<double>(
-        py::array::ShapeContainer({map->get_nx(), map->get_ny()}));
-    auto result_ = result.mutable_unchecked<2>();
-
+  auto get_maps(
+      const std::vector<lagrangian::MapOfFiniteLyapunovExponents::Output>
+          &outputs,
+      const double nan, const int num_threads) -> py::array_t<double> {
+    auto result = py::array_t<double>(py::array::ShapeContainer(
+        {static_cast<py::ssize_t>(outputs.size()),
+         static_cast<py::ssize_t>(map_.get_nx()),
+         static_cast<py::ssize_t>(map_.get_ny())}));
+    auto *data = result.mutable_data();
+    auto size = static_cast<size_t>(result.size());
     {
       auto gil = py::gil_scoped_release();
+      map_.ComputeMaps(outputs, nan, fle_, data, num_threads);
 
-      for (auto ix = 0; ix < map->get_nx(); ++ix) {
-        for (auto iy = 0; iy < map->get_ny(); ++iy) {
-          auto value = map->GetItem(ix, iy);
-          result_(ix, iy) = std::isnan(value) ? fill_value : value;
-        }
+      if (!std::isnan(nan)) {
+        std::replace_if(
+            data, data + size,
+            [](const double value) { return std::isnan(value); }, nan);
       }
     }
     return result;
   }
+
+ private:
+  using GetMap = std::unique_ptr<lagrangian::Map<double>> (
+      lagrangian::MapOfFiniteLyapunovExponents::*)(
+      double, lagrangian::FiniteLyapunovExponentsIntegration &) const;
+
+  auto get_map(const double fill_value, const GetMap getter)
+      -> py::array_t<double> {
+    std::unique_ptr<lagrangian::Map<double>> map;
+    {
+      auto gil = py::gil_scoped_release();
+      map = (map_.*getter)(fill_value, fle_);
+
+      // The undefined exponents are also replaced by the fill value
+      if (!std::isnan(fill_value)) {
+        auto *data = map->data();
+        std::replace_if(
+            data, data + static_cast<size_t>(map->get_nx()) * map->get_ny(),
+            [](const double value) { return std::isnan(value); },
+            fill_value);
+      }
+    }
+    return to_array(std::move(map));
+  }
+};
+
+class TiledMapOfFiniteLyapunovExponents {
+ private:
+  lagrangian::TiledMapOfFiniteLyapunovExponents map_;
+  lagrangian::FiniteLyapunovExponentsIntegration fle_;
+  int ny_;
+
+ public:
+  TiledMapOfFiniteLyapunovExponents(
+      const lagrangian::MapProperties &map_properties,
+      const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+      const lagrangian::FiniteLyapunovExponentsIntegration::Stencil &stencil,
+      const lagrangian::Reader *reader = nullptr,
+      const bool shared_nodes = false)
+      : map_(map_properties, stencil, shared_nodes, reader),
+        fle_(fle),
+        ny_(map_properties.get_ny()) {}
+
+  [[nodiscard]] auto tile_size(const size_t memory_budget,
+                               const size_t outputs) const -> int {
+    return map_.GetTileSize(memory_budget, outputs);
+  }
+
+  void compute(
+      const std::vector<lagrangian::MapOfFiniteLyapunovExponents::Output>
+          &outputs,
+      const py::function &callback, const size_t memory_budget,
+      const double nan, const int num_threads) {
+    auto gil = py::gil_scoped_release();
+    map_.Compute(
+        fle_, outputs, nan, memory_budget, num_threads,
+        [&](const int ix, const int nx, const double *const maps) {
+          py::gil_scoped_acquire acquire;
+          auto result = py::array_t<double>(py::array::ShapeContainer(
+              {static_cast<py::ssize_t>(outputs.size()),
+               static_cast<py::ssize_t>(nx), static_cast<py::ssize_t>(ny_)}));
+          auto *data = result.mutable_data();
+          auto size = static_cast<size_t>(result.size());
+          std::copy(maps, maps + size, data);
+
+          // The undefined exponents are also replaced by the fill value
+          if (!std::isnan(nan)) {
+            std::replace_if(
+                data, data + size,
+                [](const double value) { return std::isnan(value); }, nan);
+          }
+          callback(ix, result);
+        });
+  }
 };
 
 class Advect : public lagrangian::map::Advect {
  public:
   using lagrangian::map::Advect::Advect;
 
+  void compute(lagrangian::Integration &integration, const int num_threads,
+               lagrangian::Checkpoint *checkpoint) {
+    auto gil = py::gil_scoped_release();
+    Compute(integration, num_threads, checkpoint);
+  }
+
+  void restart(const lagrangian::Integration &integration,
+               const std::string &filename) {
+    auto gil = py::gil_scoped_release();
+    Restart(integration, filename);
+  }
+
   auto get_map_of_x(const double fill_value) -> py::array_t<double> {
-    return get_map(fill_value, &lagrangian::Position::get_xi);
+    std::unique_ptr<lagrangian::Map<double>> map;
+    {
+      auto gil = py::gil_scoped_release();
+      map = GetMapOfX(fill_value);
+    }
+    return to_array(std::move(map));
   }
 
   auto get_map_of_y(const double fill_value) -> py::array_t<double> {
-    return get_map(fill_value, &lagrangian::Position::get_yi);
+    std::unique_ptr<lagrangian::Map<double>> map;
+    {
+      auto gil = py::gil_scoped_release();
+      map = GetMapOfY(fill_value);
+    }
+    return to_array(std::move(map));
   }
 
- private:
-  auto get_map(const double fill_value,
-               const std::function<double(const lagrangian::Position &,
-                                          size_t idx)> &getter)
-      -> py::array_t<double> {
-    auto result = py::array_t<double>(
-        py::array::ShapeContainer({map_.get_nx(), map_.get_ny()}));
-    auto result_ = result.mutable_unchecked<2>();
+  auto compute_snapshots(lagrangian::Integration &integration,
+                         const std::vector<lagrangian::DateTime> &dates,
+                         const int num_threads, const bool float32,
+                         const double fill_value,
+                         lagrangian::Checkpoint *checkpoint) -> py::tuple {
+    return float32 ? Snapshots<float>(integration, dates, num_threads,
+                                      fill_value, checkpoint)
+                   : Snapshots<double>(integration, dates, num_threads,
+                                       fill_value, checkpoint);
+  }
+
+  void stream_snapshots(lagrangian::Integration &integration,
+                        const std::vector<lagrangian::DateTime> &dates,
+                        const py::function &callback, const int num_threads,
+                        const double fill_value,
+                        lagrangian::Checkpoint *checkpoint) {
+    const auto shape = std::vector<py::ssize_t>{map_.get_nx(), map_.get_ny()};
+    const auto size = static_cast<size_t>(map_.get_nx()) * map_.get_ny();
+
+    auto gil = py::gil_scoped_release();
+    Compute(integration, num_threads, UnixTime(dates), fill_value,
+            [&](const size_t ix, const double *const x,
+                const double *const y) {
+              py::gil_scoped_acquire acquire;
+              auto x_ = py::array_t<double>(shape);
+              auto y_ = py::array_t<double>(shape);
+              std::copy(x, x + size, x_.mutable_data());
+              std::copy(y, y + size, y_.mutable_data());
+              callback(dates[ix], x_, y_);
+            },
+            checkpoint);
+  }
 
+ private:
+  // Computes the map, storing the snapshots in the matrices (dates, nx, ny)
+  // returned.
+  template <typename T>
+  auto Snapshots(lagrangian::Integration &integration,
+                 const std::vector<lagrangian::DateTime> &dates,
+                 const int num_threads, const double fill_value,
+                 lagrangian::Checkpoint *checkpoint) -> py::tuple {
+    const auto shape = std::vector<py::ssize_t>{
+        static_cast<py::ssize_t>(dates.size()), map_.get_nx(), map_.get_ny()};
+    const auto size = static_cast<size_t>(map_.get_nx()) * map_.get_ny();
+    auto x = py::array_t<T>(shape);
+    auto y = py::array_t<T>(shape);
+    auto *const x_ = x.mutable_data();
+    auto *const y_ = y.mutable_data();
+
+    // The snapshots taken before the restart point of a checkpoint are not
+    // computed again.
+    std::fill(x_, x_ + x.size(), static_cast<T>(fill_value));
+    std::fill(y_, y_ + y.size(), static_cast<T>(fill_value));
     {
       auto gil = py::gil_scoped_release();
+      Compute(integration, num_threads, UnixTime(dates), fill_value,
+              [&](const size_t ix, const double *const xi,
+                  const double *const yi) {
+                std::copy(xi, xi + size, x_ + ix * size);
+                std::copy(yi, yi + size, y_ + ix * size);
+              },
+              checkpoint);
+    }
+    return py::make_tuple(x, y);
+  }
 
-      for (auto ix = 0; ix < map_.get_nx(); ++ix) {
-        for (auto iy = 0; iy < map_.get_ny(); ++iy) {
-          auto position = map_.GetItem(ix, iy);
-          if (position->IsMissing()) {
-            result_(ix, iy) = fill_value;
-          } else {
-            result_(ix, iy) = getter(*position, 0);
-          }
-        }
-      }
+  static auto UnixTime(const std::vector<lagrangian::DateTime> &dates)
+      -> std::vector<double> {
+    auto result = std::vector<double>();
+    result.reserve(dates.size());
+    for (const auto &item : dates) {
+      result.push_back(item.ToUnixTime());
     }
     return result;
   }
@@ -183,6 +364,41 @@ Args:
           },
           "Gets the y-axis values");
 
+  py::class_<lagrangian::Checkpoint>(
+      m, "Checkpoint",
+      "Writes the checkpoints of a long computation in the background")
+      .def(py::init<std::string, size_t>(), py::arg("filename"),
+           py::arg("interval") = 0, R"__doc__(
+Default constructor
+
+The state of the computation is copied in memory at the end of a time step,
+then written to disk by a separate thread while the computation goes on. The
+file is replaced only once the new checkpoint is complete.
+
+Args:
+     filename (str): Path to the checkpoint file
+     interval (int, optional): Number of time steps between two checkpoints.
+          If 0, the checkpoints are only written on request. Defaults to 0.
+)__doc__")
+      .def_property_readonly("filename",
+                             &lagrangian::Checkpoint::get_filename,
+                             "Path to the checkpoint file")
+      .def_property_readonly("interval",
+                             &lagrangian::Checkpoint::get_interval,
+                             "Number of time steps between two checkpoints")
+      .def("request", &lagrangian::Checkpoint::Request, R"__doc__(
+Request a checkpoint at the end of the current time step. This method can be
+called from any thread during the computation (e.g. when the job is about to
+be preempted).
+)__doc__")
+      .def("wait", &lagrangian::Checkpoint::Wait,
+           py::call_guard<py::gil_scoped_release>(), R"__doc__(
+Wait until the pending checkpoint is written.
+
+Raises:
+     RuntimeError: if the checkpoint could not be written
+)__doc__");
+
   py::class_<Advect>(m, "Advect", "Advection of grid points")
       .def(py::init<int, int, double, double, double>(), py::arg("nx"),
            py::arg("ny"), py::arg("x_min"), py::arg("y_min"), py::arg("step"),
@@ -206,9 +422,11 @@ Args:
           mask's value. If no reader is defined, all gris points are used
           during the calculation
 )__doc__")
-      .def("compute", &Advect::Compute, py::arg("integration"),
-           py::arg("num_threads") = 0, R"__doc__(
-Compute the map
+      .def("compute", &Advect::compute, py::arg("integration"),
+           py::arg("num_threads") = 0, py::arg("checkpoint") = nullptr,
+           R"__doc__(
+Compute the map. If the state of the particles was restored by
+:py:meth:`restart`, the computation resumes where the checkpoint was written.
 
 Args:
      integration (lagrangian.core.Integration): Integration properties
@@ -216,6 +434,27 @@ Args:
           computation. If 0 all CPUs are used. If 1 is given, no parallel
           computing code is used at all, which is useful for debugging.
           Defaults to 0.
+     checkpoint (lagrangian.core.Checkpoint, optional): If defined, the
+          checkpoints of the computation are written in the background.
+
+Raises:
+     RuntimeError: if a checkpoint cannot be written
+)__doc__")
+      .def("restart", &Advect::restart, py::arg("integration"),
+           py::arg("filename"), R"__doc__(
+Restore the state of the particles from a checkpoint, instead of initializing
+them. The next computation resumes where the checkpoint was written.
+
+Args:
+     integration (lagrangian.core.Integration): Integration properties,
+          defining the same integration as the one that wrote the checkpoint.
+          The end of the integration may differ.
+     filename (str): Path to the checkpoint
+
+Raises:
+     RuntimeError: if the file is not a valid checkpoint
+     ValueError: if the checkpoint was written for another map or another
+          integration
 )__doc__")
       .def("map_of_x", &Advect::get_map_of_x,
            py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
@@ -238,19 +477,106 @@ Args:
 
 Returns:
      numpy.ndarray: The map Y coordinates at the end of the integration
+)__doc__")
+      .def("compute", &Advect::compute_snapshots, py::arg("integration"),
+           py::arg("dates"), py::arg("num_threads") = 0,
+           py::arg("float32") = false,
+           py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
+           py::arg("checkpoint") = nullptr, R"__doc__(
+Compute the map, taking snapshots of the positions of the particles at
+intermediate dates in the same pass.
+
+The positions at a date of the integration are those of the particles before
+the time step starting at this date. The last date available is the date
+reached after the last time step, the date of the maps returned by
+:py:meth:`map_of_x` and :py:meth:`map_of_y`.
+
+Args:
+     integration (lagrangian.core.Integration): Integration properties
+     dates (list): Dates of the snapshots (datetime.datetime), which must be
+          dates of the integration
+     num_threads (int, optional): The number of threads to use for the
+          computation. If 0 all CPUs are used. If 1 is given, no parallel
+          computing code is used at all, which is useful for debugging.
+          Defaults to 0.
+     float32 (bool, optional): True to store the positions in single
+          precision. Defaults to False.
+     fill_value (float): value used for missing cells
+     checkpoint (lagrangian.core.Checkpoint, optional): If defined, the
+          checkpoints of the computation are written in the background. When
+          the computation resumes from a checkpoint, the snapshots of the
+          dates already computed are not taken and their positions are set
+          to the fill value.
+
+Returns:
+     tuple: The longitudes and latitudes of the particles at the dates
+     requested, of shape (dates, nx, ny)
+
+Raises:
+     ValueError: if a date is not a date of the integration
+)__doc__")
+      .def("compute", &Advect::stream_snapshots, py::arg("integration"),
+           py::arg("dates"), py::arg("callback"), py::arg("num_threads") = 0,
+           py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
+           py::arg("checkpoint") = nullptr, R"__doc__(
+Compute the map, handing out the snapshots of the positions of the particles
+to a function as soon as they are taken instead of keeping them in memory
+(e.g. to write them to disk during a long integration).
+
+Args:
+     integration (lagrangian.core.Integration): Integration properties
+     dates (list): Dates of the snapshots (datetime.datetime), which must be
+          dates of the integration
+     callback (callable): Function called with the date of a snapshot and the
+          maps of the longitudes and latitudes of the particles at this date,
+          of shape (nx, ny). The snapshots are handed out in chronological
+          order of the integration.
+     num_threads (int, optional): The number of threads to use for the
+          computation. If 0 all CPUs are used. If 1 is given, no parallel
+          computing code is used at all, which is useful for debugging.
+          Defaults to 0.
+     fill_value (float): value used for missing cells
+     checkpoint (lagrangian.core.Checkpoint, optional): If defined, the
+          checkpoints of the computation are written in the background. When
+          the computation resumes from a checkpoint, the snapshots of the
+          dates already computed are not taken.
+
+Raises:
+     ValueError: if a date is not a date of the integration
 )__doc__");
 
+  py::enum_<lagrangian::MapOfFiniteLyapunovExponents::Output>(
+      m, "MapOutput", "Maps computed by a map of Finite Lyapunov Exponents")
+      .value("LAMBDA1", lagrangian::MapOfFiniteLyapunovExponents::kLambda1,
+             "FLE associated to the maximum eigenvalues of Cauchy-Green "
+             "strain tensor")
+      .value("LAMBDA2", lagrangian::MapOfFiniteLyapunovExponents::kLambda2,
+             "FLE associated to the minimum eigenvalues of Cauchy-Green "
+             "strain tensor")
+      .value("THETA1", lagrangian::MapOfFiniteLyapunovExponents::kTheta1,
+             "Orientation of the eigenvectors associated to the maximum "
+             "eigenvalues of Cauchy-Green strain tensor")
+      .value("THETA2", lagrangian::MapOfFiniteLyapunovExponents::kTheta2,
+             "Orientation of the eigenvectors associated to the minimum "
+             "eigenvalues of Cauchy-Green strain tensor")
+      .value("DELTA_T", lagrangian::MapOfFiniteLyapunovExponents::kDeltaT,
+             "Advection time")
+      .value("FINAL_SEPARATION",
+             lagrangian::MapOfFiniteLyapunovExponents::kFinalSeparation,
+             "Effective final separation distance");
+
   py::class_<MapOfFiniteLyapunovExponents>(
       m, "MapOfFiniteLyapunovExponents",
       "Handles a map of Finite Size or Time Lyapunov Exponents")
       .def(py::init<lagrangian::MapProperties,
                     lagrangian::FiniteLyapunovExponentsIntegration,
                     lagrangian::FiniteLyapunovExponentsIntegration::Stencil,
-                    lagrangian::Reader *>(),
+                    lagrangian::Reader *, bool>(),
            py::arg("map_properties"), py::arg("fle"),
            py::arg("stencil") =
                lagrangian::FiniteLyapunovExponentsIntegration::kTriplet,
-           py::arg("reader") = nullptr, R"__doc__(
+           py::arg("reader") = nullptr, py::arg("shared_nodes") = false,
+           R"__doc__(
 Default constructor
 
 Args:
@@ -264,18 +590,45 @@ Args:
           into account during the calculation process, in order to accelerate
           it. If this parameter is not defined, all cells will be processed in
           the calculation step.
+     shared_nodes (bool): If true, the nodes of the grid are advected only
+          once and the stencil of a cell is made of its neighbouring nodes.
+          The cells located on the edges of the grid, or next to a hidden
+          cell, keep their own stencil. Requires an initial separation of
+          the stencils equal to the step of the grid.
 )__doc__",
            py::keep_alive<1, 5>())
       .def("compute", &MapOfFiniteLyapunovExponents::compute, R"__doc__(
-Compute the map
+Compute the map. If the state of the cells was restored by
+:py:meth:`restart`, the computation resumes where the checkpoint was written.
 
 Args:
      num_threads (int, optional): The number of threads to use for the
           computation. If 0 all CPUs are used. If 1 is given, no parallel
           computing code is used at all, which is useful for debugging.
           Defaults to 0.
+     checkpoint (lagrangian.core.Checkpoint, optional): If defined, the
+          checkpoints of the computation are written in the background.
+
+Raises:
+     RuntimeError: if a checkpoint cannot be written
 )__doc__",
-           py::arg("num_threads") = 0)
+           py::arg("num_threads") = 0, py::arg("checkpoint") = nullptr)
+      .def("restart", &MapOfFiniteLyapunovExponents::restart,
+           py::arg("filename"), R"__doc__(
+Restore the state of the cells from a checkpoint written by
+:py:meth:`compute`, instead of the initial state. The next computation
+resumes where the checkpoint was written.
+
+Args:
+     filename (str): Path to the checkpoint, written for the same map,
+          integration and stencil. The end of the integration may differ.
+
+Raises:
+     RuntimeError: if the file is not a valid checkpoint
+     ValueError: if the checkpoint was written for another map, another
+          integration (e.g. another mode or other separations) or another
+          stencil
+)__doc__")
       .def("map_of_lambda1", &MapOfFiniteLyapunovExponents::get_map_of_lambda1,
            py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
            R"__doc__(
@@ -347,5 +700,91 @@ Args:
 
 Returns:
      The map of the effective final separation distance (unit degree)
+)__doc__")
+      .def("maps", &MapOfFiniteLyapunovExponents::get_maps, py::arg("outputs"),
+           py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
+           py::arg("num_threads") = 0, R"__doc__(
+Get several maps computed in a single pass over the grid
+
+Args:
+     outputs (list): Maps to compute (lagrangian.core.MapOutput)
+     fill_value (float): value used for missing cells
+     num_threads (int, optional): The number of threads to use for the
+          computation. If 0 all CPUs are used. If 1 is given, no parallel
+          computing code is used at all, which is useful for debugging.
+          Defaults to 0.
+
+Returns:
+     numpy.ndarray: The maps requested, stacked along the first axis
+)__doc__");
+
+  py::class_<TiledMapOfFiniteLyapunovExponents>(
+      m, "TiledMapOfFiniteLyapunovExponents",
+      "Computes a map of Finite Size or Time Lyapunov Exponents by tiles, in "
+      "bounded memory")
+      .def(py::init<lagrangian::MapProperties,
+                    lagrangian::FiniteLyapunovExponentsIntegration,
+                    lagrangian::FiniteLyapunovExponentsIntegration::Stencil,
+                    lagrangian::Reader *, bool>(),
+           py::arg("map_properties"), py::arg("fle"),
+           py::arg("stencil") =
+               lagrangian::FiniteLyapunovExponentsIntegration::kTriplet,
+           py::arg("reader") = nullptr, py::arg("shared_nodes") = false,
+           R"__doc__(
+Default constructor
+
+The map is split into bands of longitudes sized to a memory budget. The bands
+are computed one after the other, with the same velocity field, and the maps
+of a band are handed out before the next band starts: the memory used by the
+cells depends on the size of the bands, not on the size of the map. The grids
+of the field are read once and kept in memory until the last band is
+computed.
+
+Args:
+     map_properties (lagrangian.core.MapProperties): Properties of the regular
+          grid to compute
+     fle (lagrangian.core.FiniteLyapunovExponents): FLE handler
+     stencil (lagrangian.core.Stencil): Type of stencil used for the
+          calculation of finite difference.
+     reader (lagrangian.core.reader.NetCDF): NetCDF used to locate the hidden
+          values (eg continents), which are not computed.
+     shared_nodes (bool): If true, the nodes of each band are advected only
+          once and the stencil of a cell is made of its neighbouring nodes.
+)__doc__",
+           py::keep_alive<1, 5>())
+      .def("tile_size", &TiledMapOfFiniteLyapunovExponents::tile_size,
+           py::arg("memory_budget"), py::arg("outputs"), R"__doc__(
+Get the number of longitudes of the bands fitting into a memory budget
+
+Args:
+     memory_budget (int): Memory budget in bytes
+     outputs (int): Number of maps computed
+
+Returns:
+     int: The number of longitudes of a band
+
+Raises:
+     ValueError: if the budget is too small to compute a single longitude
+)__doc__")
+      .def("compute", &TiledMapOfFiniteLyapunovExponents::compute,
+           py::arg("outputs"), py::arg("callback"), py::arg("memory_budget"),
+           py::arg("fill_value") = std::numeric_limits<double>::quiet_NaN(),
+           py::arg("num_threads") = 0, R"__doc__(
+Compute the map, band by band
+
+Args:
+     outputs (list): Maps to compute (lagrangian.core.MapOutput)
+     callback (callable): Function called with the index of the first
+          longitude of a band and its maps, stacked along the first axis, of
+          shape (len(outputs), number of longitudes of the band, ny).
+     memory_budget (int): Memory budget in bytes
+     fill_value (float): value used for missing cells
+     num_threads (int, optional): The number of threads to use for the
+          computation. If 0 all CPUs are used. If 1 is given, no parallel
+          computing code is used at all, which is useful for debugging.
+          Defaults to 0.
+
+Raises:
+     ValueError: if the budget is too small to compute a single longitude
 )__doc__");
 }
@@ -12,11 +12,13 @@
 //
 // You should have received a copy of GNU Lesser General Public License
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "datetime.hpp"
 #include "lagrangian/reader/factory.hpp"
+#include "vectorize.hpp"
 
 namespace py = pybind11;
 
@@ -78,7 +80,16 @@ void init_reader(pybind11::module &m) {
   py::module reader = m.def_submodule("reader");
   py::enum_<lagrangian::reader::Factory::Type>(reader, "Type",
                                                "Type of fields reader known")
-      .value("NETCDF", lagrangian::reader::Factory::kNetCDF, "netCDF");
+      .value("NETCDF", lagrangian::reader::Factory::kNetCDF, "netCDF")
+      .value("BINARY", lagrangian::reader::Factory::kBinary,
+             "Native binary grids");
+
+  py::enum_<lagrangian::Grid::Storage>(
+      reader, "Storage", "Type used to store the grids loaded into memory")
+      .value("FLOAT64", lagrangian::Grid::kFloat64, "Double precision")
+      .value("FLOAT32", lagrangian::Grid::kFloat32, "Single precision")
+      .value("INT16", lagrangian::Grid::kInt16,
+             "16-bit integers with scale factor and offset");
 
   py::class_<lagrangian::CellProperties>(
       m, "CellProperties",
@@ -125,7 +136,14 @@ axes of the longitudes and latitudes of the variable. For example :
   The variable to be read must set an attribute named "date" that
   define the date of data contained in the variable.
 )__doc__")
-      .def(py::init<>(), "Default constructor")
+      .def(py::init<lagrangian::Grid::Storage>(),
+           py::arg("storage") = lagrangian::Grid::kFloat64, R"__doc__(
+Default constructor
+
+Args:
+  storage (lagrangian.reader.Storage): Type used to store the grids loaded
+    into memory.
+)__doc__")
       .def("open", &lagrangian::reader::NetCDF::Open, py::arg("path"),
            R"__doc__(Opens a NetCDF grid in read-only.
 
@@ -135,6 +153,18 @@ Args:
 Raises:
   RuntimeError: If the function can not find the definition of
     longitudes or latitudes in the file.
+)__doc__")
+      .def("set_bounding_box", &lagrangian::reader::NetCDF::SetBoundingBox,
+           py::arg("x_min"), py::arg("x_max"), py::arg("y_min"),
+           py::arg("y_max"), R"__doc__(
+Restricts the grids read by the next calls to open to a region. The points
+located outside this region are considered outside the grid.
+
+Args:
+  x_min (float): Minimum longitude in degrees
+  x_max (float): Maximum longitude in degrees
+  y_min (float): Minimum latitude in degrees
+  y_max (float): Maximum latitude in degrees
 )__doc__")
       .def("load", &lagrangian::reader::NetCDF::Load, py::arg("name"),
            py::arg("unit") = "", R"__doc__(
@@ -162,6 +192,73 @@ Args:
 Returns:
   float: Interpolated value or ``nan`` if point is outside the grid or
     undefined.
+)__doc__")
+      .def(
+          "interpolate",
+          [](const lagrangian::reader::NetCDF &self,
+             const vectorize::Array &lon, const vectorize::Array &lat,
+             const double fill_value, const int num_threads) -> py::tuple {
+            vectorize::CheckShape(lon, lat);
+            auto values = vectorize::Empty<double>(lon);
+            auto mask = vectorize::Empty<bool>(lon);
+            const auto *const x = lon.data();
+            const auto *const y = lat.data();
+            auto *const z = values.mutable_data();
+            auto *const defined = mask.mutable_data();
+
+            vectorize::ParallelFor(
+                lon.size(), num_threads,
+                [&](const size_t first, const size_t last,
+                    lagrangian::CellProperties &cell) {
+                  self.InterpolateMany(last - first, x + first, y + first,
+                                       fill_value, z + first, cell);
+                  vectorize::Mask(first, last, z, defined);
+                });
+            return py::make_tuple(values, mask);
+          },
+          py::arg("lon"), py::arg("lat"), py::arg("fill_value") = 0,
+          py::arg("num_threads") = 0, R"__doc__(
+Computes the values of a set of points by bilinear interpolation. The points
+are processed in parallel, without holding the GIL.
+
+Args:
+  longitude (numpy.ndarray): Longitudes in degrees
+  latitude (numpy.ndarray): Latitudes in degrees, with the shape of the
+    longitudes
+  fill_value (float): Value to be taken into account for fill values
+  num_threads (int): Number of threads used, all the CPUs if 0.
+
+Returns:
+  tuple: Interpolated values, ``nan`` if the point is outside the grid or
+    undefined, and the mask of the values defined.
+
+Raises:
+  ValueError: if the longitudes and latitudes have different shapes.
+)__doc__")
+      .def(
+          "interpolate_vector",
+          [](const lagrangian::reader::NetCDF &self, const double lon,
+             const double lat, const double fill_value,
+             lagrangian::CellProperties &cell) -> py::tuple {
+            double u;
+            double v;
+            self.InterpolateVector(lon, lat, fill_value, u, v, cell);
+            return py::make_tuple(u, v);
+          },
+          py::arg("lon"), py::arg("lat"), py::arg("fill_value") = 0,
+          py::arg("cell") = lagrangian::CellProperties::NONE(), R"__doc__(
+Computes the two components of the vector field loaded by
+:py:meth:`load_vector` by bilinear interpolation
+
+Args:
+  longitude (float): Longitude in degrees
+  latitude (float): Latitude in degrees
+  fill_value (float): Value to be taken into account for fill values
+  cell (lagrangian.CellProperties) Properties of the grid used for the
+    interpolation.
+
+Returns:
+  tuple: Interpolated components
 )__doc__")
       .def("date", &lagrangian::reader::NetCDF::GetDateTime, py::arg("name"),
            R"__doc__(
@@ -172,5 +269,50 @@ Args:
 
 Returns:
   datetime.datetime: The date of the grid
+)__doc__")
+      .def("load_vector", &lagrangian::reader::NetCDF::LoadVector,
+           py::arg("u_name"), py::arg("v_name"), py::arg("unit") = "",
+           R"__doc__(
+Load into memory the two components of a vector field
+
+Args:
+  u_name (str): name of the NetCDF grid who contains the first component
+  v_name (str): name of the NetCDF grid who contains the second component
+  unit (str): Unit of data loaded into memory. If the parameter is
+      undefined or contains an empty string, the object will not do unit
+      conversion.
+)__doc__");
+
+  py::class_<lagrangian::reader::Binary, lagrangian::reader::NetCDF>(
+      reader, "Binary", R"__doc__(Native binary grid reader.
+
+A binary grid is a NetCDF grid preprocessed by :py:meth:`convert`: the
+components of the velocity are stored interleaved, in double precision,
+already converted into the unit wanted. The file is mapped into memory,
+loading a grid does not copy or decode its values.
+)__doc__")
+      .def(py::init<lagrangian::Grid::Storage>(),
+           py::arg("storage") = lagrangian::Grid::kFloat64, R"__doc__(
+Default constructor
+
+Args:
+  storage (lagrangian.reader.Storage): Type used to store the grids loaded
+    into memory. The grids are mapped without copy only if they are stored
+    in double precision.
+)__doc__")
+      .def_static("convert", &lagrangian::reader::Binary::Convert,
+                  py::arg("source"), py::arg("u_name"), py::arg("v_name"),
+                  py::arg("unit"), py::arg("target"), R"__doc__(
+Converts a NetCDF grid into a binary grid
+
+Args:
+  source (str): Path to the NetCDF grid
+  u_name (str): name of the NetCDF variable who contains the first
+    component
+  v_name (str): name of the NetCDF variable who contains the second
+    component, or an empty string to convert a scalar grid.
+  unit (str): Unit of the data stored. If the parameter contains an empty
+    string, the data are stored in the unit of the NetCDF file.
+  target (str): Path to the binary grid to create
 )__doc__");
 }
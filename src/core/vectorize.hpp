@@ -0,0 +1,120 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "datetime.hpp"
+#include "lagrangian/reader.hpp"
+#include "lagrangian/thread_pool.hpp"
+
+/// Helpers of the functions processing NumPy arrays of points
+namespace vectorize {
+
+/// C-contiguous array of doubles, the arrays of another type being converted
+using Array =
+    pybind11::array_t<double, pybind11::array::c_style |
+                                  pybind11::array::forcecast>;
+
+/// Number of points handed out at once to a thread
+constexpr size_t kGrain = 4096;
+
+/// Check that the arrays of coordinates have the same shape
+///
+/// @throw std::invalid_argument if the shapes differ.
+inline void CheckShape(const Array &x, const Array &y) {
+  if (x.ndim() != y.ndim() ||
+      !std::equal(x.shape(), x.shape() + x.ndim(), y.shape())) {
+    throw std::invalid_argument(
+        "the arrays of coordinates must have the same shape");
+  }
+}
+
+/// Create an uninitialized array with the shape of another one
+template <typename T>
+inline auto Empty(const Array &like) -> pybind11::array_t<T> {
+  return pybind11::array_t<T>(
+      std::vector<pybind11::ssize_t>(like.shape(), like.shape() + like.ndim()));
+}
+
+/// Convert the dates t, a datetime.datetime or an array of dates with the
+/// shape of like (e.g. numpy.datetime64), into numbers of seconds elapsed
+/// since 1970. A single date gives an array of one item.
+///
+/// @throw std::invalid_argument if the shape of the array of dates differs
+/// from the shape of the coordinates.
+inline auto UnixTime(const pybind11::handle &t, const Array &like) -> Array {
+  pybind11::detail::make_caster<lagrangian::DateTime> caster;
+  if (caster.load(t, false)) {
+    auto result = Array(1);
+    *result.mutable_data() =
+        static_cast<lagrangian::DateTime &>(caster).ToUnixTime();
+    return result;
+  }
+  auto microseconds = pybind11::module_::import("numpy")
+                          .attr("asarray")(t, "datetime64[us]")
+                          .attr("astype")("int64");
+  auto result = Array(microseconds.attr("__mul__")(1e-6));
+  if (result.ndim() != like.ndim() ||
+      !std::equal(like.shape(), like.shape() + like.ndim(), result.shape())) {
+    throw std::invalid_argument(
+        "the array of dates must have the shape of the coordinates");
+  }
+  return result;
+}
+
+/// Process the points [0, size) by chunks, on num_threads threads (all CPUs
+/// if 0), with the GIL released. The function is called with the range of
+/// points [first, last) to process and the cell properties of the calling
+/// thread.
+template <typename Function>
+inline void ParallelFor(const size_t size, const int num_threads,
+                        const Function &function) {
+  pybind11::gil_scoped_release release;
+  lagrangian::ThreadPool pool(size > kGrain ? num_threads : 1);
+  std::vector<lagrangian::CellProperties> cells(pool.size());
+
+  pool.ParallelFor(
+      size,
+      [&](const size_t first, const size_t last, const size_t worker) {
+        function(first, last, cells[worker]);
+      },
+      kGrain);
+}
+
+/// Set the items [first, last) of the validity mask: true if the value a is
+/// defined.
+inline void Mask(const size_t first, const size_t last, const double *a,
+                 bool *mask) {
+  for (size_t ix = first; ix < last; ++ix) {
+    mask[ix] = !std::isnan(a[ix]);
+  }
+}
+
+/// Set the items [first, last) of the validity mask: true if the values a
+/// and b are defined.
+inline void Mask(const size_t first, const size_t last, const double *a,
+                 const double *b, bool *mask) {
+  for (size_t ix = first; ix < last; ++ix) {
+    mask[ix] = !std::isnan(a[ix]) && !std::isnan(b[ix]);
+  }
+}
+
+}  // namespace vectorize
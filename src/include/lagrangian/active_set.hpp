@@ -0,0 +1,207 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/checkpoint.hpp"
+#include "lagrangian/thread_pool.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Set of the cells of a grid still being integrated
+ *
+ * The cells are identified by their linear index in the grid and stored in a
+ * contiguous array. Any range [first, last) of the set can therefore be
+ * handed out to a thread without walking the set, and the cells whose
+ * integration is over are removed in parallel by stream compaction: each
+ * block of the array counts its remaining cells, the offsets of the blocks
+ * are obtained by a prefix sum and then the blocks are copied to their new
+ * location. The order of the remaining cells is preserved.
+ */
+class ActiveSet {
+ public:
+  /**
+   * @brief Default constructor
+   */
+  ActiveSet() = default;
+
+  /**
+   * Move constructor
+   *
+   * @param rhs right value
+   */
+  ActiveSet(ActiveSet &&rhs) = default;
+
+  /**
+   * Move assignment operator
+   *
+   * @param rhs right value
+   */
+  auto operator=(ActiveSet &&rhs) -> ActiveSet & = default;
+
+  /**
+   * @brief Get the number of cells in the set
+   *
+   * @return The number of cells
+   */
+  [[nodiscard]] inline auto size() const -> size_t { return items_.size(); }
+
+  /**
+   * @brief Test if the set is empty
+   *
+   * @return True if the set contains no cell
+   */
+  [[nodiscard]] inline auto empty() const -> bool { return items_.empty(); }
+
+  /**
+   * @brief Get the index of the cell \#ix of the set
+   *
+   * @param ix Position of the cell in the set
+   * @return The index of the cell in the grid
+   */
+  [[nodiscard]] inline auto operator[](const size_t ix) const -> size_t {
+    return items_[ix];
+  }
+
+  /**
+   * @brief Get the indexes of the cells of the set
+   *
+   * @return A pointer to the first index
+   */
+  [[nodiscard]] inline auto data() const -> const size_t * {
+    return items_.data();
+  }
+
+  /**
+   * @brief Remove all the cells of the set
+   */
+  inline void clear() { items_.clear(); }
+
+  /**
+   * @brief Reserve the memory needed to store a number of cells
+   *
+   * @param size Number of cells
+   */
+  inline void reserve(const size_t size) { items_.reserve(size); }
+
+  /**
+   * @brief Add a cell to the set
+   *
+   * @param index %Index of the cell in the grid
+   */
+  inline void push_back(const size_t index) { items_.push_back(index); }
+
+  /**
+   * @brief Write the cells of the set into an archive
+   *
+   * @param archive Archive receiving the cells
+   */
+  inline void Write(Archive &archive) const { archive.Write(items_); }
+
+  /**
+   * @brief Read the cells of the set written into an archive by Write
+   *
+   * @param archive Archive containing the cells
+   *
+   * @throw std::runtime_error if the archive is truncated or corrupted
+   */
+  inline void Read(Archive &archive) { archive.Read(items_); }
+
+  /**
+   * @brief Removes from the set the cells for which the predicate returns
+   * true
+   *
+   * @param predicate Function returning true if a cell (identified by its
+   * index in the grid) must be removed. The function is called concurrently
+   * and twice for each cell: it must return the same value for both calls.
+   * @param pool Threads sharing the processing
+   */
+  template <typename Predicate>
+  void Erase(Predicate predicate, ThreadPool &pool);
+
+ private:
+  /// Number of cells of the blocks processed independently during the
+  /// compaction
+  static const size_t kBlockSize = 4096;
+
+  /// Indexes of the cells
+  std::vector<size_t> items_;
+
+  /// Buffer receiving the remaining cells during the compaction
+  std::vector<size_t> buffer_;
+
+  /// Number of remaining cells, then offset in the buffer, of each block
+  std::vector<size_t> offsets_;
+};
+
+// ___________________________________________________________________________//
+
+template <typename Predicate>
+void ActiveSet::Erase(Predicate predicate, ThreadPool &pool) {
+  const auto size = items_.size();
+  const auto blocks = (size + kBlockSize - 1) / kBlockSize;
+
+  offsets_.assign(blocks + 1, 0);
+
+  // Counting the remaining cells of each block
+  pool.ParallelFor(blocks, [&](size_t first, const size_t last, size_t) {
+    for (; first < last; ++first) {
+      const auto end = std::min(size, (first + 1) * kBlockSize);
+      size_t count = 0;
+      for (auto ix = first * kBlockSize; ix < end; ++ix) {
+        count += predicate(items_[ix]) ? 0 : 1;
+      }
+      offsets_[first + 1] = count;
+    }
+  });
+
+  // Exclusive prefix sum giving the location of each block in the buffer
+  for (size_t ix = 0; ix < blocks; ++ix) {
+    offsets_[ix + 1] += offsets_[ix];
+  }
+
+  // Nothing to remove
+  if (offsets_[blocks] == size) {
+    return;
+  }
+
+  buffer_.resize(offsets_[blocks]);
+
+  pool.ParallelFor(blocks, [&](size_t first, const size_t last, size_t) {
+    for (; first < last; ++first) {
+      const auto end = std::min(size, (first + 1) * kBlockSize);
+      auto jx = offsets_[first];
+      for (auto ix = first * kBlockSize; ix < end; ++ix) {
+        if (!predicate(items_[ix])) {
+          buffer_[jx++] = items_[ix];
+        }
+      }
+    }
+  });
+
+  items_.swap(buffer_);
+}
+
+}  // namespace lagrangian
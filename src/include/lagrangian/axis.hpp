@@ -161,6 +161,20 @@ class Axis {
     ComputeProperties();
   }
 
+  /**
+   * Copy constructor
+   *
+   * @param rhs right value
+   */
+  Axis(const Axis &rhs) = default;
+
+  /**
+   * Copy assignment operator
+   *
+   * @param rhs right value
+   */
+  auto operator=(const Axis &rhs) -> Axis & = default;
+
   /**
    * Move constructor
    *
@@ -230,6 +244,15 @@ class Axis {
     return is_regular_;
   }
 
+  /**
+   * @brief The axis is a longitude axis covering the whole circle
+   *
+   * @return true if the last value of the axis is followed by the first one
+   */
+  [[nodiscard]] inline auto is_circle() const noexcept -> bool {
+    return is_circle_;
+  }
+
   /**
    * @brief Given a coordinate position, find what grid element contains it.
    * This mean that
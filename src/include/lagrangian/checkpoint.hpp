@@ -0,0 +1,266 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Binary image of the state of a computation
+ *
+ * The values are appended to a buffer in memory in the order they are
+ * written, then read back in the same order. Only the trivially copyable
+ * values, and the vectors of such values, are handled: the image is bound
+ * to the byte order and the word size of the machine that wrote it.
+ */
+class Archive {
+ public:
+  /**
+   * @brief Default constructor
+   */
+  Archive() = default;
+
+  /**
+   * Move constructor
+   *
+   * @param rhs right value
+   */
+  Archive(Archive &&rhs) = default;
+
+  /**
+   * Move assignment operator
+   *
+   * @param rhs right value
+   */
+  auto operator=(Archive &&rhs) -> Archive & = default;
+
+  /**
+   * @brief Append a value to the archive
+   *
+   * @param value Value to write
+   */
+  template <typename T>
+  inline void Write(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only the trivially copyable values can be archived");
+    Put(&value, sizeof(T));
+  }
+
+  /**
+   * @brief Append a vector of values to the archive
+   *
+   * @param values Values to write
+   */
+  template <typename T>
+  inline void Write(const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only the trivially copyable values can be archived");
+    Write(values.size());
+    Put(values.data(), values.size() * sizeof(T));
+  }
+
+  /**
+   * @brief Read the next value of the archive
+   *
+   * @param value Value read
+   *
+   * @throw std::runtime_error if the archive is exhausted
+   */
+  template <typename T>
+  inline void Read(T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only the trivially copyable values can be archived");
+    Get(&value, sizeof(T));
+  }
+
+  /**
+   * @brief Read the next vector of values of the archive
+   *
+   * @param values Values read
+   *
+   * @throw std::runtime_error if the archive is exhausted
+   */
+  template <typename T>
+  inline void Read(std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only the trivially copyable values can be archived");
+    size_t size;
+    Read(size);
+    if (size > (buffer_.size() - position_) / sizeof(T)) {
+      throw std::runtime_error("truncated or corrupted checkpoint");
+    }
+    values.resize(size);
+    Get(values.data(), size * sizeof(T));
+  }
+
+  /**
+   * @brief Write the archive to a file. The archive is first written to a
+   * temporary file and synchronized to the disk, then this file replaces the
+   * target: an interrupted write leaves the previous file intact.
+   *
+   * @param filename Path to the file
+   *
+   * @throw std::runtime_error if the file cannot be written
+   */
+  void Save(const std::string &filename) const;
+
+  /**
+   * @brief Read an archive written by Save
+   *
+   * @param filename Path to the file
+   *
+   * @return The archive, ready to be read
+   *
+   * @throw std::runtime_error if the file is not a valid archive
+   */
+  static auto Load(const std::string &filename) -> Archive;
+
+ private:
+  /// Values archived
+  std::vector<char> buffer_;
+
+  /// Position of the next value to read
+  size_t position_{0};
+
+  // Append size bytes to the buffer
+  inline void Put(const void *data, const size_t size) {
+    auto offset = buffer_.size();
+    buffer_.resize(offset + size);
+    if (size != 0) {
+      std::memcpy(buffer_.data() + offset, data, size);
+    }
+  }
+
+  // Read the next size bytes of the buffer
+  inline void Get(void *data, const size_t size) {
+    if (size > buffer_.size() - position_) {
+      throw std::runtime_error("truncated or corrupted checkpoint");
+    }
+    if (size != 0) {
+      std::memcpy(data, buffer_.data() + position_, size);
+    }
+    position_ += size;
+  }
+};
+
+// ___________________________________________________________________________//
+
+/**
+ * @brief Writes the checkpoints of a long computation in the background
+ *
+ * The state of the computation is copied into an Archive by the computing
+ * thread, which is as fast as a copy in memory, then written to disk by a
+ * separate thread while the computation goes on. A single write is pending
+ * at a time: a new checkpoint waits until the previous one is written.
+ *
+ * The checkpoints are written every N time steps, or on request: the method
+ * Request can be called from any thread (e.g. when the job is about to be
+ * preempted), and the checkpoint is written at the end of the current time
+ * step.
+ */
+class Checkpoint {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param filename Path to the checkpoint file
+   * @param interval Number of time steps between two checkpoints. If 0, the
+   * checkpoints are only written on request.
+   */
+  explicit Checkpoint(std::string filename, const size_t interval = 0)
+      : filename_(std::move(filename)), interval_(interval) {}
+
+  /**
+   * @brief Waits for the pending write before destroying the instance.
+   */
+  ~Checkpoint();
+
+  Checkpoint(const Checkpoint &) = delete;
+  auto operator=(const Checkpoint &) -> Checkpoint & = delete;
+
+  /**
+   * @brief Get the path to the checkpoint file
+   *
+   * @return The path to the file
+   */
+  [[nodiscard]] inline auto get_filename() const -> const std::string & {
+    return filename_;
+  }
+
+  /**
+   * @brief Get the number of time steps between two checkpoints
+   *
+   * @return The number of time steps, 0 if the checkpoints are only written
+   * on request
+   */
+  [[nodiscard]] inline auto get_interval() const -> size_t {
+    return interval_;
+  }
+
+  /**
+   * @brief Request a checkpoint at the end of the current time step. This
+   * method can be called from any thread.
+   */
+  inline void Request() noexcept { requested_ = true; }
+
+  /**
+   * @brief Test if a checkpoint must be written once a number of time steps
+   * have been computed. A pending request is cleared.
+   *
+   * @param steps Number of time steps computed
+   *
+   * @return True if the checkpoint is due
+   */
+  inline auto IsDue(const size_t steps) -> bool {
+    auto requested = requested_.exchange(false);
+    return requested || (interval_ != 0 && steps % interval_ == 0);
+  }
+
+  /**
+   * @brief Write a checkpoint in the background
+   *
+   * @param archive State of the computation
+   *
+   * @throw std::runtime_error if the previous checkpoint could not be written
+   */
+  void Write(Archive &&archive);
+
+  /**
+   * @brief Wait until the pending checkpoint is written
+   *
+   * @throw std::runtime_error if the checkpoint could not be written
+   */
+  void Wait();
+
+ private:
+  std::string filename_;
+  size_t interval_;
+  std::atomic<bool> requested_{false};
+  std::future<void> pending_;
+};
+
+}  // namespace lagrangian
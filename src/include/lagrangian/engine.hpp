@@ -0,0 +1,232 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <memory>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/field/time_serie.hpp"
+#include "lagrangian/field/vonkarman.hpp"
+#include "lagrangian/integration.hpp"
+#include "lagrangian/particles.hpp"
+#include "lagrangian/runge_kutta.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Moves the stencils of a map of Finite Lyapunov Exponents during a
+ * time step.
+ *
+ * The integration handled by FiniteLyapunovExponentsIntegration evaluates
+ * the field through virtual calls and moves the points through function
+ * pointers, the type of the field, the coordinate system and the mode of
+ * integration being known only at run time. The engines created by Create
+ * for the fields field::TimeSerie and field::Vonkarman are specialized at
+ * compile time for these three parameters, so that the compiler can inline
+ * the whole step of the Runge-Kutta method. The other fields, for example
+ * the fields implemented in Python, are integrated by the
+ * runtime-polymorphic implementation.
+ */
+class FiniteLyapunovExponentsEngine {
+ public:
+  /**
+   * @brief Default method invoked when an instance is destroyed.
+   */
+  virtual ~FiniteLyapunovExponentsEngine() = default;
+
+  /**
+   * @brief Move a set of stencils without testing their separation. The
+   * stencils whose integration is undefined are set to represent a missing
+   * position.
+   *
+   * @param it %Iterator
+   * @param particles Stencils handled
+   * @param indexes Indexes of the stencils to move
+   * @param n Number of stencils to move
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  virtual void Move(const Iterator &it, Particles &particles,
+                    const size_t *indexes, size_t n,
+                    CellProperties &cell) const = 0;
+
+  /**
+   * @brief Move a set of stencils, then set the stencils separated as
+   * completed.
+   *
+   * @param it %Iterator
+   * @param particles Stencils handled
+   * @param indexes Indexes of the stencils to move
+   * @param n Number of stencils to move
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  virtual void Compute(const Iterator &it, Particles &particles,
+                       const size_t *indexes, size_t n,
+                       CellProperties &cell) const = 0;
+
+  /**
+   * @brief Create the engine moving the stencils of an integration
+   *
+   * @param fle Integration of the stencils
+   *
+   * @return The engine specialized for the field of the integration, or the
+   * runtime-polymorphic engine if the type of this field is not known.
+   */
+  static auto Create(const FiniteLyapunovExponentsIntegration &fle)
+      -> std::unique_ptr<FiniteLyapunovExponentsEngine>;
+};
+
+/**
+ * @brief Engine specialized for the type of field FieldType, the coordinate
+ * system Space (coordinates::Cartesian, coordinates::SphericalEquatorial or
+ * coordinates::FastSphericalEquatorial) and the mode of integration.
+ *
+ * The members are defined and explicitly instantiated for the fields
+ * field::TimeSerie and field::Vonkarman in the library.
+ */
+template <typename FieldType, typename Space,
+          FiniteLyapunovExponentsIntegration::Mode mode>
+class StaticFiniteLyapunovExponentsEngine
+    : public FiniteLyapunovExponentsEngine {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param fle Integration of the stencils
+   * @param field Field of the integration
+   */
+  StaticFiniteLyapunovExponentsEngine(
+      const FiniteLyapunovExponentsIntegration &fle,
+      const FieldType *const field)
+      : rk_(fle.get_rk4().get_size_of_interval(), field),
+        separation_threshold_(fle.get_separation_threshold()) {}
+
+  /**
+   * @brief Move a set of stencils without testing their separation.
+   *
+   * @see FiniteLyapunovExponentsEngine::Move
+   */
+  void Move(const Iterator &it, Particles &particles, const size_t *indexes,
+            size_t n, CellProperties &cell) const override;
+
+  /**
+   * @brief Move a set of stencils, then set the stencils separated as
+   * completed.
+   *
+   * @see FiniteLyapunovExponentsEngine::Compute
+   */
+  void Compute(const Iterator &it, Particles &particles,
+               const size_t *indexes, size_t n,
+               CellProperties &cell) const override;
+
+ private:
+  BasicRungeKutta<FieldType, Space> rk_;
+  DistanceThreshold separation_threshold_;
+};
+
+/**
+ * @brief Engine delegating the integration to the runtime-polymorphic
+ * implementation of FiniteLyapunovExponentsIntegration.
+ */
+class DynamicFiniteLyapunovExponentsEngine
+    : public FiniteLyapunovExponentsEngine {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param fle Integration of the stencils
+   */
+  explicit DynamicFiniteLyapunovExponentsEngine(
+      const FiniteLyapunovExponentsIntegration &fle)
+      : fle_(fle) {}
+
+  /**
+   * @brief Move a set of stencils without testing their separation.
+   *
+   * @see FiniteLyapunovExponentsEngine::Move
+   */
+  void Move(const Iterator &it, Particles &particles, const size_t *indexes,
+            const size_t n, CellProperties &cell) const override {
+    fle_.Compute(it, particles, indexes, n, cell);
+  }
+
+  /**
+   * @brief Move a set of stencils, then set the stencils separated as
+   * completed.
+   *
+   * @see FiniteLyapunovExponentsEngine::Compute
+   */
+  void Compute(const Iterator &it, Particles &particles,
+               const size_t *const indexes, const size_t n,
+               CellProperties &cell) const override {
+    fle_.Compute(it, particles, indexes, n, cell);
+
+    for (size_t ix = 0; ix < n; ++ix) {
+      const auto index = indexes[ix];
+
+      if (!particles.IsMissing(index) && fle_.Separation(particles, index)) {
+        particles.set_completed(index);
+      }
+    }
+  }
+
+ private:
+  const FiniteLyapunovExponentsIntegration &fle_;
+};
+
+// ___________________________________________________________________________//
+
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+extern template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+
+}  // namespace lagrangian
@@ -22,6 +22,7 @@
 // ___________________________________________________________________________//
 
 #include "lagrangian/reader.hpp"
+#include "lagrangian/thread_pool.hpp"
 
 // ___________________________________________________________________________//
 
@@ -98,6 +99,24 @@ class Field {
    */
   virtual void Fetch(const double t0, const double t1) {}
 
+  /**
+   * @brief Loads the data needed by a time step [t0, t1] of the integration.
+   * The Runge-Kutta method evaluates the field only at the dates t0,
+   * (t0 + t1) / 2 and t1 of the step: the derived classes can take this
+   * opportunity to prepare, with the threads of the pool, the evaluation of
+   * the field at these dates.
+   *
+   * The default implementation calls Fetch.
+   *
+   * @param t0 Begin date (number of seconds elapsed since 1/1/1970)
+   * @param t1 End date (number of seconds elapsed since 1/1/1970)
+   * @param pool Threads available to prepare the time step
+   */
+  virtual void FetchStep(const double t0, const double t1,
+                         ThreadPool & /*pool*/) {
+    Fetch(t0, t1);
+  }
+
   /**
    * Calculate the value of the speed to the spatio temporal position
    * requested.
@@ -120,6 +139,64 @@ class Field {
     return false;
   }
 
+  /**
+   * Calculate the value of the speed for a set of points at the same time.
+   *
+   * The default implementation calls Compute for each point; the derived
+   * classes can override it to amortize the cost of the virtual call and of
+   * the search in time over the whole set.
+   *
+   * @param t Time in number of seconds elapsed since 1970
+   * @param n Number of points
+   * @param x Longitudes in degree
+   * @param y Latitudes in degree
+   * @param u Velocities, set to NaN if the speed is not defined.
+   * @param v Velocities, set to NaN if the speed is not defined.
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  virtual void ComputeMany(const double t, const size_t n,
+                           const double *const x, const double *const y,
+                           double *const u, double *const v,
+                           CellProperties &cell) const {
+    for (size_t ix = 0; ix < n; ++ix) {
+      if (!Compute(t, x[ix], y[ix], u[ix], v[ix], cell)) {
+        u[ix] = v[ix] = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+  }
+
+  /**
+   * Calculate the value of the speed and of its derivatives with respect to
+   * the coordinates to the spatio temporal position requested.
+   *
+   * The default implementation computes the derivatives by centered finite
+   * differences of Compute, or one-sided differences near the edges of the
+   * field; the derived classes can override it to compute them analytically.
+   *
+   * @param t Time in number of seconds elapsed since 1970
+   * @param x Longitude in degree
+   * @param y Latitude in degree
+   * @param u Velocity
+   * @param v Velocity
+   * @param u_x Derivative of u along the longitude (per degree)
+   * @param u_y Derivative of u along the latitude (per degree)
+   * @param v_x Derivative of v along the longitude (per degree)
+   * @param v_y Derivative of v along the latitude (per degree)
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @return true if the speed and its derivatives are set otherwise false.
+   */
+  virtual auto ComputeGradient(const double t, const double x, const double y,
+                               double &u, double &v, double &u_x, double &u_y,
+                               double &v_x, double &v_y,
+                               CellProperties &cell) const -> bool {
+    if (!Compute(t, x, y, u, v, cell)) {
+      return false;
+    }
+    return Derivative(t, x, y, u, v, 1, 0, u_x, v_x, cell) &&
+           Derivative(t, x, y, u, v, 0, 1, u_y, v_y, cell);
+  }
+
   /**
    * @brief Unit type used by this field.
    *
@@ -153,6 +230,39 @@ class Field {
         throw std::runtime_error("invalid Field::UnitType value");
     }
   }
+
+ private:
+  /// Step, in degrees, of the finite differences computing the derivatives
+  static constexpr double kGradientStep = 1e-5;
+
+  // Derivative of the speed along the direction (dx, dy) computed from the
+  // speed (u, v) at the point (x, y)
+  auto Derivative(const double t, const double x, const double y,
+                  const double u, const double v, const double dx,
+                  const double dy, double &u_d, double &v_d,
+                  CellProperties &cell) const -> bool {
+    const auto h = kGradientStep;
+    double u0;
+    double u1;
+    double v0;
+    double v1;
+
+    const auto before = Compute(t, x - dx * h, y - dy * h, u0, v0, cell);
+    const auto after = Compute(t, x + dx * h, y + dy * h, u1, v1, cell);
+    if (before && after) {
+      u_d = (u1 - u0) / (2 * h);
+      v_d = (v1 - v0) / (2 * h);
+    } else if (after) {
+      u_d = (u1 - u) / h;
+      v_d = (v1 - v) / h;
+    } else if (before) {
+      u_d = (u - u0) / h;
+      v_d = (v - v0) / h;
+    } else {
+      return false;
+    }
+    return true;
+  }
 };
 
 }  // namespace lagrangian
@@ -17,6 +17,7 @@
 // ___________________________________________________________________________//
 
 #include <algorithm>
+#include <array>
 #include <memory>
 
 // ___________________________________________________________________________//
@@ -33,7 +34,7 @@ namespace lagrangian::field {
 /**
  * @brief Time series of velocity field
  */
-class TimeSerie : public Field {
+class TimeSerie final : public Field {
  public:
   /**
    * @brief Default constructor
@@ -42,18 +43,36 @@ class TimeSerie : public Field {
    * files to take into account to interpolate speeds.
    * @param unit_type Unit fields.
    * @param reader_type The reader used to read grids containing speeds.
+   * @param storage Type used to store the grids loaded into memory.
    */
   explicit TimeSerie(
       const std::string &configuration_file,
       Field::UnitType unit_type = kMetric,
       Field::CoordinatesType coordinates_type = kSphericalEquatorial,
-      reader::Factory::Type reader_type = reader::Factory::kNetCDF);
+      reader::Factory::Type reader_type = reader::Factory::kNetCDF,
+      Grid::Storage storage = Grid::kFloat64);
 
   /**
    * @brief Default method invoked when a TimeSerie is destroyed.
    */
   ~TimeSerie() override = default;
 
+  /**
+   * @brief Restricts the grids read to the region that the particles can
+   * reach: the region [x_min, x_max] x [y_min, y_max] widened by the maximum
+   * distance they can travel. The velocities outside this region are
+   * undefined.
+   *
+   * @param x_min Minimum longitude in degrees
+   * @param x_max Maximum longitude in degrees
+   * @param y_min Minimum latitude in degrees
+   * @param y_max Maximum latitude in degrees
+   * @param distance Maximum distance, in meters, travelled by the particles
+   * (e.g. the maximum velocity multiplied by the advection time).
+   */
+  void SetBoundingBox(double x_min, double x_max, double y_min, double y_max,
+                      double distance = 0);
+
   /**
    * @brief Loads the grids used to interpolate the velocities in the
    * interval [t0, t1]
@@ -64,10 +83,46 @@ class TimeSerie : public Field {
    * elapsed since 1970.
    */
   inline void Fetch(const double t0, const double t1) override {
-    u_->Load(t0, t1);
-    v_->Load(t0, t1);
+    // The velocities interpolated at the dates of the previous step are no
+    // longer valid.
+    slabs_ = {};
+    Load(t0, t1);
+  }
+
+  /**
+   * @brief Loads the grids used to interpolate the velocities during the
+   * time step [t0, t1]. If the time slabs are enabled, the grids are also
+   * interpolated, once for all the particles, at the dates t0,
+   * (t0 + t1) / 2 and t1 evaluated by the Runge-Kutta method.
+   *
+   * @param t0 First date of the step expressed as a number of seconds
+   * elapsed since 1970.
+   * @param t1 Last date of the step expressed as a number of seconds elapsed
+   * since 1970.
+   * @param pool Threads interpolating the grids
+   */
+  void FetchStep(double t0, double t1, ThreadPool &pool) override;
+
+  /**
+   * @brief Enables or disables the interpolation in time of the grids at
+   * the beginning of each time step (see FetchStep). The velocities of the
+   * particles are then computed by a spatial interpolation of a single grid
+   * instead of two, at the cost of three grids kept in memory.
+   *
+   * @param value True to enable the time slabs
+   */
+  inline void set_time_slabs(const bool value) {
+    time_slabs_ = value;
+    slabs_ = {};
   }
 
+  /**
+   * @brief Test if the time slabs are enabled
+   *
+   * @return True if the grids are interpolated in time at each time step
+   */
+  [[nodiscard]] inline auto time_slabs() const -> bool { return time_slabs_; }
+
   /**
    * @brief Interpolates the velocity to the wanted spatio temporal position.
    *
@@ -83,12 +138,53 @@ class TimeSerie : public Field {
   bool Compute(double t, double x, double y, double &u, double &v,
                CellProperties &cell) const override;
 
+  /**
+   * @brief Interpolates the velocity and its derivatives with respect to the
+   * coordinates to the wanted spatio temporal position. The derivatives are
+   * those of the bilinear interpolation if the components of the velocity
+   * are stored in the same files, otherwise they are computed by finite
+   * differences.
+   *
+   * @param t Time expressed as a number of seconds elapsed since 1970.
+   * @param x Longitude expressed as degree
+   * @param y Latitude expressed as degree
+   * @param u Velocity
+   * @param v Velocity
+   * @param u_x Derivative of u along the longitude
+   * @param u_y Derivative of u along the latitude
+   * @param v_x Derivative of v along the longitude
+   * @param v_y Derivative of v along the latitude
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @return true if the speed and its derivatives are set otherwise false.
+   */
+  bool ComputeGradient(double t, double x, double y, double &u, double &v,
+                       double &u_x, double &u_y, double &v_x, double &v_y,
+                       CellProperties &cell) const override;
+
+  /**
+   * @brief Interpolates the velocity of a set of points at the same time.
+   *
+   * @param t Time expressed as a number of seconds elapsed since 1970.
+   * @param n Number of points
+   * @param x Longitudes expressed as degree
+   * @param y Latitudes expressed as degree
+   * @param u Velocities, set to NaN if the speed is not defined.
+   * @param v Velocities, set to NaN if the speed is not defined.
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  void ComputeMany(double t, size_t n, const double *x, const double *y,
+                   double *u, double *v, CellProperties &cell) const override;
+
   /**
    * @brief Returns the date of the first grid constituting the time series.
    *
    * @return the julian day of the first date
    */
   [[nodiscard]] inline DateTime StartTime() const {
+    if (uv_ != nullptr) {
+      return DateTime::FromUnixTime(uv_->GetFirstDate());
+    }
     return DateTime::FromUnixTime(
         std::max(u_->GetFirstDate(), v_->GetFirstDate()));
   }
@@ -99,14 +195,65 @@ class TimeSerie : public Field {
    * @return the julian day of the last date
    */
   [[nodiscard]] inline DateTime EndTime() const {
+    if (uv_ != nullptr) {
+      return DateTime::FromUnixTime(uv_->GetLastDate());
+    }
     return DateTime::FromUnixTime(
         std::min(u_->GetLastDate(), v_->GetLastDate()));
   }
 
  private:
+  /// Components of the velocity, interpolated together, if they are stored
+  /// in the same files.
+  std::shared_ptr<lagrangian::TimeSerie> uv_{nullptr};
+
+  /// Components of the velocity, interpolated separately, if they are
+  /// stored in different files.
   std::shared_ptr<lagrangian::TimeSerie> u_{nullptr};
   std::shared_ptr<lagrangian::TimeSerie> v_{nullptr};
   double fill_value_;
+
+  /// Grids interpolated at a date of the current time step: uv if the
+  /// components are interpolated together, otherwise u and v.
+  struct Slab {
+    double date{0};
+    std::unique_ptr<Reader> uv{nullptr};
+    std::unique_ptr<Reader> u{nullptr};
+    std::unique_ptr<Reader> v{nullptr};
+  };
+
+  /// Grids interpolated at the dates t0, (t0 + t1) / 2 and t1 of the current
+  /// time step, if the time slabs are enabled and the readers can combine
+  /// their grids.
+  std::array<Slab, 3> slabs_;
+
+  /// Maximum difference between a date evaluated and the date of a slab
+  double slab_tolerance_{0};
+
+  /// True if the grids are interpolated in time at each time step
+  bool time_slabs_{false};
+
+  // Load the grids used in the interval [t0, t1]
+  inline void Load(const double t0, const double t1) {
+    if (uv_ != nullptr) {
+      uv_->Load(t0, t1);
+    } else {
+      u_->Load(t0, t1);
+      v_->Load(t0, t1);
+    }
+  }
+
+  // Get the grids interpolated at the date requested, or nullptr if no
+  // slab matches this date.
+  [[nodiscard]] inline auto FindSlab(const double t) const -> const Slab * {
+    for (const auto &item : slabs_) {
+      if ((item.uv != nullptr || item.u != nullptr) &&
+          std::abs(t - item.date) <= slab_tolerance_) {
+        return &item;
+      }
+    }
+    return nullptr;
+  }
 };
 
 }  // namespace lagrangian::field
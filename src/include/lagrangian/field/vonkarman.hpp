@@ -16,13 +16,18 @@
 
 // ___________________________________________________________________________//
 
+#include <cmath>
+
+// ___________________________________________________________________________//
+
 #include "lagrangian/field.hpp"
+#include "lagrangian/misc.hpp"
 
 // ___________________________________________________________________________//
 
 namespace lagrangian::field {
 
-class Vonkarman : public Field {
+class Vonkarman final : public Field {
  private:
   double a_;
   double w_;
@@ -72,8 +77,39 @@ class Vonkarman : public Field {
    *
    * @return true
    */
-  bool Compute(double t, double x, double y, double &u, double &v,
-               CellProperties &cell = CellProperties::NONE()) const override;
+  inline bool Compute(const double t, const double x, const double y,
+                      double &u, double &v,
+                      CellProperties & /*cell*/ = CellProperties::NONE())
+      const override {
+    const double x2 = Square(x);
+    const double y2 = Square(y);
+    const double rho = sqrt(x2 + y2);
+    const double xv1 = 1.0 + l_ * FractionalPart(t / tc_);
+    const double xv2 = 1.0 + l_ * FractionalPart((t - tc_ / 2.0) / tc_);
+    const double d4 = exp(-(x2 - 2 * x + 1) / alpha2_ - y2);
+    const double s = 1 - d4;
+    const double h1 = fabs(sin(M_PI * t / tc_));
+    const double h2 = fabs(sin(M_PI * (t - tc_ / 2) / tc_));
+    const double g1 =
+        exp(-r0_ * (alpha2_ * Square(y - y0_) + Square(x - xv1)));
+    const double g2 =
+        exp(-r0_ * (alpha2_ * Square(y + y0_) + Square(x - xv2)));
+    const double g = s * u0_ * y + (g2 * h2 - g1 * h1) * w_;
+    const double a = -2 * r0_;
+    const double b = a * alpha2_;
+    const double gx =
+        ((d4 * u0_ * (2 * x - 2) * y) / alpha2_) +
+        (a * g2 * h2 * w_ * (-xv2 - a * g1 * h1 * (x - xv1) + x));
+    const double gy = b * g2 * h2 * w_ * (y0_ + y - b * g1 * h1 * (y - y0_)) +
+                      u0_ * (2 * d4 * y2 + s);
+    const double f = -exp(-a_ * Square(rho - 1));
+    const double d11 = (-2 * a_ * (rho - 1)) / rho;
+
+    u = f * (gy + (y * d11) * g) + gy;
+    v = -(f * (gx + (x * d11) * g) + gx);
+
+    return true;
+  }
 };
 
 }  // namespace lagrangian::field
@@ -0,0 +1,256 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Read-only values of a grid loaded into memory.
+ *
+ * The values are stored in double precision, in single precision, or packed
+ * into 16-bit integers with a scale factor and an offset computed from the
+ * range of the values. The reduced precisions halve or quarter the memory
+ * used by the grids and the bandwidth needed to interpolate them; the
+ * undefined values are preserved. The values are either owned by the object
+ * or stored in a memory region (e.g. a shared memory segment or a mapped
+ * file) released with the object.
+ */
+class Grid {
+ public:
+  /**
+   * @brief Type used to store the values
+   */
+  enum Storage {
+    kFloat64,  //!< Double precision
+    kFloat32,  //!< Single precision
+    kInt16     //!< 16-bit integers with scale factor and offset
+  };
+
+  /// Packed value representing an undefined value
+  static constexpr int16_t kInt16Missing = -32768;
+
+  /**
+   * @brief Creates a grid owning its values
+   *
+   * @param values Values of the grid
+   * @param storage Type used to store the values
+   */
+  explicit Grid(std::vector<double> values, Storage storage = kFloat64);
+
+  /**
+   * @brief Creates a grid whose values are stored in a memory region
+   *
+   * @param data Address of the values
+   * @param size Number of values
+   * @param storage Type of the values stored
+   * @param scale Scale factor of the packed values
+   * @param offset Offset of the packed values
+   * @param memory Memory region containing the values, released when the
+   * grid is destroyed.
+   */
+  Grid(const void *data, size_t size, Storage storage, double scale,
+       double offset, std::shared_ptr<void> memory);
+
+  /**
+   * @brief Creates a grid whose values, in double precision, are stored in a
+   * memory region
+   *
+   * @param data Address of the values
+   * @param size Number of values
+   * @param memory Memory region containing the values, released when the
+   * grid is destroyed.
+   */
+  Grid(const double *data, const size_t size, std::shared_ptr<void> memory)
+      : Grid(data, size, kFloat64, 1, 0, std::move(memory)) {}
+
+  Grid(const Grid &) = delete;
+  auto operator=(const Grid &) -> Grid & = delete;
+
+  /**
+   * @brief Get the value stored at the given index
+   *
+   * @param index Index of the value
+   * @return the value, or NaN if it is undefined
+   */
+  [[nodiscard]] inline auto Get(const size_t index) const noexcept -> double {
+    switch (storage_) {
+      case kFloat32:
+        return static_cast<const float *>(data_)[index];
+      case kInt16: {
+        const auto value = static_cast<const int16_t *>(data_)[index];
+        return value == kInt16Missing
+                   ? std::numeric_limits<double>::quiet_NaN()
+                   : value * scale_ + offset_;
+      }
+      default:
+        return static_cast<const double *>(data_)[index];
+    }
+  }
+
+  /**
+   * @brief Get the address of the values stored
+   *
+   * @return the address of the first value
+   */
+  [[nodiscard]] inline auto data() const noexcept -> const void * {
+    return data_;
+  }
+
+  /**
+   * @brief Get the number of values
+   *
+   * @return the number of values
+   */
+  [[nodiscard]] inline auto size() const noexcept -> size_t { return size_; }
+
+  /**
+   * @brief Get the type used to store the values
+   *
+   * @return the type of the values
+   */
+  [[nodiscard]] inline auto storage() const noexcept -> Storage {
+    return storage_;
+  }
+
+  /**
+   * @brief Get the scale factor of the packed values
+   *
+   * @return the scale factor
+   */
+  [[nodiscard]] inline auto scale() const noexcept -> double { return scale_; }
+
+  /**
+   * @brief Get the offset of the packed values
+   *
+   * @return the offset
+   */
+  [[nodiscard]] inline auto offset() const noexcept -> double {
+    return offset_;
+  }
+
+  /**
+   * @brief Get the number of bytes used to store the values
+   *
+   * @return the number of bytes
+   */
+  [[nodiscard]] auto nbytes() const noexcept -> size_t;
+
+ private:
+  std::vector<double> float64_;
+  std::vector<float> float32_;
+  std::vector<int16_t> int16_;
+  const void *data_{nullptr};
+  size_t size_{0};
+  Storage storage_{kFloat64};
+  double scale_{1};
+  double offset_{0};
+  std::shared_ptr<void> memory_;
+};
+
+/**
+ * @brief Process-wide cache of the grids loaded into memory.
+ *
+ * A grid is identified by the file containing it (path, size and date of
+ * last modification) and by a description of the data read (variables and
+ * unit). The cache only holds weak references: a grid is released as soon
+ * as the last reader using it is destroyed or loads another grid, so that
+ * several time series or readers opening the same files share a single copy
+ * of the data.
+ *
+ * While a GridCache::Pin is alive, the cache also holds strong references to
+ * the grids it returns, so that a computation reading the same grids several
+ * times loads them only once.
+ *
+ * If the shared memory is enabled, the grids are stored in POSIX shared
+ * memory segments named after their identifier: the first process that
+ * needs a grid decodes it into a new segment, the other processes running on
+ * the same node map this segment instead of reading the file again. The
+ * segment is removed when the process that created it no longer uses it.
+ * If the segment cannot be created or used, the grid is loaded into the
+ * memory of the process.
+ */
+class GridCache {
+ public:
+  /**
+   * @brief Function returning the values of a grid read from the file
+   */
+  using Loader = std::function<std::vector<double>()>;
+
+  /**
+   * @brief Keeps in memory the grids returned by the cache during its
+   * lifetime, even if no reader uses them any more. The grids are released
+   * when the last instance is destroyed.
+   */
+  class Pin {
+   public:
+    /**
+     * @brief Default constructor
+     */
+    Pin();
+
+    /**
+     * @brief Releases the grids pinned if this instance is the last one.
+     */
+    ~Pin();
+
+    Pin(const Pin &) = delete;
+    auto operator=(const Pin &) -> Pin & = delete;
+  };
+
+  /**
+   * @brief Get a grid, loading it if it is not already in memory.
+   *
+   * @param filename Path to the file containing the grid
+   * @param description Description of the data read from the file
+   * (variables, unit, ...)
+   * @param loader Function reading the grid if it is not in the cache
+   * @param storage Type used to store the values of the grid
+   *
+   * @return the grid
+   */
+  static auto Get(const std::string &filename, const std::string &description,
+                  const Loader &loader,
+                  Grid::Storage storage = Grid::kFloat64)
+      -> std::shared_ptr<const Grid>;
+
+  /**
+   * @brief Enable or disable the sharing of the grids between the processes
+   * through shared memory. This option is only available on POSIX systems.
+   *
+   * @param value True to store the grids in shared memory segments
+   */
+  static void SetSharedMemory(bool value);
+
+  /**
+   * @brief Test if the grids are shared between the processes.
+   *
+   * @return True if the grids are stored in shared memory segments
+   */
+  static auto shared_memory() -> bool;
+};
+
+}  // namespace lagrangian
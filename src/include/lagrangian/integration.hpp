@@ -24,6 +24,7 @@
 
 #include "lagrangian/datetime.hpp"
 #include "lagrangian/field.hpp"
+#include "lagrangian/particles.hpp"
 #include "lagrangian/runge_kutta.hpp"
 #include "lagrangian/stencil.hpp"
 
@@ -86,6 +87,19 @@ class Integration {
                             : field_->Fetch(t, t - size_of_interval_);
   }
 
+  /**
+   * Perform the tasks before a new time step, using the threads of a pool
+   * (eg load grids required and interpolate them at the dates of the step)
+   *
+   * @param t Time step in seconds
+   * @param pool Threads available to prepare the time step
+   */
+  void Fetch(const double t, ThreadPool &pool) const {
+    start_time_ < end_time_
+        ? field_->FetchStep(t, t + size_of_interval_, pool)
+        : field_->FetchStep(t, t - size_of_interval_, pool);
+  }
+
   /**
    * @brief Calculate the new position of the particle
    *
@@ -114,17 +128,39 @@ class Integration {
    */
   [[nodiscard]] auto get_rk4() const -> RungeKutta const & { return rk_; }
 
+  /**
+   * @brief Enables or disables the displacement of the points with
+   * coordinates::FastSphericalEquatorial, which evaluates polynomials
+   * instead of trigonometric functions, when the field is metric and
+   * defined in a spherical equatorial coordinates system.
+   *
+   * @param value True to enable the fast displacement
+   */
+  void set_fast_spherical(const bool value) {
+    fast_spherical_ = value;
+    rk_ = RungeKutta(rk_.get_size_of_interval(), field_, value);
+  }
+
+  /**
+   * @brief Test if the fast displacement on the sphere is enabled
+   *
+   * @return True if the points are moved with
+   * coordinates::FastSphericalEquatorial
+   */
+  [[nodiscard]] auto fast_spherical() const -> bool { return fast_spherical_; }
+
   /**
    * @brief Gets start time of the integration
    */
   [[nodiscard]] auto get_start_time() const -> double { return start_time_; }
 
  protected:
-  double size_of_interval_;  //!< Integration time in number of seconds
-  Field *field_;             //!< Field used to compute the velocity
-  double start_time_;        //!< Start time of the integration
-  double end_time_;          //!< End time of the integration
-  RungeKutta rk_;            //!< Runge-Kutta object
+  double size_of_interval_;     //!< Integration time in number of seconds
+  Field *field_;                //!< Field used to compute the velocity
+  double start_time_;           //!< Start time of the integration
+  double end_time_;             //!< End time of the integration
+  RungeKutta rk_;               //!< Runge-Kutta object
+  bool fast_spherical_{false};  //!< Fast displacement on the sphere
 };
 
 // ___________________________________________________________________________//
@@ -447,8 +483,9 @@ class FiniteLyapunovExponentsIntegration : public Integration {
    * @brief Type of stencil known
    */
   enum Stencil {
-    kTriplet,    //!< kTriplet
-    kQuintuplet  //!< kQuintuplet
+    kTriplet,     //!< kTriplet
+    kQuintuplet,  //!< kQuintuplet
+    kVariational  //!< One point moved with the gradient of the flow map
   };
 
   /**
@@ -476,6 +513,7 @@ class FiniteLyapunovExponentsIntegration : public Integration {
     switch (mode_) {
       case kFSLE:
         min_separation_ = min_separation;
+        separation_threshold_ = DistanceThreshold(min_separation_);
         pSeparation_ = &FiniteLyapunovExponentsIntegration::SeparationFSLE;
         break;
       case kFTLE:
@@ -512,12 +550,51 @@ class FiniteLyapunovExponentsIntegration : public Integration {
         return new Triplet(x, y, delta_, start_time_, spherical_equatorial);
       case kQuintuplet:
         return new Quintuplet(x, y, delta_, start_time_, spherical_equatorial);
+      case kVariational:
+        return new Variational(x, y, delta_, start_time_,
+                               spherical_equatorial);
       default:
         throw std::invalid_argument(
             "invalid FiniteLyapunovExponents::Stencil type");
     }
   }
 
+  /**
+   * @brief Get the number of points of a stencil
+   *
+   * @param stencil Type of stencil
+   *
+   * @return The number of points
+   */
+  static inline auto GetStencilSize(const Stencil stencil) -> size_t {
+    switch (stencil) {
+      case kTriplet:
+        return 3;
+      case kQuintuplet:
+        return 5;
+      case kVariational:
+        return 3;
+      default:
+        throw std::invalid_argument(
+            "invalid FiniteLyapunovExponents::Stencil type");
+    }
+  }
+
+  /**
+   * @brief Set the value of the initial point of a stencil stored in a
+   * structure of arrays
+   *
+   * @param x Longitude
+   * @param y Latitude
+   * @param index %Index of the stencil to initialize
+   * @param particles Stencils handled
+   */
+  inline void SetInitialPoint(const double x, const double y,
+                              const size_t index,
+                              Particles &particles) const {
+    particles.SetStencil(index, x, y, delta_);
+  }
+
   /**
    * @brief Determine whether the particle is deemed to be separate
    *
@@ -529,6 +606,20 @@ class FiniteLyapunovExponentsIntegration : public Integration {
     return (this->*pSeparation_)(position);
   }
 
+  /**
+   * @brief Determine whether the stencil \#index is deemed to be separate
+   *
+   * @param particles Stencils handled
+   * @param index %Index of the stencil
+   *
+   * @return True if the particle is separated.
+   */
+  inline auto Separation(const Particles &particles, const size_t index) const
+      -> bool {
+    return mode_ == kFSLE &&
+           particles.MaxDistanceExceeds(index, separation_threshold_);
+  }
+
   /**
    * @brief Get mode of integration
    *
@@ -536,6 +627,33 @@ class FiniteLyapunovExponentsIntegration : public Integration {
    */
   [[nodiscard]] inline auto get_mode() const -> Mode { return mode_; }
 
+  /**
+   * @brief Get the separation from which the stencils are deemed to be
+   * separated
+   *
+   * @return The minimal separation in degrees, negative in FTLE mode
+   */
+  [[nodiscard]] inline auto get_min_separation() const -> double {
+    return min_separation_;
+  }
+
+  /**
+   * @brief Get the fast test of the separation of the stencils
+   *
+   * @return The threshold of the minimal separation
+   */
+  [[nodiscard]] inline auto get_separation_threshold() const
+      -> const DistanceThreshold & {
+    return separation_threshold_;
+  }
+
+  /**
+   * @brief Get the initial separation of the points of a stencil
+   *
+   * @return The initial separation in degrees
+   */
+  [[nodiscard]] inline auto get_delta() const -> double { return delta_; }
+
   /**
    * @brief Calculate the integration
    *
@@ -550,6 +668,37 @@ class FiniteLyapunovExponentsIntegration : public Integration {
     return position->Compute(rk_, it, cell);
   }
 
+  /**
+   * @brief Calculate the integration of the stencil \#index
+   *
+   * @param it %Iterator
+   * @param particles Stencils handled
+   * @param index %Index of the stencil
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @return True if the integration is defined otherwise false
+   */
+  inline auto Compute(const Iterator &it, Particles &particles,
+                      const size_t index, CellProperties &cell) const -> bool {
+    return particles.Compute(rk_, it, index, cell);
+  }
+
+  /**
+   * @brief Calculate the integration of a set of stencils. The stencils
+   * whose integration is undefined are set to represent a missing position.
+   *
+   * @param it %Iterator
+   * @param particles Stencils handled
+   * @param indexes Indexes of the stencils
+   * @param n Number of stencils
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  inline void Compute(const Iterator &it, Particles &particles,
+                      const size_t *const indexes, const size_t n,
+                      CellProperties &cell) const {
+    particles.Compute(rk_, it, indexes, n, cell);
+  }
+
   /**
    * @brief Compute the eigenvalue and the orientation of the eigenvectors
    * of the Cauchy-Green strain tensor
@@ -562,18 +711,37 @@ class FiniteLyapunovExponentsIntegration : public Integration {
   auto ComputeExponents(const Position *position, FiniteLyapunovExponents &fle)
       -> bool;
 
+  /**
+   * @brief Compute the eigenvalue and the orientation of the eigenvectors
+   * of the Cauchy-Green strain tensor of the stencil \#index
+   *
+   * @param particles Stencils handled
+   * @param index %Index of the stencil
+   * @param fle Finite Lyapunov Exponents computed
+   *
+   * @return True if the exponents are defined
+   */
+  auto ComputeExponents(const Particles &particles, size_t index,
+                        FiniteLyapunovExponents &fle) -> bool;
+
  private:
   using SeparationFunction = bool (FiniteLyapunovExponentsIntegration::*)(
       const Position *const p) const;
 
   const double delta_;
   double min_separation_;
+  DistanceThreshold separation_threshold_;
   Mode mode_;
   SeparationFunction pSeparation_;
   double f2_;
 
+  // Compute the exponents from the elements of the gradient of the flow map
+  auto ComputeExponents(double time, double final_separation, double a00,
+                        double a01, double a10, double a11,
+                        FiniteLyapunovExponents &fle) const -> bool;
+
   inline auto SeparationFSLE(const Position *const position) const -> bool {
-    return position->MaxDistance() > min_separation_;
+    return position->MaxDistanceExceeds(separation_threshold_);
   }
 
   inline auto SeparationFTLE(const Position *const /*unused*/) const -> bool {
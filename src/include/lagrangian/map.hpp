@@ -16,14 +16,21 @@
 
 // ___________________________________________________________________________//
 
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <memory>
 #include <optional>
-#include <thread>
+#include <string>
+#include <vector>
 
 // ___________________________________________________________________________//
 
+#include "lagrangian/active_set.hpp"
+#include "lagrangian/checkpoint.hpp"
+#include "lagrangian/engine.hpp"
 #include "lagrangian/integration.hpp"
-#include "lagrangian/list.hpp"
+#include "lagrangian/particles.hpp"
 #include "lagrangian/reader/netcdf.hpp"
 #include "lagrangian/stencil.hpp"
 #include "lagrangian/trace.hpp"
@@ -182,6 +189,14 @@ class Map : public MapProperties {
     return grid_[ix * get_ny() + iy];
   }
 
+  /**
+   * @brief Get the values of the grid, the cell [ix, iy] is stored at the
+   * index ix * ny + iy
+   *
+   * @return A pointer to the first cell
+   */
+  [[nodiscard]] inline auto data() noexcept -> T * { return grid_.data(); }
+
  private:
   std::vector<T> grid_;
 };
@@ -214,13 +229,7 @@ class FiniteLyapunovExponents {
   /**
    * @brief Default method invoked when a map is destroyed.
    */
-  virtual ~FiniteLyapunovExponents() {
-    for (int ix = 0; ix < map_.get_nx(); ++ix) {
-      for (int iy = 0; iy < map_.get_ny(); ++iy) {
-        delete map_.GetItem(ix, iy);
-      }
-    }
-  }
+  virtual ~FiniteLyapunovExponents() = default;
 
   /**
    * @brief Initializing the grid cells
@@ -228,11 +237,19 @@ class FiniteLyapunovExponents {
    * @param fle Finite Lyapunov exponents
    * @param stencil Type of stencil used for the calculation of finite
    * difference.
+   * @param shared_nodes If true, the nodes of the grid are advected only
+   * once and the stencil of a cell is made of its neighbouring nodes. The
+   * cells located on the edges of the grid, or next to a hidden cell, keep
+   * their own stencil.
+   *
+   * @throw std::invalid_argument if the nodes are shared and the initial
+   * separation of the stencils differs from the step of the grid.
    */
   void Initialize(
       lagrangian::FiniteLyapunovExponentsIntegration &fle,
       lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil =
-          lagrangian::FiniteLyapunovExponentsIntegration::kTriplet);
+          lagrangian::FiniteLyapunovExponentsIntegration::kTriplet,
+      bool shared_nodes = false);
 
   /**
    * @brief Initializing the grid cells. Cells located on the hidden values
@@ -242,39 +259,122 @@ class FiniteLyapunovExponents {
    * @param reader NetCDF reader allow to access of the mask's value.
    * @param stencil Type of stencil used for the calculation of finite
    * difference.
+   * @param shared_nodes If true, the nodes of the grid are advected only
+   * once and the stencil of a cell is made of its neighbouring nodes.
+   *
+   * @throw std::invalid_argument if the nodes are shared and the initial
+   * separation of the stencils differs from the step of the grid.
    */
   void Initialize(
       lagrangian::FiniteLyapunovExponentsIntegration &fle,
       const lagrangian::Reader *reader,
       lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil =
-          lagrangian::FiniteLyapunovExponentsIntegration::kTriplet);
+          lagrangian::FiniteLyapunovExponentsIntegration::kTriplet,
+      bool shared_nodes = false);
 
   /**
-   * @brief Compute the map
+   * @brief Compute the map. If the state of the cells was restored from a
+   * checkpoint, the computation resumes where the checkpoint was written.
    *
    * @param fle Finite Lyapunov exponents
    * @param num_threads The number of threads to use for the computation. If 0
    * all CPUs are used. If 1 is given, no parallel computing code is used at
    * all, which is useful for debugging.
+   * @param checkpoint If defined, the checkpoints of the computation are
+   * written in the background, at the interval and on the requests handled
+   * by this instance.
+   *
+   * @throw std::runtime_error if a checkpoint cannot be written
    */
   void Compute(lagrangian::FiniteLyapunovExponentsIntegration &fle,
-               int num_threads);
+               int num_threads, Checkpoint *checkpoint = nullptr);
+
+  /**
+   * @brief Restore the state of the grid cells from a checkpoint written by
+   * Compute, instead of initializing them. The next call to Compute resumes
+   * the computation where the checkpoint was written.
+   *
+   * @param fle Finite Lyapunov exponents, defining the same integration as
+   * the one that wrote the checkpoint. The end of the integration may
+   * differ.
+   * @param filename Path to the checkpoint
+   *
+   * @throw std::runtime_error if the file is not a valid checkpoint
+   * @throw std::invalid_argument if the checkpoint was written for another
+   * map, another integration (e.g. another mode or other separations) or,
+   * if the cells are initialized, another stencil
+   */
+  void Restart(const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+               const std::string &filename);
 
  protected:
   /// Grid
-  Map<Position *> map_;
+  MapProperties map_;
+
+  /// Stencils of the grid cells, the cell [ix, iy] is stored at the index
+  /// ix * ny + iy
+  Particles particles_;
 
  private:
   /**
    * @brief Compute a sub part of the map in a separate thread
    *
-   * @param splitter Parameters of the sub-matrix to compute
-   * @param fle Finite Lyapunov exponents
+   * @param first First cell of the active set to compute
+   * @param last Last cell (excluded) of the active set to compute
+   * @param engine Engine moving the stencils
    * @param it Current time step
    */
-  void ComputeHt(Splitter<Index> &splitter,
-                 lagrangian::FiniteLyapunovExponentsIntegration &fle,
-                 Iterator &it);
+  void ComputeHt(size_t first, size_t last,
+                 const FiniteLyapunovExponentsEngine &engine, Iterator &it);
+
+  /**
+   * @brief Moves the cells computed from the shared nodes to the nodes
+   * advected and tests whether they are separated
+   *
+   * @param first First cell of the set of shared cells to update
+   * @param last Last cell (excluded) of the set of shared cells to update
+   * @param fle Finite Lyapunov exponents
+   */
+  void UpdateSharedCells(
+      size_t first, size_t last,
+      const lagrangian::FiniteLyapunovExponentsIntegration &fle);
+
+  /**
+   * @brief Splits the cells to compute between the cells using the shared
+   * nodes and the cells keeping their own stencil
+   *
+   * @param fle Finite Lyapunov exponents
+   */
+  void ShareNodes(const lagrangian::FiniteLyapunovExponentsIntegration &fle);
+
+  /**
+   * @brief Get the node of the grid located at the point \#member of the
+   * stencil of a cell
+   *
+   * @param index %Index of the cell
+   * @param member %Index of the point in the stencil
+   * @return The index of the node or -1 if the node is outside the grid
+   */
+  [[nodiscard]] auto GetNode(size_t index, size_t member) const -> int64_t;
+
+  /**
+   * @brief Test if a node is still used by a cell under computation
+   *
+   * @param node %Index of the node
+   * @return True if the node must be advected
+   */
+  [[nodiscard]] auto IsNodeUsed(size_t node) const -> bool;
+
+  /**
+   * @brief Copy the state of the computation into an archive
+   *
+   * @param fle Finite Lyapunov exponents computed
+   * @param start Iterator positioned at the beginning of the integration
+   * @return The archive to write in the checkpoint
+   */
+  [[nodiscard]] auto Save(
+      const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+      const Iterator &start) const -> Archive;
 
   /**
    * @brief Test if the computation for a cell is over
@@ -282,13 +382,28 @@ class FiniteLyapunovExponents {
    * @param index %Index of the cell
    * @return True if the computation is over otherwise false
    */
-  inline auto Completed(const Index &index) -> bool {
-    Position *position = map_.GetItem(index.get_i(), index.get_j());
-    return position->is_completed() || position->IsMissing();
+  [[nodiscard]] inline auto Completed(const size_t index) const -> bool {
+    return particles_.is_completed(index) || particles_.IsMissing(index);
   }
 
-  /// List of cells of the matrix to be solved
-  SplitList<Index> indexes_;
+  /// Cells of the matrix to be solved
+  ActiveSet indexes_;
+
+  /// Nodes of the grid advected, the node [ix, iy] is stored at the index
+  /// ix * ny + iy
+  Particles nodes_;
+
+  /// Nodes of the grid to be advected
+  ActiveSet active_nodes_;
+
+  /// Cells of the matrix to be solved from the shared nodes
+  ActiveSet shared_cells_;
+
+  /// For each cell, true if its stencil is made of the shared nodes
+  std::vector<uint8_t> shared_;
+
+  /// Number of time steps already computed
+  size_t steps_{0};
 };
 
 /**
@@ -296,6 +411,16 @@ class FiniteLyapunovExponents {
  */
 class Advect {
  public:
+  /**
+   * @brief Function receiving a snapshot of the positions of the particles:
+   * the index of the snapshot in the list of the dates requested and the
+   * maps of the longitudes and latitudes of the particles at this date,
+   * ordered as the maps returned by GetMapOfX. The maps are only valid
+   * during the call.
+   */
+  using Observer = std::function<void(size_t index, const double *x,
+                                      const double *y)>;
+
   /**
    * @brief Default constructor
    *
@@ -315,13 +440,7 @@ class Advect {
   /**
    * @brief Default method invoked when a map is destroyed.
    */
-  virtual ~Advect() {
-    for (int ix = 0; ix < map_.get_nx(); ++ix) {
-      for (int iy = 0; iy < map_.get_ny(); ++iy) {
-        delete map_.GetItem(ix, iy);
-      }
-    }
-  }
+  virtual ~Advect() = default;
 
   /**
    * @brief Initializing the grid cells. Cells located on the hidden values
@@ -334,28 +453,106 @@ class Advect {
                   const std::optional<lagrangian::Reader *> reader);
 
   /**
-   * @brief Compute the map
+   * @brief Compute the map. If the state of the particles was restored from
+   * a checkpoint, the computation resumes where the checkpoint was written.
    *
    * @param integration Integration properties
    * @param num_threads The number of threads to use for the computation. If 0
    * all CPUs are used. If 1 is given, no parallel computing code is used at
    * all, which is useful for debugging.
+   * @param checkpoint If defined, the checkpoints of the computation are
+   * written in the background, at the interval and on the requests handled
+   * by this instance.
+   *
+   * @throw std::runtime_error if a checkpoint cannot be written
+   */
+  void Compute(Integration &integration, int num_threads,
+               Checkpoint *checkpoint = nullptr);
+
+  /**
+   * @brief Compute the map, taking snapshots of the positions of the
+   * particles at intermediate dates in the same pass.
+   *
+   * The positions at a date of the integration are those of the particles
+   * before the time step starting at this date. The last date available is
+   * the date reached after the last time step, the date of the maps
+   * returned by GetMapOfX and GetMapOfY.
+   *
+   * @param integration Integration properties
+   * @param num_threads The number of threads to use for the computation. If 0
+   * all CPUs are used. If 1 is given, no parallel computing code is used at
+   * all, which is useful for debugging.
+   * @param dates Dates of the snapshots, expressed as a number of seconds
+   * elapsed since 1970, in any order.
+   * @param fill_value Value used for the missing cells
+   * @param observer Function receiving the snapshots
+   * @param checkpoint If defined, the checkpoints of the computation are
+   * written in the background. When the computation resumes from a
+   * checkpoint, the snapshots of the dates already computed are not taken.
+   *
+   * @throw std::invalid_argument if a date is not a date of the integration
+   * @throw std::runtime_error if a checkpoint cannot be written
+   */
+  void Compute(Integration &integration, int num_threads,
+               const std::vector<double> &dates, double fill_value,
+               const Observer &observer, Checkpoint *checkpoint = nullptr);
+
+  /**
+   * @brief Restore the state of the particles from a checkpoint written by
+   * Compute, instead of initializing them. The next call to Compute resumes
+   * the computation where the checkpoint was written.
+   *
+   * @param integration Integration properties, defining the same
+   * integration as the one that wrote the checkpoint. The end of the
+   * integration may differ.
+   * @param filename Path to the checkpoint
+   *
+   * @throw std::runtime_error if the file is not a valid checkpoint
+   * @throw std::invalid_argument if the checkpoint was written for another
+   * map or another integration
+   */
+  void Restart(const Integration &integration, const std::string &filename);
+
+  /**
+   * @brief Get the map of the longitudes of the particles at the end of the
+   * integration
+   *
+   * @param fill_value Value used for the missing cells
+   *
+   * @return The map of the longitudes
+   */
+  [[nodiscard]] auto GetMapOfX(double fill_value) const
+      -> std::unique_ptr<Map<double>>;
+
+  /**
+   * @brief Get the map of the latitudes of the particles at the end of the
+   * integration
+   *
+   * @param fill_value Value used for the missing cells
+   *
+   * @return The map of the latitudes
    */
-  void Compute(Integration &integration, int num_threads);
+  [[nodiscard]] auto GetMapOfY(double fill_value) const
+      -> std::unique_ptr<Map<double>>;
 
  protected:
   /// Grid
-  Map<Position *> map_;
+  MapProperties map_;
+
+  /// Stencils of the grid cells, the cell [ix, iy] is stored at the index
+  /// ix * ny + iy
+  Particles particles_;
 
  private:
   /**
    * @brief Compute a sub part of the map in a separate thread
    *
-   * @param splitter Parameters of the sub-matrix to compute
-   * @param fle Finite Lyapunov exponents
+   * @param first First cell of the active set to compute
+   * @param last Last cell (excluded) of the active set to compute
+   * @param rk4 Runge-Kutta handler
    * @param it Current time step
    */
-  void ComputeHt(Splitter<Index> &splitter, const RungeKutta &rk4,
+  void ComputeHt(size_t first, size_t last, const RungeKutta &rk4,
                  Iterator &it);
 
   /**
@@ -364,13 +561,41 @@ class Advect {
    * @param index %Index of the cell
    * @return True if the computation is over otherwise false
    */
-  inline auto Completed(const Index &index) -> bool {
-    Position *position = map_.GetItem(index.get_i(), index.get_j());
-    return position->IsMissing();
+  [[nodiscard]] inline auto Completed(const size_t index) const -> bool {
+    return particles_.IsMissing(index);
   }
 
-  /// List of cells of the matrix to be solved
-  SplitList<Index> indexes_;
+  /**
+   * @brief Take the snapshots planned at a time step
+   *
+   * @param step %Index of the time step
+   * @param steps %Index of the time step of each snapshot
+   * @param fill_value Value used for the missing cells
+   * @param observer Function receiving the snapshots
+   * @param pool Threads sharing the copy of the positions
+   */
+  void Snapshot(size_t step, const std::vector<size_t> &steps,
+                double fill_value, const Observer &observer,
+                ThreadPool &pool);
+
+  /**
+   * @brief Copy the state of the computation into an archive
+   *
+   * @param start Iterator positioned at the beginning of the integration
+   * @return The archive to write in the checkpoint
+   */
+  [[nodiscard]] auto Save(const Iterator &start) const -> Archive;
+
+  /// Cells of the matrix to be solved
+  ActiveSet indexes_;
+
+  /// Positions of the particles handed out to the observer of the
+  /// snapshots
+  std::vector<double> x_;
+  std::vector<double> y_;
+
+  /// Number of time steps already computed
+  size_t steps_{0};
 };
 
 }  // namespace map
@@ -382,6 +607,18 @@ class Advect {
  */
 class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
  public:
+  /**
+   * @brief Maps that can be extracted from the computed stencils
+   */
+  enum Output {
+    kLambda1,         //!< FLE associated to the maximum eigenvalues
+    kLambda2,         //!< FLE associated to the minimum eigenvalues
+    kTheta1,          //!< Orientation of the eigenvectors of λ₁
+    kTheta2,          //!< Orientation of the eigenvectors of λ₂
+    kDeltaT,          //!< Advection time
+    kFinalSeparation  //!< Effective final separation distance
+  };
+
   /**
    * @brief Default constructor
    *
@@ -409,10 +646,8 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
    */
   auto GetMapOfLambda1(const double nan,
                        lagrangian::FiniteLyapunovExponentsIntegration &fle)
-      const -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_lambda1,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedExponent);
+      const -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kLambda1);
   }
 
   /**
@@ -429,10 +664,8 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
    */
   auto GetMapOfLambda2(const double nan,
                        lagrangian::FiniteLyapunovExponentsIntegration &fle)
-      const -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_lambda2,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedExponent);
+      const -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kLambda2);
   }
 
   /**
@@ -449,10 +682,8 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
    */
   auto GetMapOfTheta1(const double nan,
                       lagrangian::FiniteLyapunovExponentsIntegration &fle) const
-      -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_theta1,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedVector);
+      -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kTheta1);
   }
 
   /**
@@ -469,10 +700,8 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
    */
   auto GetMapOfTheta2(const double nan,
                       lagrangian::FiniteLyapunovExponentsIntegration &fle) const
-      -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_theta2,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedVector);
+      -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kTheta2);
   }
 
   /**
@@ -489,10 +718,8 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
    */
   auto GetMapOfDeltaT(const double nan,
                       lagrangian::FiniteLyapunovExponentsIntegration &fle) const
-      -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_delta_t,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedDeltaT);
+      -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kDeltaT);
   }
 
   /**
@@ -511,66 +738,157 @@ class MapOfFiniteLyapunovExponents : public map::FiniteLyapunovExponents {
   auto GetMapOfFinalSeparation(
       const double nan,
       lagrangian::FiniteLyapunovExponentsIntegration &fle) const
-      -> Map<double> * {
-    return GetMapOfExponents(
-        nan, fle, &lagrangian::FiniteLyapunovExponents::get_final_separation,
-        &lagrangian::FiniteLyapunovExponents::GetUndefinedFinalSeparation);
+      -> std::unique_ptr<Map<double>> {
+    return GetMapOfExponents(nan, fle, kFinalSeparation);
   }
 
- private:
-  using GetExponent = double (lagrangian::FiniteLyapunovExponents::*)() const;
+  /**
+   * @brief Compute several maps in a single pass over the cells of the grid
+   *
+   * The exponents of each cell are computed once, whatever the number of
+   * maps requested.
+   *
+   * @param outputs Maps to compute
+   * @param nan Value of undefined cell
+   * @param fle_integration integration object used to compute the
+   *  integration
+   * @param result Buffer of outputs.size() * nx * ny values receiving the
+   * maps: the cell [ix, iy] of the map #k is stored at the index
+   * (k * nx + ix) * ny + iy
+   * @param num_threads The number of threads to use for the computation. If 0
+   * all CPUs are used. If 1 is given, no parallel computing code is used at
+   * all, which is useful for debugging.
+   */
+  void ComputeMaps(
+      const std::vector<Output> &outputs, double nan,
+      lagrangian::FiniteLyapunovExponentsIntegration &fle_integration,
+      double *result, int num_threads) const;
 
+ private:
   /**
-   * @brief Default constructor
+   * @brief Get a map of the computed exponents
    *
    * @param nan Value of undefined cell
    * @param fle_integration integration object used to compute the
    *  integration
-   * @param pGetExponent Function to use to calculate the exponent
-   * @param pGetUndefinedExponent Function to use to return default value for
-   * undefined exponent
+   * @param output Map to compute
    */
   auto GetMapOfExponents(
       const double nan,
       lagrangian::FiniteLyapunovExponentsIntegration &fle_integration,
-      GetExponent pGetExponent, GetExponent pGetUndefinedExponent) const
-      -> Map<double> * {
-    lagrangian::FiniteLyapunovExponents fle{};
-
+      const Output output) const -> std::unique_ptr<Map<double>> {
     auto result =
-        new Map<double>(map_.get_nx(), map_.get_ny(), map_.get_x_min(),
-                        map_.get_y_min(), map_.get_step());
-
-    for (int ix = 0; ix < map_.get_nx(); ++ix) {
-      for (int iy = 0; iy < map_.get_ny(); ++iy) {
-        Position *position = map_.GetItem(ix, iy);
-        if (position->IsMissing()) {
-          result->SetItem(ix, iy, nan);
-        } else {
-          bool defined = fle_integration.ComputeExponents(position, fle);
-
-          if (fle_integration.get_mode() ==
-              lagrangian::FiniteLyapunovExponentsIntegration::kFTLE) {
-            // In that case position is always completed
-            double exponent = defined
-                                  ? (fle.*pGetExponent)()
-                                  : std::numeric_limits<double>::quiet_NaN();
-            result->SetItem(ix, iy, exponent);
-          } else {
-            if (position->is_completed()) {
-              double exponent = defined
-                                    ? (fle.*pGetExponent)()
-                                    : std::numeric_limits<double>::quiet_NaN();
-              result->SetItem(ix, iy, exponent);
-            } else {
-              result->SetItem(ix, iy, (fle.*pGetUndefinedExponent)());
-            }
-          }
-        }
-      }
-    }
+        std::make_unique<Map<double>>(map_.get_nx(), map_.get_ny(),
+                                      map_.get_x_min(), map_.get_y_min(),
+                                      map_.get_step());
+    ComputeMaps({output}, nan, fle_integration, result->data(), 1);
     return result;
   }
 };
 
+// ___________________________________________________________________________//
+
+/**
+ * @brief Computes a map of Finite Size or Time Lyapunov Exponents by tiles,
+ * in bounded memory
+ *
+ * The map is split into bands of longitudes, sized so that the stencils of
+ * a band and its maps fit into a memory budget. The bands are computed one
+ * after the other with the same integration, and thus the same velocity
+ * field, and the maps of a band are handed out to an observer before the
+ * next band starts. The memory used by the cells depends on the size of the
+ * bands, not on the size of the map.
+ *
+ * The grids of the velocity field loaded by the first band are pinned in
+ * the GridCache until the last band is computed: they are read only once,
+ * whatever the number of bands, but the grids of the whole period stay in
+ * memory during the computation. They are not included in the budget.
+ */
+class TiledMapOfFiniteLyapunovExponents {
+ public:
+  /**
+   * @brief Function receiving the maps of a band: the index of the first
+   * longitude of the band, the number of longitudes of the band and its
+   * maps. The cell [ix, iy] of the map \#k is stored at the index
+   * (k * nx + ix) * ny + iy, where nx is the number of longitudes of the
+   * band. The maps are only valid during the call.
+   */
+  using Observer = std::function<void(int ix, int nx, const double *maps)>;
+
+  /**
+   * @brief Default constructor
+   *
+   * @param map Properties of the map to compute
+   * @param stencil Type of stencil used for the calculation of finite
+   * difference.
+   * @param shared_nodes If true, the nodes of each band are advected only
+   * once and the stencil of a cell is made of its neighbouring nodes.
+   * @param reader NetCDF reader allow to access of the mask's value. If not
+   * defined, all cells are computed.
+   */
+  explicit TiledMapOfFiniteLyapunovExponents(
+      const MapProperties &map,
+      lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil =
+          lagrangian::FiniteLyapunovExponentsIntegration::kTriplet,
+      bool shared_nodes = false, const lagrangian::Reader *reader = nullptr)
+      : map_(map),
+        stencil_(stencil),
+        shared_nodes_(shared_nodes),
+        reader_(reader) {}
+
+  /**
+   * @brief Get an estimate of the memory used to compute a cell
+   *
+   * @param stencil Type of stencil
+   * @param shared_nodes True if the nodes of the grid are shared
+   * @param outputs Number of maps computed
+   *
+   * @return The number of bytes used by a cell
+   */
+  static auto GetMemoryPerCell(
+      lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil,
+      bool shared_nodes, size_t outputs) -> size_t;
+
+  /**
+   * @brief Get the number of longitudes of the bands fitting into a memory
+   * budget
+   *
+   * @param memory_budget Memory budget in bytes
+   * @param outputs Number of maps computed
+   *
+   * @return The number of longitudes of a band
+   *
+   * @throw std::invalid_argument if the budget is too small to compute a
+   * single longitude of the map
+   */
+  [[nodiscard]] auto GetTileSize(size_t memory_budget, size_t outputs) const
+      -> int;
+
+  /**
+   * @brief Compute the map, band by band
+   *
+   * @param fle Finite Lyapunov exponents
+   * @param outputs Maps to compute
+   * @param nan Value of undefined cell
+   * @param memory_budget Memory budget in bytes
+   * @param num_threads The number of threads to use for the computation. If 0
+   * all CPUs are used. If 1 is given, no parallel computing code is used at
+   * all, which is useful for debugging.
+   * @param observer Function receiving the maps of each band
+   *
+   * @throw std::invalid_argument if the budget is too small to compute a
+   * single longitude of the map
+   */
+  void Compute(lagrangian::FiniteLyapunovExponentsIntegration &fle,
+               const std::vector<MapOfFiniteLyapunovExponents::Output> &outputs,
+               double nan, size_t memory_budget, int num_threads,
+               const Observer &observer) const;
+
+ private:
+  MapProperties map_;
+  lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil_;
+  bool shared_nodes_;
+  const lagrangian::Reader *reader_;
+};
+
 }  // namespace lagrangian
@@ -16,7 +16,10 @@
 
 // ___________________________________________________________________________//
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <limits>
 
 // ___________________________________________________________________________//
 
@@ -104,6 +107,116 @@ inline auto GeodeticDistance(const double lon0, const double lat0,
       acos(sin(y0) * sin(y1) + cos(y0) * cos(y1) * cos(x1 - x0)));
 }
 
+/**
+ * @brief Fast test of the distance between the first point of a set of
+ * points and the other ones against a threshold.
+ *
+ * The test compares, in a spherical equatorial coordinates system, the
+ * squared length of the chords joining the points on the unit sphere, and in
+ * a Cartesian space, the squared distances, with the same measure of the
+ * threshold computed once. This avoids the inverse trigonometric function
+ * and the square root evaluated by GeodeticDistance and Distance. The
+ * threshold is lowered by a margin covering the rounding errors of these
+ * functions: when the test fails, the distances are certainly lower than or
+ * equal to the threshold, otherwise the exact distances must be computed.
+ */
+class DistanceThreshold {
+ public:
+  /**
+   * @brief Default constructor: no distance exceeds the threshold.
+   */
+  DistanceThreshold() = default;
+
+  /**
+   * @brief Constructor
+   *
+   * @param distance Threshold, in degrees in a spherical equatorial
+   * coordinates system or in the unit of the coordinates in a Cartesian
+   * space. A negative threshold is exceeded by all distances.
+   */
+  explicit DistanceThreshold(const double distance) : distance_(distance) {
+    if (distance < 0) {
+      chord_ = square_ = -1;
+      return;
+    }
+    chord_ = Square(
+        2 * std::sin(DegreesToRadians(std::min(distance, 180.0)) / 2));
+    chord_ -= chord_ * kRelativeMargin + kAbsoluteMargin;
+    square_ = Square(distance);
+    square_ -= square_ * kRelativeMargin;
+  }
+
+  /**
+   * @brief Get the threshold
+   *
+   * @return The threshold
+   */
+  [[nodiscard]] inline auto distance() const noexcept -> double {
+    return distance_;
+  }
+
+  /**
+   * @brief Test if the distance between the point \#0 and one of the points
+   * \#1 to \#n - 1 may exceed the threshold
+   *
+   * @param x Abscissas of the points, the point \#k being stored at
+   * x[k * stride]
+   * @param y Ordinates of the points, stored as the abscissas
+   * @param n Number of points
+   * @param stride Distance between two consecutive points in the arrays
+   * @param spherical_equatorial True if the coordinates system is Lon/lat
+   * otherwise false
+   *
+   * @return False if all the distances are lower than or equal to the
+   * threshold, true if the exact distances must be computed.
+   */
+  [[nodiscard]] inline auto MayBeExceeded(const double *const x,
+                                          const double *const y,
+                                          const size_t n, const size_t stride,
+                                          const bool spherical_equatorial) const
+      -> bool {
+    if (spherical_equatorial) {
+      // Haversine formula of the chord length
+      const auto y0 = DegreesToRadians(y[0]);
+      const auto cos_y0 = std::cos(y0);
+      for (size_t k = 1; k < n; ++k) {
+        const auto yk = DegreesToRadians(y[k * stride]);
+        const auto chord =
+            4 * (Square(std::sin((yk - y0) / 2)) +
+                 cos_y0 * std::cos(yk) *
+                     Square(std::sin(DegreesToRadians(x[k * stride] - x[0]) /
+                                     2)));
+        if (chord > chord_) {
+          return true;
+        }
+      }
+      return false;
+    }
+    for (size_t k = 1; k < n; ++k) {
+      if (Square(x[k * stride] - x[0]) + Square(y[k * stride] - y[0]) >
+          square_) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  /// Margins covering the rounding errors of the cosine of the angle between
+  /// two points computed by GeodeticDistance.
+  static constexpr double kRelativeMargin = 1e-12;
+  static constexpr double kAbsoluteMargin = 1e-14;
+
+  /// Threshold
+  double distance_{std::numeric_limits<double>::max()};
+
+  /// Squared chord length on the unit sphere of the threshold
+  double chord_{std::numeric_limits<double>::max()};
+
+  /// Squared threshold
+  double square_{std::numeric_limits<double>::max()};
+};
+
 /**
  * @brief Standardization of longitude
  *
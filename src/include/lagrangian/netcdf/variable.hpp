@@ -171,6 +171,28 @@ class Variable : public Group {
    */
   void Read(std::vector<double> &data, const std::string &to) const;
 
+  /**
+   * @brief Read a hyperslab of this variable.
+   *
+   * @param data read, stored in the order of the dimensions of the variable
+   * @param start index of the first value read along each dimension
+   * @param count number of values read along each dimension
+   */
+  void Read(std::vector<double> &data, const std::vector<size_t> &start,
+            const std::vector<size_t> &count) const;
+
+  /**
+   * @brief Read a hyperslab of this variable and convert data to the
+   * requested unit.
+   *
+   * @param data read and converted
+   * @param start index of the first value read along each dimension
+   * @param count number of values read along each dimension
+   * @param to unit used to convert data
+   */
+  void Read(std::vector<double> &data, const std::vector<size_t> &start,
+            const std::vector<size_t> &count, const std::string &to) const;
+
   /**
    * @brief Represents a missing variable.
    */
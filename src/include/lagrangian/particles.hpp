@@ -0,0 +1,516 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/checkpoint.hpp"
+#include "lagrangian/misc.hpp"
+#include "lagrangian/runge_kutta.hpp"
+#include "lagrangian/stencil.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Structure of arrays storing the stencils of all the cells of a map
+ *
+ * Where a Position holds the N points of one stencil, this class holds the
+ * stencils of a whole grid in a few contiguous arrays: the abscissa of the
+ * point k of the cell i is stored at x_[k * size + i]. The integration time
+ * and the state (completed, missing) of the cells are stored in separate
+ * arrays. The state uses one byte per cell so that the threads updating
+ * neighboring cells never write to the same memory word.
+ *
+ * The points of a stencil are laid out as for the classes Point, Triplet
+ * and Quintuplet:
+ *
+ * <PRE>
+ *            M₂
+ *            |
+ *    M₃ ⎯⎯ M₀ ⎯⎯  M₁
+ *            |
+ *            M₄
+ * </PRE>
+ */
+class Particles {
+ public:
+  /**
+   * @brief Default constructor
+   */
+  Particles() = default;
+
+  /**
+   * @brief Constructor
+   *
+   * @param size Number of stencils (cells) handled
+   * @param stencil_size Number of points by stencil (1, 3 or 5)
+   * @param start_time Advection starting time particles
+   * @param spherical_equatorial True if the coordinates system is Lon/lat
+   * otherwise false
+   * @param variational True if the points M₁ and M₂ of the stencils of 3
+   * points are moved by the linearized flow around M₀, as for the class
+   * Variational, instead of being advected.
+   *
+   * @throw std::invalid_argument if the size of the stencil is not handled
+   */
+  Particles(const size_t size, const size_t stencil_size,
+            const double start_time, const bool spherical_equatorial,
+            const bool variational = false)
+      : size_(size),
+        stencil_size_(stencil_size),
+        x_(size * stencil_size),
+        y_(size * stencil_size),
+        time_(size, start_time),
+        flags_(size, 0),
+        variational_(variational),
+        spherical_equatorial_(spherical_equatorial),
+        pDistance_(spherical_equatorial ? &GeodeticDistance : &Distance) {
+    if (stencil_size != 1 && stencil_size != 3 && stencil_size != 5) {
+      throw std::invalid_argument("invalid stencil size");
+    }
+    if (variational && stencil_size != 3) {
+      throw std::invalid_argument(
+          "the variational stencils are made of 3 points");
+    }
+  }
+
+  /**
+   * Move constructor
+   *
+   * @param rhs right value
+   */
+  Particles(Particles &&rhs) = default;
+
+  /**
+   * Move assignment operator
+   *
+   * @param rhs right value
+   */
+  auto operator=(Particles &&rhs) -> Particles & = default;
+
+  /**
+   * @brief Get the number of stencils handled by this instance
+   *
+   * @return The number of stencils
+   */
+  [[nodiscard]] inline auto size() const -> size_t { return size_; }
+
+  /**
+   * @brief Get the number of points of a stencil
+   *
+   * @return The number of points
+   */
+  [[nodiscard]] inline auto stencil_size() const -> size_t {
+    return stencil_size_;
+  }
+
+  /**
+   * @brief Test if the stencils are moved by the linearized flow
+   *
+   * @return True if the stencils are variational
+   */
+  [[nodiscard]] inline auto is_variational() const -> bool {
+    return variational_;
+  }
+
+  /**
+   * @brief Set the initial position of the stencil \#index
+   *
+   * @param index %Index of the stencil
+   * @param x Longitude of the initial point
+   * @param y Latitude of the initial point
+   * @param delta Initial separation in degrees of neighboring
+   */
+  inline void SetStencil(const size_t index, const double x, const double y,
+                         const double delta) {
+    // Unit offsets of the points M₀ to M₄ of the stencil
+    static const double dx[] = {0, 1, 0, -1, 0};
+    static const double dy[] = {0, 0, 1, 0, -1};
+
+    for (size_t k = 0; k < stencil_size_; ++k) {
+      x_[k * size_ + index] = x + dx[k] * delta;
+      y_[k * size_ + index] = y + dy[k] * delta;
+    }
+  }
+
+  /**
+   * @brief Set the position of the point \#member of the stencil \#index
+   *
+   * @param member %Index of the point in the stencil
+   * @param index %Index of the stencil
+   * @param x Longitude
+   * @param y Latitude
+   */
+  inline void SetPoint(const size_t member, const size_t index, const double x,
+                       const double y) {
+    x_[member * size_ + index] = x;
+    y_[member * size_ + index] = y;
+  }
+
+  /**
+   * @brief Get the longitude of the point \#member of the stencil \#index
+   *
+   * @return The longitude in degrees
+   */
+  [[nodiscard]] inline auto get_x(const size_t member,
+                                  const size_t index) const -> double {
+    return x_[member * size_ + index];
+  }
+
+  /**
+   * @brief Get the latitude of the point \#member of the stencil \#index
+   *
+   * @return The latitude in degrees
+   */
+  [[nodiscard]] inline auto get_y(const size_t member,
+                                  const size_t index) const -> double {
+    return y_[member * size_ + index];
+  }
+
+  /**
+   * @brief Get the time at the end of the integration of the stencil \#index
+   *
+   * @return The time expressed in number of seconds elapsed since 1970
+   */
+  [[nodiscard]] inline auto get_time(const size_t index) const -> double {
+    return time_[index];
+  }
+
+  /**
+   * @brief Set the time reached by the integration of the stencil \#index
+   *
+   * @param index %Index of the stencil
+   * @param time The time expressed in number of seconds elapsed since 1970
+   */
+  inline void set_time(const size_t index, const double time) {
+    time_[index] = time;
+  }
+
+  /**
+   * @brief Test if the integration of the stencil \#index is over
+   *
+   * @return True if the integration is over
+   */
+  [[nodiscard]] inline auto is_completed(const size_t index) const -> bool {
+    return (flags_[index] & kCompleted) != 0;
+  }
+
+  /**
+   * @brief Indicate that the integration of the stencil \#index is complete.
+   */
+  inline void set_completed(const size_t index) {
+    flags_[index] |= kCompleted;
+  }
+
+  /**
+   * @brief Set the stencil \#index to represent a missing position.
+   */
+  inline void Missing(const size_t index) { flags_[index] |= kMissing; }
+
+  /**
+   * @brief Test if the integration of the stencil \#index is undefined.
+   *
+   * @return True if the integration is undefined.
+   */
+  [[nodiscard]] inline auto IsMissing(const size_t index) const -> bool {
+    return (flags_[index] & kMissing) != 0;
+  }
+
+  /**
+   * @brief Compute the distance max between the point M₀ and the other
+   * points of the stencil \#index
+   *
+   * @return The max distance
+   */
+  [[nodiscard]] inline auto MaxDistance(const size_t index) const -> double {
+    double result = 0;
+    const auto x0 = x_[index];
+    const auto y0 = y_[index];
+
+    for (size_t k = 1; k < stencil_size_; ++k) {
+      double distance =
+          (*pDistance_)(x0, y0, x_[k * size_ + index], y_[k * size_ + index]);
+      if (distance > result) {
+        result = distance;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Test if the distance max between the point M₀ and the other
+   * points of the stencil \#index exceeds a threshold. The distance max is
+   * computed only if the fast test of the threshold does not exclude it.
+   *
+   * @param index %Index of the stencil
+   * @param threshold Threshold tested
+   *
+   * @return MaxDistance(index) > threshold.distance()
+   */
+  [[nodiscard]] inline auto MaxDistanceExceeds(
+      const size_t index, const DistanceThreshold &threshold) const -> bool {
+    return threshold.MayBeExceeded(&x_[index], &y_[index], stencil_size_,
+                                   size_, spherical_equatorial_) &&
+           MaxDistance(index) > threshold.distance();
+  }
+
+  /**
+   * @brief To move the stencil \#index with a velocity field.
+   *
+   * @param rk Runge-Kutta handler (RungeKutta or BasicRungeKutta)
+   * @param it Iterator
+   * @param index %Index of the stencil
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @return True if all the points of the stencil could be moved otherwise
+   * false
+   */
+  template <typename Method>
+  inline auto Compute(const Method &rk, const Iterator &it,
+                      const size_t index, CellProperties &cell) -> bool {
+    if (variational_) {
+      return ComputeVariational(rk, it, index, cell);
+    }
+
+    double x[5];
+    double y[5];
+
+    for (size_t k = 0; k < stencil_size_; ++k) {
+      if (!rk.Compute(it(), x_[k * size_ + index], y_[k * size_ + index], x[k],
+                      y[k], cell)) {
+        return false;
+      }
+    }
+    for (size_t k = 0; k < stencil_size_; ++k) {
+      x_[k * size_ + index] = x[k];
+      y_[k * size_ + index] = y[k];
+    }
+    time_[index] = it();
+    return true;
+  }
+
+  /**
+   * @brief To move a set of stencils with a velocity field.
+   *
+   * All the points of the stencils are moved at once, by blocks. The
+   * stencils having a point that could not be moved are set to represent a
+   * missing position.
+   *
+   * @param rk Runge-Kutta handler (RungeKutta or BasicRungeKutta)
+   * @param it Iterator
+   * @param indexes Indexes of the stencils to move
+   * @param n Number of stencils to move
+   * @param cell Cell properties of the grid used for the interpolation.
+   */
+  template <typename Method>
+  inline void Compute(const Method &rk, const Iterator &it,
+                      const size_t *const indexes, const size_t n,
+                      CellProperties &cell) {
+    if (variational_) {
+      for (size_t ix = 0; ix < n; ++ix) {
+        if (!ComputeVariational(rk, it, indexes[ix], cell)) {
+          Missing(indexes[ix]);
+        }
+      }
+      return;
+    }
+
+    double x0[kBlockSize * 5];
+    double y0[kBlockSize * 5];
+    double x1[kBlockSize * 5];
+    double y1[kBlockSize * 5];
+
+    for (size_t first = 0; first < n; first += kBlockSize) {
+      const auto size = std::min(kBlockSize, n - first);
+
+      // The points of a stencil are stored next to each other to take
+      // advantage of the cell cached by the interpolation.
+      for (size_t ix = 0; ix < size; ++ix) {
+        for (size_t k = 0; k < stencil_size_; ++k) {
+          x0[ix * stencil_size_ + k] = x_[k * size_ + indexes[first + ix]];
+          y0[ix * stencil_size_ + k] = y_[k * size_ + indexes[first + ix]];
+        }
+      }
+
+      rk.ComputeMany(it(), size * stencil_size_, x0, y0, x1, y1, cell);
+
+      for (size_t ix = 0; ix < size; ++ix) {
+        const auto index = indexes[first + ix];
+        const auto *const x = x1 + ix * stencil_size_;
+        const auto *const y = y1 + ix * stencil_size_;
+
+        bool defined = true;
+        for (size_t k = 0; k < stencil_size_; ++k) {
+          defined &= !(std::isnan(x[k]) || std::isnan(y[k]));
+        }
+        if (!defined) {
+          Missing(index);
+          continue;
+        }
+        for (size_t k = 0; k < stencil_size_; ++k) {
+          x_[k * size_ + index] = x[k];
+          y_[k * size_ + index] = y[k];
+        }
+        time_[index] = it();
+      }
+    }
+  }
+
+  /**
+   * @brief Write the stencils into an archive
+   *
+   * @param archive Archive receiving the stencils
+   */
+  inline void Write(Archive &archive) const {
+    archive.Write(size_);
+    archive.Write(stencil_size_);
+    archive.Write(variational_);
+    archive.Write(spherical_equatorial_);
+    archive.Write(x_);
+    archive.Write(y_);
+    archive.Write(time_);
+    archive.Write(flags_);
+  }
+
+  /**
+   * @brief Read the stencils written into an archive by Write
+   *
+   * @param archive Archive containing the stencils
+   *
+   * @throw std::runtime_error if the archive is truncated or corrupted
+   */
+  inline void Read(Archive &archive) {
+    archive.Read(size_);
+    archive.Read(stencil_size_);
+    archive.Read(variational_);
+    archive.Read(spherical_equatorial_);
+    archive.Read(x_);
+    archive.Read(y_);
+    archive.Read(time_);
+    archive.Read(flags_);
+    if (x_.size() != size_ * stencil_size_ || y_.size() != x_.size() ||
+        time_.size() != size_ || flags_.size() != size_) {
+      throw std::runtime_error("truncated or corrupted checkpoint");
+    }
+    pDistance_ = spherical_equatorial_ ? &GeodeticDistance : &Distance;
+  }
+
+  /**
+   * @brief Get the elements of the gradient of the flow map computed from
+   * the stencil \#index
+   *
+   * @param index %Index of the stencil
+   * @param a00 δx along the first axis of the stencil
+   * @param a01 δx along the second axis of the stencil
+   * @param a10 δy along the first axis of the stencil
+   * @param a11 δy along the second axis of the stencil
+   */
+  inline void StrainTensor(const size_t index, double &a00, double &a01,
+                           double &a10, double &a11) const {
+    switch (stencil_size_) {
+      case 3:
+        a00 = x_[size_ + index] - x_[index];
+        a01 = x_[2 * size_ + index] - x_[index];
+        a10 = y_[size_ + index] - y_[index];
+        a11 = y_[2 * size_ + index] - y_[index];
+        break;
+      case 5:
+        a00 = x_[size_ + index] - x_[3 * size_ + index];
+        a01 = x_[2 * size_ + index] - x_[4 * size_ + index];
+        a10 = y_[size_ + index] - y_[3 * size_ + index];
+        a11 = y_[2 * size_ + index] - y_[4 * size_ + index];
+        break;
+      default:
+        a00 = a01 = a10 = a11 = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+ private:
+  /// Number of stencils moved at once by the batched version of Compute
+  static constexpr size_t kBlockSize = 64;
+
+  /// Distance calculation function
+  using DistanceCalculator = double (*)(const double x0, const double x1,
+                                        const double y0, const double y1);
+
+  /// State of a stencil
+  enum Flags : uint8_t {
+    kCompleted = 0x1,  //!< The integration is over
+    kMissing = 0x2     //!< The integration is undefined
+  };
+
+  /// Number of stencils
+  size_t size_{0};
+
+  /// Number of points by stencil
+  size_t stencil_size_{0};
+
+  /// Abscissas of the points
+  std::vector<double> x_;
+
+  /// Ordinates of the points
+  std::vector<double> y_;
+
+  /// Integration time (number of seconds elapsed since 1970)
+  std::vector<double> time_;
+
+  /// State of the stencils
+  std::vector<uint8_t> flags_;
+
+  /// True if the stencils are moved by the linearized flow
+  bool variational_{false};
+
+  /// True if the coordinates system is Lon/lat
+  bool spherical_equatorial_{true};
+
+  /// Function used to calculate distance
+  DistanceCalculator pDistance_{&GeodeticDistance};
+
+  // Move the point M₀ of the stencil \#index together with the gradient of
+  // the flow map G, then place M₁ and M₂ at M₀ + G e₁ and M₀ + G e₂.
+  template <typename Method>
+  inline auto ComputeVariational(const Method &rk, const Iterator &it,
+                                 const size_t index, CellProperties &cell)
+      -> bool {
+    const auto x0 = x_[index];
+    const auto y0 = y_[index];
+    double g[] = {x_[size_ + index] - x0, x_[2 * size_ + index] - x0,
+                  y_[size_ + index] - y0, y_[2 * size_ + index] - y0};
+    double x;
+    double y;
+
+    if (!rk.ComputeVariational(it(), x0, y0, x, y, g, cell)) {
+      return false;
+    }
+    SetPoint(0, index, x, y);
+    SetPoint(1, index, x + g[0], y + g[2]);
+    SetPoint(2, index, x + g[1], y + g[3]);
+    time_[index] = it();
+    return true;
+  }
+};
+
+}  // namespace lagrangian
@@ -16,12 +16,15 @@
 
 // ___________________________________________________________________________//
 
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 // ___________________________________________________________________________//
 
 #include "lagrangian/axis.hpp"
 #include "lagrangian/datetime.hpp"
+#include "lagrangian/thread_pool.hpp"
 
 // ___________________________________________________________________________//
 
@@ -168,6 +171,39 @@ class Reader {
    */
   virtual void Load(const std::string &name, const std::string &unit = "") = 0;
 
+  /**
+   * @brief Load into memory the two components of a vector field, stored
+   * interleaved so that a single lookup gives both components of a grid node.
+   *
+   * The default implementation does not handle vector fields.
+   *
+   * @param u_name Name of the grid who contains the first component
+   * @param v_name Name of the grid who contains the second component
+   * @param unit Unit of data loaded into memory.
+   *
+   * @throw std::logic_error if the reader does not handle vector fields.
+   */
+  virtual void LoadVector(const std::string & /*u_name*/,
+                          const std::string & /*v_name*/,
+                          const std::string & /*unit*/ = "") {
+    throw std::logic_error("this reader does not handle vector fields");
+  }
+
+  /**
+   * @brief Restricts the grids read by the next calls to Open to the region
+   * [x_min, x_max] x [y_min, y_max]. The points located outside this region
+   * are considered outside the grid.
+   *
+   * The default implementation reads the whole grids.
+   *
+   * @param x_min Minimum longitude in degrees
+   * @param x_max Maximum longitude in degrees
+   * @param y_min Minimum latitude in degrees
+   * @param y_max Maximum latitude in degrees
+   */
+  virtual void SetBoundingBox(double /*x_min*/, double /*x_max*/,
+                              double /*y_min*/, double /*y_max*/) {}
+
   /**
    * @brief Computes the velocity of the grid point requested
    *
@@ -185,6 +221,126 @@ class Reader {
                            CellProperties &cell = CellProperties::NONE()) const
       -> double = 0;
 
+  /**
+   * @brief Computes the velocity of a set of points
+   *
+   * The default implementation calls Interpolate for each point.
+   *
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param result Interpolated velocities
+   * @param cell Cell properties of the grid used for the interpolation.
+   */
+  virtual void InterpolateMany(const size_t n, const double *const longitude,
+                               const double *const latitude,
+                               const double fill_value, double *const result,
+                               CellProperties &cell) const {
+    for (size_t ix = 0; ix < n; ++ix) {
+      result[ix] = Interpolate(longitude[ix], latitude[ix], fill_value, cell);
+    }
+  }
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector at the requested point
+   *
+   * @param longitude in degrees
+   * @param latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component
+   * @param v Second component
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @throw std::logic_error if the reader does not handle vector fields.
+   */
+  virtual void InterpolateVector(double /*longitude*/, double /*latitude*/,
+                                 double /*fill_value*/, double & /*u*/,
+                                 double & /*v*/,
+                                 CellProperties & /*cell*/) const {
+    throw std::logic_error("this reader does not handle vector fields");
+  }
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector and their derivatives with respect to the coordinates at the
+   * requested point
+   *
+   * @param longitude in degrees
+   * @param latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component
+   * @param v Second component
+   * @param u_x Derivative of the first component along the longitude (unit
+   * of the component per degree)
+   * @param u_y Derivative of the first component along the latitude
+   * @param v_x Derivative of the second component along the longitude
+   * @param v_y Derivative of the second component along the latitude
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @throw std::logic_error if the reader does not handle the gradient of
+   * vector fields.
+   */
+  virtual void InterpolateVectorGradient(
+      double /*longitude*/, double /*latitude*/, double /*fill_value*/,
+      double & /*u*/, double & /*v*/, double & /*u_x*/, double & /*u_y*/,
+      double & /*v_x*/, double & /*v_y*/, CellProperties & /*cell*/) const {
+    throw std::logic_error(
+        "this reader does not handle the gradient of vector fields");
+  }
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector for a set of points
+   *
+   * The default implementation calls InterpolateVector for each point.
+   *
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First components
+   * @param v Second components
+   * @param cell Cell properties of the grid used for the interpolation.
+   */
+  virtual void InterpolateVectorMany(const size_t n,
+                                     const double *const longitude,
+                                     const double *const latitude,
+                                     const double fill_value, double *const u,
+                                     double *const v,
+                                     CellProperties &cell) const {
+    for (size_t ix = 0; ix < n; ++ix) {
+      InterpolateVector(longitude[ix], latitude[ix], fill_value, u[ix], v[ix],
+                        cell);
+    }
+  }
+
+  /**
+   * @brief Creates a reader of the weighted mean (w0 * a + w1 * b) /
+   * (w0 + w1) of the grid a, loaded by this reader, and of the grid b, loaded
+   * by another reader on the same axes. The undefined values are replaced by
+   * the fill value before the combination, so that interpolating the result
+   * with the same fill value gives the interpolation in time of the values
+   * interpolated by the two readers.
+   *
+   * The default implementation does not handle this operation.
+   *
+   * @param other Reader of the grid b
+   * @param w0 Weight of the grid a
+   * @param w1 Weight of the grid b
+   * @param fill_value Value to be taken into account for fill values
+   * @param pool Threads computing the grid
+   *
+   * @return The reader created, or nullptr if the grids cannot be combined.
+   */
+  [[nodiscard]] virtual auto Blend(const Reader & /*other*/, double /*w0*/,
+                                   double /*w1*/, double /*fill_value*/,
+                                   ThreadPool & /*pool*/) const
+      -> std::unique_ptr<Reader> {
+    return nullptr;
+  }
+
   /**
    * @brief Returns the date of the grid.
    *
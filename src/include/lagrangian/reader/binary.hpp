@@ -0,0 +1,141 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/reader/netcdf.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian::reader {
+
+/**
+ * @brief Reader of the native binary grids.
+ *
+ * A binary grid is a NetCDF grid preprocessed by Binary::Convert: the
+ * components of the velocity are stored interleaved, in double precision,
+ * already converted into the unit wanted, with the undefined values set to
+ * NaN. The file is composed of a header page describing the grid (axes,
+ * variables, unit and date) followed by the page-aligned values of the grid
+ * stored in the native byte order.
+ *
+ * The file is mapped into memory: loading the grid does not copy or decode
+ * the values, which are read from the page cache shared by all the processes
+ * of the node. A copy is made only if the variables or the unit requested
+ * differ from those stored. The bounding box is ignored: only the pages of
+ * the file that are accessed are read.
+ */
+class Binary : public NetCDF {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param storage Type used to store the grids loaded into memory. The
+   * grids are mapped without copy only if they are stored in double
+   * precision.
+   */
+  explicit Binary(const Grid::Storage storage = Grid::kFloat64)
+      : NetCDF(storage) {}
+
+  /**
+   * @brief Opens a binary grid and maps it into memory.
+   *
+   * @param filename Path to the binary grid
+   *
+   * @throw std::runtime_error If the file is not a valid binary grid.
+   */
+  void Open(const std::string &filename) override;
+
+  /**
+   * @brief Load into memory grid data
+   *
+   * @param varname name of the variable who contains grid data
+   * @param unit Unit of data loaded into memory. If the parameter is
+   * undefined or contains an empty string, the object will not do unit
+   * conversion.
+   */
+  void Load(const std::string &varname, const std::string &unit = "") override;
+
+  /**
+   * @brief Load into memory the two components of a vector field.
+   *
+   * @param u_name name of the variable who contains the first component
+   * @param v_name name of the variable who contains the second component
+   * @param unit Unit of data loaded into memory. If the parameter is
+   * undefined or contains an empty string, the object will not do unit
+   * conversion.
+   */
+  void LoadVector(const std::string &u_name, const std::string &v_name,
+                  const std::string &unit = "") override;
+
+  /**
+   * @brief Returns the date of the grid.
+   *
+   * @param name The variable name containing the date
+   *
+   * @return the date
+   */
+  [[nodiscard]] auto GetDateTime(const std::string &name) const
+      -> DateTime override;
+
+  /**
+   * @brief Converts a NetCDF grid into a binary grid
+   *
+   * @param source Path to the NetCDF grid
+   * @param u_name name of the NetCDF variable who contains the first
+   * component
+   * @param v_name name of the NetCDF variable who contains the second
+   * component, or an empty string to convert a scalar grid.
+   * @param unit Unit of the data stored. If the parameter contains an empty
+   * string, the data are stored in the unit of the NetCDF file and cannot be
+   * converted when they are loaded.
+   * @param target Path to the binary grid to create
+   */
+  static void Convert(const std::string &source, const std::string &u_name,
+                      const std::string &v_name, const std::string &unit,
+                      const std::string &target);
+
+ private:
+  /// Memory region mapping the file
+  std::shared_ptr<void> mapping_;
+
+  /// Values of the grid stored in the file
+  const double *values_{nullptr};
+
+  /// Names of the variables stored for each grid node
+  std::vector<std::string> variables_;
+
+  /// Unit of the values stored
+  std::string unit_;
+
+  /// Date of the grid, in microseconds elapsed since 1970
+  int64_t date_{0};
+
+  // Get the index of a variable stored
+  auto FindComponent(const std::string &name) const -> size_t;
+
+  // Get the grid containing the variables requested
+  auto Read(const std::vector<size_t> &components, const std::string &unit)
+      -> std::shared_ptr<const Grid>;
+};
+
+}  // namespace lagrangian::reader
@@ -17,6 +17,7 @@
 // ___________________________________________________________________________//
 
 #include "lagrangian/reader.hpp"
+#include "lagrangian/reader/binary.hpp"
 #include "lagrangian/reader/netcdf.hpp"
 
 // ___________________________________________________________________________//
@@ -32,18 +33,24 @@ class Factory {
    * @brief Type of fields reader known
    */
   enum Type {
-    kNetCDF  //!< kNetCDF
+    kNetCDF,  //!< kNetCDF
+    kBinary   //!< kBinary
   };
 
   /**
    * @brief Get an instance of a given reader
    * @param type %Reader type
+   * @param storage Type used to store the grids loaded into memory
    * @return An instance of a reader
    */
-  static auto NewReader(const Type type) -> Reader* {
+  static auto NewReader(const Type type,
+                        const Grid::Storage storage = Grid::kFloat64)
+      -> Reader* {
     switch (type) {
       case kNetCDF:
-        return new NetCDF();
+        return new NetCDF(storage);
+      case kBinary:
+        return new Binary(storage);
     }
     throw std::invalid_argument(
         "invalid lagrangian::reader::Factory::Type value");
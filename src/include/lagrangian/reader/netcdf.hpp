@@ -16,8 +16,15 @@
 
 // ___________________________________________________________________________//
 
+#include <array>
+#include <utility>
+#include <vector>
+
+// ___________________________________________________________________________//
+
 #include "lagrangian/axis.hpp"
 #include "lagrangian/datetime.hpp"
+#include "lagrangian/grid_cache.hpp"
 #include "lagrangian/netcdf.hpp"
 #include "lagrangian/reader.hpp"
 
@@ -56,13 +63,22 @@ namespace lagrangian::reader {
  *
  * @note: The variable to be read must set an attribute named "date" that
  * define the date of data contained in the variable.
+ *
+ * If a bounding box is defined, only the hyperslab of the variables covering
+ * this region is read and the axes of the grid are restricted to this
+ * hyperslab. If the region crosses the end of a longitude axis covering the
+ * whole circle, the two parts of the hyperslab located on either side of the
+ * end of the axis are read and joined.
  */
 class NetCDF : public Reader {
  public:
   /**
    * @brief Constructor
+   *
+   * @param storage Type used to store the grids loaded into memory
    */
-  NetCDF() : pGetIndex_(nullptr) {}
+  explicit NetCDF(const Grid::Storage storage = Grid::kFloat64)
+      : pGetIndex_(nullptr), storage_(storage) {}
 
   /**
    * Move constructor
@@ -88,6 +104,21 @@ class NetCDF : public Reader {
    */
   void Open(const std::string &filename) override;
 
+  /**
+   * @brief Restricts the grids read by the next calls to Open to the region
+   * [x_min, x_max] x [y_min, y_max]. The nodes surrounding the region are
+   * also read, so that the interpolation is defined on the whole region.
+   *
+   * @param x_min Minimum longitude in degrees
+   * @param x_max Maximum longitude in degrees
+   * @param y_min Minimum latitude in degrees
+   * @param y_max Maximum latitude in degrees
+   *
+   * @throw std::invalid_argument if the region is empty.
+   */
+  void SetBoundingBox(double x_min, double x_max, double y_min,
+                      double y_max) override;
+
   /**
    * @brief Load into memory grid data
    *
@@ -99,6 +130,22 @@ class NetCDF : public Reader {
    */
   void Load(const std::string &varname, const std::string &unit = "") override;
 
+  /**
+   * @brief Load into memory the two components of a vector field. The
+   * components are stored interleaved: the values of a grid node are read
+   * with a single memory access.
+   *
+   * @param u_name name of the NetCDF grid who contains the first component
+   * @param v_name name of the NetCDF grid who contains the second component
+   * @param unit Unit of data loaded into memory. If the parameter is
+   * undefined or contains an empty string, the object will not do unit
+   * conversion.
+   *
+   * @throw std::logic_error if the two grids do not have the same shape.
+   */
+  void LoadVector(const std::string &u_name, const std::string &v_name,
+                  const std::string &unit = "") override;
+
   /**
    * @brief Computes the value of the grid point requested by bilinear
    * interpolation
@@ -115,6 +162,100 @@ class NetCDF : public Reader {
                    CellProperties &cell = CellProperties::NONE()) const
       -> double override;
 
+  /**
+   * @brief Computes the values of a set of points by bilinear interpolation
+   *
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param result Interpolated values or fill_value if point is outside the
+   * grid.
+   * @param cell Cell properties of the grid used for the interpolation.
+   */
+  void InterpolateMany(size_t n, const double *longitude,
+                       const double *latitude, double fill_value,
+                       double *result, CellProperties &cell) const override;
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector by bilinear interpolation
+   *
+   * @param longitude Longitude in degrees
+   * @param latitude Latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component or fill_value if point is outside the grid.
+   * @param v Second component or fill_value if point is outside the grid.
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @throw std::logic_error if no vector field is loaded.
+   */
+  void InterpolateVector(double longitude, double latitude, double fill_value,
+                         double &u, double &v,
+                         CellProperties &cell) const override;
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector and their derivatives, given by the bilinear interpolation
+   * of the cell containing the point
+   *
+   * @param longitude Longitude in degrees
+   * @param latitude Latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component or fill_value if point is outside the grid.
+   * @param v Second component or fill_value if point is outside the grid.
+   * @param u_x Derivative of the first component along the longitude, or
+   * zero if point is outside the grid (NaN if fill_value is NaN).
+   * @param u_y Derivative of the first component along the latitude
+   * @param v_x Derivative of the second component along the longitude
+   * @param v_y Derivative of the second component along the latitude
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @throw std::logic_error if no vector field is loaded.
+   */
+  void InterpolateVectorGradient(double longitude, double latitude,
+                                 double fill_value, double &u, double &v,
+                                 double &u_x, double &u_y, double &v_x,
+                                 double &v_y,
+                                 CellProperties &cell) const override;
+
+  /**
+   * @brief Computes the two components of the vector field loaded by
+   * LoadVector for a set of points
+   *
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First components
+   * @param v Second components
+   * @param cell Cell properties of the grid used for the interpolation.
+   *
+   * @throw std::logic_error if no vector field is loaded.
+   */
+  void InterpolateVectorMany(size_t n, const double *longitude,
+                             const double *latitude, double fill_value,
+                             double *u, double *v,
+                             CellProperties &cell) const override;
+
+  /**
+   * @brief Creates a reader of the weighted mean of the grid loaded by this
+   * reader and of the grid loaded by another NetCDF reader on the same axes.
+   * The grid created is stored in double precision.
+   *
+   * @param other Reader of the second grid
+   * @param w0 Weight of the grid of this reader
+   * @param w1 Weight of the second grid
+   * @param fill_value Value to be taken into account for fill values
+   * @param pool Threads computing the grid
+   *
+   * @return The reader created, or nullptr if the other reader is not a
+   * NetCDF reader or if the grids are not defined on the same nodes.
+   */
+  [[nodiscard]] auto Blend(const Reader &other, double w0, double w1,
+                           double fill_value, ThreadPool &pool) const
+      -> std::unique_ptr<Reader> override;
+
   /**
    * @brief Returns the date of the grid.
    *
@@ -125,7 +266,7 @@ class NetCDF : public Reader {
   [[nodiscard]] auto GetDateTime(const std::string &name) const
       -> DateTime override;
 
- private:
+ protected:
   using GetIndex = size_t (NetCDF::*)(const double ix, const double iy) const;
 
   Axis axis_x_;
@@ -133,10 +274,52 @@ class NetCDF : public Reader {
 
   lagrangian::NetCDF netcdf_;
 
-  std::vector<double> data_;
+  /// Path to the file opened
+  std::string filename_;
+
+  /// Grid loaded into memory, shared with the other readers of the same data
+  std::shared_ptr<const Grid> data_;
 
   GetIndex pGetIndex_{nullptr};
 
+  /// Number of components stored for each grid node
+  size_t components_{1};
+
+  /// Type used to store the grids loaded into memory
+  Grid::Storage storage_{Grid::kFloat64};
+
+  /// Region read [x_min, x_max, y_min, y_max], if bounded_ is true
+  std::array<double, 4> bounding_box_{};
+  bool bounded_{false};
+
+  /// Number of nodes of the grid stored in the file along the Y axis
+  size_t ny_{0};
+
+  /// Hyperslab read: ranges [first, first + count) of the indexes along the X
+  /// axis (two ranges if the hyperslab crosses the end of the axis) and along
+  /// the Y axis. The whole grid is read if there is no range.
+  std::vector<std::pair<size_t, size_t>> x_ranges_;
+  std::pair<size_t, size_t> y_range_{0, 0};
+
+  // Computes the hyperslab covering the bounding box and restricts the axes
+  // to this hyperslab
+  void SelectRegion();
+
+  // Read the hyperslab of a variable, stored in the order of its dimensions
+  auto ReadRegion(const netcdf::Variable &variable,
+                  const std::string &unit) const -> std::vector<double>;
+
+  // Get the description of the hyperslab read, used to identify the grids
+  // in the cache
+  [[nodiscard]] auto RegionKey() const -> std::string;
+
+  // Get the function computing the index of a node of a variable
+  [[nodiscard]] auto GetIndexFunction(const netcdf::Variable &variable) const
+      -> GetIndex {
+    return variable.get_shape(0) == ny_ ? &NetCDF::GetIndexYX
+                                        : &NetCDF::GetIndexXY;
+  }
+
   // Search for a variable in the NetCDF file
   [[nodiscard]] auto FindVariable(const std::string &name) const
       -> netcdf::Variable {
@@ -163,12 +346,27 @@ class NetCDF : public Reader {
     return iy * axis_x_.GetNumElements() + ix;
   }
 
+  // Find the cell containing the point (x, y). Returns false if the point is
+  // outside the grid.
+  auto FindCell(double x, double y, CellProperties &cell) const -> bool;
+
   // Get the value of the cell [ix, iy] of the grid
   [[nodiscard]] inline auto GetValue(const int ix, const int iy,
                                      const double fill_value = 0) const noexcept
       -> double {
-    double result = data_[(this->*pGetIndex_)(ix, iy)];
-    return std::isnan(result) ? fill_value : result;
+    return Fill(data_->Get(GetNode(ix, iy)), fill_value);
+  }
+
+  // Get the index of the first component of the cell [ix, iy] of the grid
+  [[nodiscard]] inline auto GetNode(const int ix, const int iy) const noexcept
+      -> size_t {
+    return (this->*pGetIndex_)(ix, iy) * components_;
+  }
+
+  // Replace an undefined value by the fill value
+  static inline auto Fill(const double value, const double fill_value) noexcept
+      -> double {
+    return std::isnan(value) ? fill_value : value;
   }
 };
 
@@ -16,36 +16,451 @@
 
 // ___________________________________________________________________________//
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+// ___________________________________________________________________________//
+
 #include "lagrangian/field.hpp"
 #include "lagrangian/misc.hpp"
+#include "lagrangian/simd.hpp"
 
 // ___________________________________________________________________________//
 
 namespace lagrangian {
 
+namespace coordinates {
+
 /**
- * @brief Fourth-order Runge-Kutta method
+ * @brief Displacement of the points in a cartesian space, or in a spherical
+ * equatorial space when the velocities are angular.
+ */
+struct Cartesian {
+  /**
+   * @brief Move a point
+   *
+   * @param t Duration of the move in seconds
+   * @param x0 Initial abscissa
+   * @param y0 Initial ordinate
+   * @param u Velocity along the abscissa
+   * @param v Velocity along the ordinate
+   * @param x1 Abscissa after the move
+   * @param y1 Ordinate after the move
+   */
+  static inline void Move(const double t, const double x0, const double y0,
+                          const double u, const double v, double &x1,
+                          double &y1) {
+    x1 = x0 + u * t;
+    y1 = y0 + v * t;
+  }
+
+  /**
+   * @brief Move a set of points
+   *
+   * @param t Duration of the move in seconds
+   * @param n Number of points
+   * @param x0 Initial abscissas
+   * @param y0 Initial ordinates
+   * @param u Velocities along the abscissa
+   * @param v Velocities along the ordinate
+   * @param x1 Abscissas after the move
+   * @param y1 Ordinates after the move
+   */
+  static inline void MoveMany(const double t, const size_t n,
+                              const double *const x0, const double *const y0,
+                              const double *const u, const double *const v,
+                              double *const x1, double *const y1) {
+    const auto last = simd::VectorizableSize(n);
+    const auto vt = simd::Set(t);
+    size_t ix = 0;
+
+    for (; ix < last; ix += simd::kWidth) {
+      simd::Store(x1 + ix, simd::Add(simd::Load(x0 + ix),
+                                     simd::Mul(simd::Load(u + ix), vt)));
+      simd::Store(y1 + ix, simd::Add(simd::Load(y0 + ix),
+                                     simd::Mul(simd::Load(v + ix), vt)));
+    }
+    for (; ix < n; ++ix) {
+      Move(t, x0[ix], y0[ix], u[ix], v[ix], x1[ix], y1[ix]);
+    }
+  }
+
+  /**
+   * @brief Jacobian of the displacement of a point per unit of time: the
+   * jacobian of the velocity
+   *
+   * @param y Ordinate of the point
+   * @param u Velocity along the abscissa
+   * @param u_x Derivative of u along the abscissa
+   * @param u_y Derivative of u along the ordinate
+   * @param v_x Derivative of v along the abscissa
+   * @param v_y Derivative of v along the ordinate
+   * @param a Jacobian {a00, a01, a10, a11} in row-major order
+   */
+  static inline void Jacobian(const double /*y*/, const double /*u*/,
+                              const double u_x, const double u_y,
+                              const double v_x, const double v_y,
+                              double *const a) {
+    a[0] = u_x;
+    a[1] = u_y;
+    a[2] = v_x;
+    a[3] = v_y;
+  }
+};
+
+/**
+ * @brief Displacement of the points in a spherical equatorial space, the
+ * velocities being expressed in the metric system.
+ */
+struct SphericalEquatorial {
+  /**
+   * @brief Move a point
+   *
+   * @param t Duration of the move in seconds
+   * @param x0 Initial longitude in degrees
+   * @param y0 Initial latitude in degrees
+   * @param u Eastward velocity in m/s
+   * @param v Northward velocity in m/s
+   * @param x1 Longitude after the move
+   * @param y1 Latitude after the move
+   */
+  static inline void Move(const double t, const double x0, const double y0,
+                          const double u, const double v, double &x1,
+                          double &y1) {
+    const double xr = DegreesToRadians(x0);
+    const double yr = DegreesToRadians(y0);
+    const double sin_x = sin(xr);
+    const double cos_x = cos(xr);
+    const double sin_y = sin(yr);
+    const double cos_y = cos(yr);
+
+    double x = kEarthRadius * cos_y * cos_x;
+    double y = kEarthRadius * cos_y * sin_x;
+    double z = kEarthRadius * sin_y;
+
+    x += (-u * sin_x - v * cos_x * sin_y) * t;
+    y += (u * cos_x - v * sin_y * sin_x) * t;
+    z += (v * cos_y) * t;
+
+    x1 = RadiansToDegrees(atan2(y, x));
+    y1 = RadiansToDegrees(asin(z / sqrt(x * x + y * y + z * z)));
+  }
+
+  /**
+   * @brief Move a set of points
+   *
+   * @see Cartesian::MoveMany
+   */
+  static inline void MoveMany(const double t, const size_t n,
+                              const double *const x0, const double *const y0,
+                              const double *const u, const double *const v,
+                              double *const x1, double *const y1) {
+    for (size_t ix = 0; ix < n; ++ix) {
+      Move(t, x0[ix], y0[ix], u[ix], v[ix], x1[ix], y1[ix]);
+    }
+  }
+
+  /**
+   * @brief Jacobian of the displacement of a point per unit of time, the
+   * point moving by (u / (R cos y), v / R) radians per unit of time.
+   *
+   * @see Cartesian::Jacobian
+   */
+  static inline void Jacobian(const double y, const double u,
+                              const double u_x, const double u_y,
+                              const double v_x, const double v_y,
+                              double *const a) {
+    const double scale = RadiansToDegrees(1 / kEarthRadius);
+    const double yr = DegreesToRadians(y);
+    const double sec_y = 1 / cos(yr);
+
+    a[0] = scale * u_x * sec_y;
+    a[1] = scale * sec_y * (u_y + DegreesToRadians(u * tan(yr)));
+    a[2] = scale * v_x;
+    a[3] = scale * v_y;
+  }
+};
+
+/**
+ * @brief Displacement of the points in a spherical equatorial space, the
+ * velocities being expressed in the metric system, computed without
+ * trigonometric function.
+ *
+ * The displacement (u t, v t) is applied in the local frame of the initial
+ * position of the point (radial, east and north directions): the increments
+ * of longitude and latitude are the arctangents of the ratios
+ *
+ * <PRE>
+ * p = u t / (R cos y - v t sin y)
+ * q = (v t - e sin y) / (R + e cos y), e = √(X² + (u t)²) - X
+ * </PRE>
+ *
+ * where X = R cos y - v t sin y. The sine and the cosine of the initial
+ * latitude and the arctangents are evaluated by Taylor polynomials whose
+ * truncation error is lower than 1e-17 relative for latitudes in [-90, 90]
+ * and ratios in [-1/8, 1/8]: the positions are those of SphericalEquatorial
+ * up to the rounding errors. MoveMany evaluates the polynomials with the
+ * vector instructions (see simd.hpp). The points outside this domain
+ * (displacements of more than R / 8 or crossing a pole) are moved by
+ * SphericalEquatorial.
+ */
+struct FastSphericalEquatorial {
+  /**
+   * @brief Move a point
+   *
+   * @see SphericalEquatorial::Move
+   */
+  static inline void Move(const double t, const double x0, const double y0,
+                          const double u, const double v, double &x1,
+                          double &y1) {
+    MoveMany(t, 1, &x0, &y0, &u, &v, &x1, &y1);
+  }
+
+  /**
+   * @brief Move a set of points
+   *
+   * @see Cartesian::MoveMany
+   */
+  static inline void MoveMany(const double t, const size_t n,
+                              const double *const x0, const double *const y0,
+                              const double *const u, const double *const v,
+                              double *const x1, double *const y1) {
+    // Latitudes and displacements of the points, padded to a multiple of the
+    // width of the vectors, then ratios p and q and their arctangents.
+    double lat[kChunkSize];
+    double du[kChunkSize];
+    double dv[kChunkSize];
+    double p[kChunkSize];
+    double q[kChunkSize];
+
+    for (size_t first = 0; first < n; first += kChunkSize) {
+      const auto size = std::min(kChunkSize, n - first);
+      const auto padded = simd::VectorizableSize(size + simd::kWidth - 1);
+
+      for (size_t ix = 0; ix < padded; ++ix) {
+        const auto inside = ix < size;
+        lat[ix] = inside ? y0[first + ix] : 0;
+        du[ix] = inside ? u[first + ix] * t : 0;
+        dv[ix] = inside ? v[first + ix] * t : 0;
+      }
+      for (size_t ix = 0; ix < padded; ix += simd::kWidth) {
+        const auto y = simd::Mul(simd::Load(lat + ix),
+                                 simd::Set(DegreesToRadians(1)));
+        const auto sin_y = Sin(y);
+        const auto cos_y = Sin(simd::Sub(simd::Set(M_PI / 2), simd::Abs(y)));
+        const auto a = simd::Load(du + ix);
+        const auto b = simd::Load(dv + ix);
+        const auto radius = simd::Set(kEarthRadius);
+
+        // A point crossing a pole (X <= 0) gives an infinite ratio p.
+        const auto x = simd::Sub(simd::Mul(radius, cos_y), simd::Mul(b, sin_y));
+        const auto ratio_x = simd::Div(a, simd::Max(x, simd::Set(0)));
+        const auto e = simd::Div(
+            simd::Mul(a, a),
+            simd::Add(simd::Sqrt(simd::Add(simd::Mul(x, x), simd::Mul(a, a))),
+                      x));
+        const auto ratio_y = simd::Div(simd::Sub(b, simd::Mul(e, sin_y)),
+                                       simd::Add(radius, simd::Mul(e, cos_y)));
+        simd::Store(p + ix, ratio_x);
+        simd::Store(q + ix, ratio_y);
+        simd::Store(du + ix, Atan(ratio_x));
+        simd::Store(dv + ix, Atan(ratio_y));
+      }
+      for (size_t ix = 0; ix < size; ++ix) {
+        const auto jx = first + ix;
+        if (std::abs(p[ix]) <= kMaxRatio && std::abs(q[ix]) <= kMaxRatio &&
+            std::abs(lat[ix]) <= 90) {
+          x1[jx] = NormalizeLongitude(x0[jx] + RadiansToDegrees(du[ix]), 360,
+                                      180);
+          y1[jx] = std::max(
+              -90.0, std::min(90.0, lat[ix] + RadiansToDegrees(dv[ix])));
+        } else {
+          SphericalEquatorial::Move(t, x0[jx], lat[ix], u[jx], v[jx], x1[jx],
+                                    y1[jx]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Jacobian of the displacement of a point per unit of time
+   *
+   * @see SphericalEquatorial::Jacobian
+   */
+  static inline void Jacobian(const double y, const double u,
+                              const double u_x, const double u_y,
+                              const double v_x, const double v_y,
+                              double *const a) {
+    SphericalEquatorial::Jacobian(y, u, u_x, u_y, v_x, v_y, a);
+  }
+
+ private:
+  /// Number of points processed at once by MoveMany
+  static constexpr size_t kChunkSize = 64;
+
+  /// Largest ratio whose arctangent is evaluated by the polynomial
+  static constexpr double kMaxRatio = 0.125;
+
+  // Sine of x in [-π/2, π/2]: x Σ (-x²)ᵏ / (2k + 1)!, k = 0 to 10
+  static inline auto Sin(const simd::Vector x) -> simd::Vector {
+    constexpr double kCoefficients[] = {
+        1.0 / 2.0 / 3.0,   1.0 / 4.0 / 5.0,   1.0 / 6.0 / 7.0,
+        1.0 / 8.0 / 9.0,   1.0 / 10.0 / 11.0, 1.0 / 12.0 / 13.0,
+        1.0 / 14.0 / 15.0, 1.0 / 16.0 / 17.0, 1.0 / 18.0 / 19.0,
+        1.0 / 20.0 / 21.0};
+    const auto x2 = simd::Mul(x, x);
+    auto result = simd::Set(1);
+
+    // Horner scheme of the nested form 1 - x²/(2·3) (1 - x²/(4·5) (...))
+    for (size_t ix = std::size(kCoefficients); ix-- > 0;) {
+      result = simd::Sub(
+          simd::Set(1),
+          simd::Mul(simd::Mul(x2, simd::Set(kCoefficients[ix])), result));
+    }
+    return simd::Mul(x, result);
+  }
+
+  // Arctangent of x in [-1/8, 1/8]: x Σ (-x²)ᵏ / (2k + 1), k = 0 to 8
+  static inline auto Atan(const simd::Vector x) -> simd::Vector {
+    constexpr double kCoefficients[] = {
+        1.0,        -1.0 / 3.0,  1.0 / 5.0,  -1.0 / 7.0, 1.0 / 9.0,
+        -1.0 / 11.0, 1.0 / 13.0, -1.0 / 15.0, 1.0 / 17.0};
+    const auto x2 = simd::Mul(x, x);
+    auto result = simd::Set(kCoefficients[std::size(kCoefficients) - 1]);
+
+    for (size_t ix = std::size(kCoefficients) - 1; ix-- > 0;) {
+      result = simd::Add(simd::Set(kCoefficients[ix]), simd::Mul(x2, result));
+    }
+    return simd::Mul(x, result);
+  }
+};
+
+/**
+ * @brief Displacement of the points in the space of a field known at run
+ * time.
+ */
+class Dynamic {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param field Field moving the points
+   * @param fast_spherical True to move the points in a spherical equatorial
+   * space with FastSphericalEquatorial instead of SphericalEquatorial
+   */
+  explicit Dynamic(const Field &field, const bool fast_spherical = false) {
+    if (field.get_unit_type() == Field::kMetric &&
+        field.get_coordinates_type() == Field::kSphericalEquatorial) {
+      if (fast_spherical) {
+        pMove_ = &FastSphericalEquatorial::Move;
+        pMoveMany_ = &FastSphericalEquatorial::MoveMany;
+      } else {
+        pMove_ = &SphericalEquatorial::Move;
+        pMoveMany_ = &SphericalEquatorial::MoveMany;
+      }
+      pJacobian_ = &SphericalEquatorial::Jacobian;
+    } else {
+      pMove_ = &Cartesian::Move;
+      pMoveMany_ = &Cartesian::MoveMany;
+      pJacobian_ = &Cartesian::Jacobian;
+    }
+  }
+
+  /**
+   * @brief Move a point
+   *
+   * @see Cartesian::Move
+   */
+  inline void Move(const double t, const double x0, const double y0,
+                   const double u, const double v, double &x1,
+                   double &y1) const {
+    (*pMove_)(t, x0, y0, u, v, x1, y1);
+  }
+
+  /**
+   * @brief Move a set of points
+   *
+   * @see Cartesian::MoveMany
+   */
+  inline void MoveMany(const double t, const size_t n, const double *const x0,
+                       const double *const y0, const double *const u,
+                       const double *const v, double *const x1,
+                       double *const y1) const {
+    (*pMoveMany_)(t, n, x0, y0, u, v, x1, y1);
+  }
+
+  /**
+   * @brief Jacobian of the displacement of a point per unit of time
+   *
+   * @see Cartesian::Jacobian
+   */
+  inline void Jacobian(const double y, const double u, const double u_x,
+                       const double u_y, const double v_x, const double v_y,
+                       double *const a) const {
+    (*pJacobian_)(y, u, u_x, u_y, v_x, v_y, a);
+  }
+
+ private:
+  using MoveFunction = void (*)(const double t, const double x, const double y,
+                                const double u, const double v, double &xi,
+                                double &yi);
+
+  using MoveManyFunction = void (*)(const double t, const size_t n,
+                                    const double *const x0,
+                                    const double *const y0,
+                                    const double *const u,
+                                    const double *const v, double *const x1,
+                                    double *const y1);
+
+  using JacobianFunction = void (*)(const double y, const double u,
+                                    const double u_x, const double u_y,
+                                    const double v_x, const double v_y,
+                                    double *const a);
+
+  MoveFunction pMove_;
+  MoveManyFunction pMoveMany_;
+  JacobianFunction pJacobian_;
+};
+
+}  // namespace coordinates
+
+/**
+ * @brief Fourth-order Runge-Kutta method moving the points of a field of
+ * type FieldType in the space described by Space (see the classes of the
+ * namespace coordinates).
+ *
+ * When the type of the field is a final class and the space is known at
+ * compile time, the evaluations of the field and the moves of the points
+ * are resolved statically and can be inlined.
  */
-class RungeKutta {
+template <typename FieldType, typename Space>
+class BasicRungeKutta {
  public:
   /**
    * @brief Default constructor
    *
    * @param size_of_interval Number of time interval
    * @param field Field reader
+   * @param space Space in which the points are moved
    */
-  RungeKutta(const double size_of_interval, const Field *const field)
-      : h_(size_of_interval), h_2_(h_ / 2), h_6_(h_ / 6), field_(field) {
-    switch (field_->get_unit_type()) {
-      case Field::kAngular:
-        pMove_ = &RungeKutta::MoveCartesian;
-        break;
-      case Field::kMetric:
-        pMove_ = field_->get_coordinates_type() == Field::kSphericalEquatorial
-                     ? &RungeKutta::MoveSphericalEquatorial
-                     : &RungeKutta::MoveCartesian;
-        break;
-    }
+  BasicRungeKutta(const double size_of_interval, const FieldType *const field,
+                  const Space space = Space())
+      : h_(size_of_interval),
+        h_2_(h_ / 2),
+        h_6_(h_ / 6),
+        field_(field),
+        space_(space) {}
+
+  /**
+   * @brief Get the time step of the method
+   *
+   * @return The time step in seconds, negative for a backward integration
+   */
+  [[nodiscard]] inline auto get_size_of_interval() const -> double {
+    return h_;
   }
 
   /**
@@ -78,20 +493,20 @@ class RungeKutta {
     // If asked position is not defined in the field (The method "Compute"
     // returns false): the computation is finished
     if (field_->Compute(t, x, y, u1, v1, cell)) {
-      (this->pMove_)(h_2_, x, y, u1, v1, xn, yn);
+      space_.Move(h_2_, x, y, u1, v1, xn, yn);
 
       // RK step 2
       if (field_->Compute(t + h_2_, xn, yn, u2, v2, cell)) {
-        (this->pMove_)(h_2_, x, y, u2, v2, xn, yn);
+        space_.Move(h_2_, x, y, u2, v2, xn, yn);
 
         // RK step 3
         if (field_->Compute(t + h_2_, xn, yn, u3, v3, cell)) {
-          (this->pMove_)(h_, x, y, u3, v3, xn, yn);
+          space_.Move(h_, x, y, u3, v3, xn, yn);
 
           // RK step 4
           if (field_->Compute(t + h_, xn, yn, u4, v4, cell)) {
-            (this->pMove_)(h_6_, x, y, u1 + 2 * (u2 + u3) + u4,
-                           v1 + 2 * (v2 + v3) + v4, xi, yi);
+            space_.Move(h_6_, x, y, u1 + 2 * (u2 + u3) + u4,
+                        v1 + 2 * (v2 + v3) + v4, xi, yi);
             return true;
           }
         }
@@ -100,49 +515,217 @@ class RungeKutta {
     return false;
   }
 
+  /**
+   * @brief Move a point in a field together with the gradient of the flow
+   * map: the variational equation dG/dt = A(t, x, y) G, where A is the
+   * jacobian of the velocity, is integrated by the same Runge-Kutta steps as
+   * the position.
+   *
+   * @param t Time in number of seconds elapsed since 1970
+   * @param x Longitude in degrees
+   * @param y Latitude in degrees
+   * @param xi Longitude after the move
+   * @param yi Latitude after the move
+   * @param g Gradient of the flow map {g00, g01, g10, g11}, in row-major
+   * order, updated by the move.
+   * @param cell Cell properties of the grid used for the interpolation
+   * @return True if the point and the gradient could be moved
+   */
+  inline auto ComputeVariational(const double t, const double x,
+                                 const double y, double &xi, double &yi,
+                                 double *const g,
+                                 CellProperties &cell = CellProperties::NONE())
+      const -> bool {
+    // Time and step of the four stages of the method
+    const double dt[] = {0, h_2_, h_2_, h_};
+    const double weight[] = {1, 2, 2, 1};
+    double u[4];
+    double v[4];
+    double a[4];
+    double k[4] = {0, 0, 0, 0};
+    double sum[4] = {0, 0, 0, 0};
+    double xn = x;
+    double yn = y;
+
+    for (size_t stage = 0; stage < 4; ++stage) {
+      double u_x;
+      double u_y;
+      double v_x;
+      double v_y;
+
+      if (!field_->ComputeGradient(t + dt[stage], xn, yn, u[stage], v[stage],
+                                   u_x, u_y, v_x, v_y, cell)) {
+        return false;
+      }
+      space_.Jacobian(yn, u[stage], u_x, u_y, v_x, v_y, a);
+
+      // K = A (G + dt K), K being the slope of the previous stage
+      const double g00 = g[0] + dt[stage] * k[0];
+      const double g01 = g[1] + dt[stage] * k[1];
+      const double g10 = g[2] + dt[stage] * k[2];
+      const double g11 = g[3] + dt[stage] * k[3];
+      k[0] = a[0] * g00 + a[1] * g10;
+      k[1] = a[0] * g01 + a[1] * g11;
+      k[2] = a[2] * g00 + a[3] * g10;
+      k[3] = a[2] * g01 + a[3] * g11;
+      for (size_t ix = 0; ix < 4; ++ix) {
+        sum[ix] += weight[stage] * k[ix];
+      }
+
+      if (stage < 3) {
+        space_.Move(dt[stage + 1], x, y, u[stage], v[stage], xn, yn);
+      }
+    }
+    space_.Move(h_6_, x, y, u[0] + 2 * (u[1] + u[2]) + u[3],
+                v[0] + 2 * (v[1] + v[2]) + v[3], xi, yi);
+    for (size_t ix = 0; ix < 4; ++ix) {
+      g[ix] += h_6_ * sum[ix];
+    }
+    return true;
+  }
+
+  /**
+   * @brief Move a set of points in a field
+   *
+   * The points are processed by blocks: each step of the method evaluates
+   * the field for all the points of the block at once.
+   *
+   * @param t Time in number of seconds elapsed since 1970
+   * @param n Number of points
+   * @param x Longitudes in degrees
+   * @param y Latitudes in degrees
+   * @param xi Longitudes after the move, set to NaN if the point could not
+   * be moved.
+   * @param yi Latitudes after the move, set to NaN if the point could not be
+   * moved.
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  inline void ComputeMany(const double t, const size_t n,
+                          const double *const x, const double *const y,
+                          double *const xi, double *const yi,
+                          CellProperties &cell = CellProperties::NONE()) const {
+    double u1[kBlockSize];
+    double u2[kBlockSize];
+    double u3[kBlockSize];
+    double u4[kBlockSize];
+    double v1[kBlockSize];
+    double v2[kBlockSize];
+    double v3[kBlockSize];
+    double v4[kBlockSize];
+    double xn[kBlockSize];
+    double yn[kBlockSize];
+
+    for (size_t first = 0; first < n; first += kBlockSize) {
+      const auto size = std::min(kBlockSize, n - first);
+      const auto *const x0 = x + first;
+      const auto *const y0 = y + first;
+
+      // RK step 1
+      Evaluate(t, size, x0, y0, u1, v1, cell);
+      Move(h_2_, size, x0, y0, u1, v1, xn, yn);
+
+      // RK step 2
+      Evaluate(t + h_2_, size, xn, yn, u2, v2, cell);
+      Move(h_2_, size, x0, y0, u2, v2, xn, yn);
+
+      // RK step 3
+      Evaluate(t + h_2_, size, xn, yn, u3, v3, cell);
+      Move(h_, size, x0, y0, u3, v3, xn, yn);
+
+      // RK step 4
+      Evaluate(t + h_, size, xn, yn, u4, v4, cell);
+
+      // The undefined velocities are propagated to the final position.
+      Sum(size, u1, u2, u3, u4);
+      Sum(size, v1, v2, v3, v4);
+      space_.MoveMany(h_6_, size, x0, y0, u1, v1, xi + first, yi + first);
+    }
+  }
+
  private:
+  /// Number of points moved at once by ComputeMany
+  static constexpr size_t kBlockSize = 64;
+
   double h_;
   double h_2_;
   double h_6_;
-  const Field *const field_;
-
-  using MoveFunction = void (*)(const double t, const double x, const double y,
-                                const double u, const double v, double &xi,
-                                double &yi);
+  const FieldType *field_;
+  Space space_;
 
-  MoveFunction pMove_;
-
-  // Move a point in a cartesian space
-  static inline void MoveCartesian(const double t, const double x0,
-                                   const double y0, const double u,
-                                   const double v, double &x1, double &y1) {
-    x1 = x0 + u * t;
-    y1 = y0 + v * t;
+  // Evaluate the field for a set of points. If the type of the field is
+  // final and does not implement its own ComputeMany, the points are
+  // evaluated by a loop that the compiler can inline.
+  inline void Evaluate(const double t, const size_t n, const double *const x,
+                       const double *const y, double *const u,
+                       double *const v, CellProperties &cell) const {
+    if constexpr (std::is_final_v<FieldType> &&
+                  std::is_same_v<decltype(&FieldType::ComputeMany),
+                                 decltype(&Field::ComputeMany)>) {
+      for (size_t ix = 0; ix < n; ++ix) {
+        if (!field_->Compute(t, x[ix], y[ix], u[ix], v[ix], cell)) {
+          u[ix] = v[ix] = std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    } else {
+      field_->ComputeMany(t, n, x, y, u, v, cell);
+    }
   }
 
-  // Move a point in a field in a spherical equatorial space
-  static inline void MoveSphericalEquatorial(const double t, const double x0,
-                                             const double y0, const double u,
-                                             const double v, double &x1,
-                                             double &y1) {
-    const double xr = DegreesToRadians(x0);
-    const double yr = DegreesToRadians(y0);
-    const double sin_x = sin(xr);
-    const double cos_x = cos(xr);
-    const double sin_y = sin(yr);
-    const double cos_y = cos(yr);
-
-    double x = kEarthRadius * cos_y * cos_x;
-    double y = kEarthRadius * cos_y * sin_x;
-    double z = kEarthRadius * sin_y;
+  // Move a set of points to the intermediate positions of the method. The
+  // points whose velocity is undefined stay at their initial position so
+  // that the field can still be evaluated at the next step.
+  inline void Move(const double t, const size_t n, const double *const x0,
+                   const double *const y0, const double *const u,
+                   const double *const v, double *const x1,
+                   double *const y1) const {
+    space_.MoveMany(t, n, x0, y0, u, v, x1, y1);
+    for (size_t ix = 0; ix < n; ++ix) {
+      if (std::isnan(x1[ix]) || std::isnan(y1[ix])) {
+        x1[ix] = x0[ix];
+        y1[ix] = y0[ix];
+      }
+    }
+  }
 
-    x += (-u * sin_x - v * cos_x * sin_y) * t;
-    y += (u * cos_x - v * sin_y * sin_x) * t;
-    z += (v * cos_y) * t;
+  // Weighted sum of the slopes: a1 + 2 * (a2 + a3) + a4, stored in a1
+  static inline void Sum(const size_t n, double *const a1,
+                         const double *const a2, const double *const a3,
+                         const double *const a4) {
+    const auto last = simd::VectorizableSize(n);
+    size_t ix = 0;
 
-    x1 = RadiansToDegrees(atan2(y, x));
-    y1 = RadiansToDegrees(asin(z / sqrt(x * x + y * y + z * z)));
+    for (; ix < last; ix += simd::kWidth) {
+      simd::Store(
+          a1 + ix,
+          simd::Add(simd::Add(simd::Load(a1 + ix),
+                              simd::Mul(simd::Set(2),
+                                        simd::Add(simd::Load(a2 + ix),
+                                                  simd::Load(a3 + ix)))),
+                    simd::Load(a4 + ix)));
+    }
+    for (; ix < n; ++ix) {
+      a1[ix] = a1[ix] + 2 * (a2[ix] + a3[ix]) + a4[ix];
+    }
   }
 };
 
+/**
+ * @brief Fourth-order Runge-Kutta method
+ */
+class RungeKutta : public BasicRungeKutta<Field, coordinates::Dynamic> {
+ public:
+  /**
+   * @brief Default constructor
+   *
+   * @param size_of_interval Number of time interval
+   * @param field Field reader
+   * @param fast_spherical True to move the points in a spherical equatorial
+   * space with coordinates::FastSphericalEquatorial
+   */
+  RungeKutta(const double size_of_interval, const Field *const field,
+             const bool fast_spherical = false)
+      : BasicRungeKutta(size_of_interval, field,
+                        coordinates::Dynamic(*field, fast_spherical)) {}
+};
+
 }  // namespace lagrangian
@@ -0,0 +1,133 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ___________________________________________________________________________//
+
+/**
+ * @brief Minimal set of operations on packed doubles used by the batched
+ * kernels.
+ *
+ * The instruction set is selected at compile time: AVX-512 if the compiler
+ * targets it (e.g. -mavx512f or -march=native), otherwise AVX2, otherwise a
+ * scalar fallback processing one value at a time. A kernel processes the
+ * items [0, n - n % kWidth) with these operations and the remaining items
+ * with scalar code.
+ */
+namespace lagrangian::simd {
+
+#if defined(__AVX512F__)
+
+/// Number of doubles stored in a vector
+constexpr size_t kWidth = 8;
+
+/// Packed doubles
+using Vector = __m512d;
+
+inline auto Load(const double *p) -> Vector { return _mm512_loadu_pd(p); }
+inline void Store(double *p, const Vector a) { _mm512_storeu_pd(p, a); }
+inline auto Set(const double a) -> Vector { return _mm512_set1_pd(a); }
+inline auto Add(const Vector a, const Vector b) -> Vector {
+  return _mm512_add_pd(a, b);
+}
+inline auto Sub(const Vector a, const Vector b) -> Vector {
+  return _mm512_sub_pd(a, b);
+}
+inline auto Mul(const Vector a, const Vector b) -> Vector {
+  return _mm512_mul_pd(a, b);
+}
+inline auto Div(const Vector a, const Vector b) -> Vector {
+  return _mm512_div_pd(a, b);
+}
+inline auto Max(const Vector a, const Vector b) -> Vector {
+  return _mm512_max_pd(a, b);
+}
+inline auto Abs(const Vector a) -> Vector { return _mm512_abs_pd(a); }
+inline auto Sqrt(const Vector a) -> Vector { return _mm512_sqrt_pd(a); }
+
+#elif defined(__AVX2__)
+
+/// Number of doubles stored in a vector
+constexpr size_t kWidth = 4;
+
+/// Packed doubles
+using Vector = __m256d;
+
+inline auto Load(const double *p) -> Vector { return _mm256_loadu_pd(p); }
+inline void Store(double *p, const Vector a) { _mm256_storeu_pd(p, a); }
+inline auto Set(const double a) -> Vector { return _mm256_set1_pd(a); }
+inline auto Add(const Vector a, const Vector b) -> Vector {
+  return _mm256_add_pd(a, b);
+}
+inline auto Sub(const Vector a, const Vector b) -> Vector {
+  return _mm256_sub_pd(a, b);
+}
+inline auto Mul(const Vector a, const Vector b) -> Vector {
+  return _mm256_mul_pd(a, b);
+}
+inline auto Div(const Vector a, const Vector b) -> Vector {
+  return _mm256_div_pd(a, b);
+}
+inline auto Max(const Vector a, const Vector b) -> Vector {
+  return _mm256_max_pd(a, b);
+}
+inline auto Abs(const Vector a) -> Vector {
+  return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+}
+inline auto Sqrt(const Vector a) -> Vector { return _mm256_sqrt_pd(a); }
+
+#else
+
+/// Number of doubles stored in a vector
+constexpr size_t kWidth = 1;
+
+/// Packed doubles
+using Vector = double;
+
+inline auto Load(const double *p) -> Vector { return *p; }
+inline void Store(double *p, const Vector a) { *p = a; }
+inline auto Set(const double a) -> Vector { return a; }
+inline auto Add(const Vector a, const Vector b) -> Vector { return a + b; }
+inline auto Sub(const Vector a, const Vector b) -> Vector { return a - b; }
+inline auto Mul(const Vector a, const Vector b) -> Vector { return a * b; }
+inline auto Div(const Vector a, const Vector b) -> Vector { return a / b; }
+inline auto Max(const Vector a, const Vector b) -> Vector {
+  return a > b ? a : b;
+}
+inline auto Abs(const Vector a) -> Vector { return std::abs(a); }
+inline auto Sqrt(const Vector a) -> Vector { return std::sqrt(a); }
+
+#endif
+
+/**
+ * @brief Get the number of items that can be processed with vectors
+ *
+ * @param n Number of items
+ * @return n rounded down to a multiple of kWidth
+ */
+constexpr auto VectorizableSize(const size_t n) -> size_t {
+  return n - n % kWidth;
+}
+
+}  // namespace lagrangian::simd
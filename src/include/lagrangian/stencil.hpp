@@ -16,9 +16,10 @@
 
 // ___________________________________________________________________________//
 
+#include <array>
 #include <limits>
 #include <stdexcept>
-#include <vector>
+#include <type_traits>
 
 // ___________________________________________________________________________//
 
@@ -84,6 +85,9 @@ class Iterator {
 
 // ___________________________________________________________________________//
 
+/// Maximum number of points of a stencil
+constexpr size_t kMaxStencilSize = 5;
+
 /**
  * @brief Define the position of N points Mᵢ = (xᵢ, yᵢ)
  *
@@ -94,6 +98,9 @@ class Iterator {
  *            |
  *            Mᵢ
  * </PRE>
+ *
+ * The points are stored in fixed-size arrays: moving a stencil does not
+ * allocate memory.
  */
 class Position {
  public:
@@ -116,6 +123,7 @@ class Position {
    */
   explicit Position(const double start_time, const bool spherical_equatorial)
       : time_(start_time),
+        spherical_equatorial_(spherical_equatorial),
         pDistance_(spherical_equatorial ? &GeodeticDistance : &Distance) {}
 
   /**
@@ -142,7 +150,7 @@ class Position {
    *
    * @return The number of positions
    */
-  [[nodiscard]] inline auto size() const -> size_t { return x_.size(); }
+  [[nodiscard]] inline auto size() const -> size_t { return size_; }
 
   /**
    * @brief Get the longitude of the point \#idx
@@ -150,7 +158,7 @@ class Position {
    * @return The longitude in degrees
    */
   [[nodiscard]] inline auto get_xi(const size_t idx) const -> double {
-    return x_.at(idx);
+    return x_[idx];
   }
 
   /**
@@ -159,7 +167,7 @@ class Position {
    * @return The latitude in degrees
    */
   [[nodiscard]] inline auto get_yi(const size_t idx) const -> double {
-    return y_.at(idx);
+    return y_[idx];
   }
 
   /**
@@ -184,17 +192,14 @@ class Position {
   /**
    * @brief Set the instance to represent a missing position.
    */
-  inline void Missing() {
-    x_.clear();
-    y_.clear();
-  }
+  inline void Missing() { size_ = 0; }
 
   /**
    * @brief Test if the integration is defined.
    *
    * @return True if the integration is defined.
    */
-  inline auto IsMissing() -> bool { return x_.empty() && y_.empty(); }
+  inline auto IsMissing() -> bool { return size_ == 0; }
 
   /**
    * @brief Compute the distance max
@@ -204,7 +209,7 @@ class Position {
   [[nodiscard]] inline auto MaxDistance() const -> double {
     double result = 0;
 
-    for (size_t idx = 1; idx < x_.size(); ++idx) {
+    for (size_t idx = 1; idx < size_; ++idx) {
       double distance = (*pDistance_)(x_[0], y_[0], x_[idx], y_[idx]);
       if (distance > result) {
         result = distance;
@@ -213,6 +218,21 @@ class Position {
     return result;
   }
 
+  /**
+   * @brief Test if the distance max exceeds a threshold. The distance max is
+   * computed only if the fast test of the threshold does not exclude it.
+   *
+   * @param threshold Threshold tested
+   *
+   * @return MaxDistance() > threshold.distance()
+   */
+  [[nodiscard]] inline auto MaxDistanceExceeds(
+      const DistanceThreshold &threshold) const -> bool {
+    return threshold.MayBeExceeded(x_.data(), y_.data(), size_, 1,
+                                   spherical_equatorial_) &&
+           MaxDistance() > threshold.distance();
+  }
+
   /**
    * @brief To move a particle with a velocity field.
    *
@@ -224,30 +244,55 @@ class Position {
    */
   auto Compute(const RungeKutta &rk, const Iterator &it, CellProperties &cell)
       -> bool {
-    std::vector<double> x(x_.size());
-    std::vector<double> y(y_.size());
+    if (variational_) {
+      return ComputeVariational(rk, it, cell);
+    }
+
+    std::array<double, kMaxStencilSize> x;
+    std::array<double, kMaxStencilSize> y;
 
-    for (size_t ix = 0; ix < x_.size(); ++ix) {
-      if (!rk.Compute(it(), x_.at(ix), y_.at(ix), x[ix], y[ix], cell)) {
+    rk.ComputeMany(it(), size_, x_.data(), y_.data(), x.data(), y.data(),
+                   cell);
+
+    for (size_t ix = 0; ix < size_; ++ix) {
+      if (std::isnan(x[ix]) || std::isnan(y[ix])) {
         return false;
       }
     }
-    Update(it(), x, y);
+    x_ = x;
+    y_ = y;
+    time_ = it();
     return true;
   }
 
   /**
-   * @brief TODO
+   * @brief Get the elements of the gradient of the flow map computed from
+   * the stencil. They are undefined if the position does not describe a
+   * stencil of 3 or 5 points.
    *
-   * @param a00
-   * @param a01
-   * @param a10
-   * @param a11
+   * @param a00 δx along the first axis of the stencil
+   * @param a01 δx along the second axis of the stencil
+   * @param a10 δy along the first axis of the stencil
+   * @param a11 δy along the second axis of the stencil
    */
-  virtual void StrainTensor(double &a00, double &a01, double &a10,
-                            double &a11) const {
-    // make clang-check happy
-    a00 = a01 = a10 = a11 = std::numeric_limits<double>::quiet_NaN();
+  inline void StrainTensor(double &a00, double &a01, double &a10,
+                           double &a11) const {
+    switch (size_) {
+      case 3:
+        a00 = x_[1] - x_[0];
+        a01 = x_[2] - x_[0];
+        a10 = y_[1] - y_[0];
+        a11 = y_[2] - y_[0];
+        break;
+      case 5:
+        a00 = x_[1] - x_[3];
+        a01 = x_[2] - x_[4];
+        a10 = y_[1] - y_[3];
+        a11 = y_[2] - y_[4];
+        break;
+      default:
+        a00 = a01 = a10 = a11 = std::numeric_limits<double>::quiet_NaN();
+    }
   }
 
  protected:
@@ -256,10 +301,13 @@ class Position {
                                         const double y0, const double y1);
 
   /// Abscissas of the point
-  std::vector<double> x_;
+  std::array<double, kMaxStencilSize> x_{};
 
   /// Ordinates of the point
-  std::vector<double> y_;
+  std::array<double, kMaxStencilSize> y_{};
+
+  /// Number of points defined
+  size_t size_{0};
 
   /// Integration time (number of seconds elapsed since 1970)
   double time_{0};
@@ -267,140 +315,123 @@ class Position {
   /// Indicate whether the integration is over or not
   bool completed_{false};
 
+  /// Indicate whether the points M₁ and M₂ are moved by the linearized flow
+  /// around M₀ (see Variational)
+  bool variational_{false};
+
+  /// True if the coordinates system is Lon/lat
+  bool spherical_equatorial_{true};
+
   /// Function used to calculate distance
   DistanceCalculator pDistance_{&GeodeticDistance};
 
  private:
-  /**
-   * @brief Update the position
-   *
-   * @param time Time step (number of seconds elapsed since 1970)
-   * @param x Longitude of points
-   * @param y Latitude of points
-   */
-  inline void Update(const double time, const std::vector<double> &x,
-                     const std::vector<double> &y) {
-    x_ = x;
-    y_ = y;
-    time_ = time;
+  // Move the point M₀ together with the gradient of the flow map G, then
+  // place M₁ and M₂ at M₀ + G e₁ and M₀ + G e₂.
+  auto ComputeVariational(const RungeKutta &rk, const Iterator &it,
+                          CellProperties &cell) -> bool {
+    double g[] = {x_[1] - x_[0], x_[2] - x_[0], y_[1] - y_[0], y_[2] - y_[0]};
+    double x;
+    double y;
+
+    if (!rk.ComputeVariational(it(), x_[0], y_[0], x, y, g, cell)) {
+      return false;
+    }
+    x_ = {x, x + g[0], x + g[1]};
+    y_ = {y, y + g[2], y + g[3]};
+    time_ = it();
+    return true;
   }
 };
 
 /**
- * @brief Define the position of one point
+ * @brief Define the position of a stencil of N points: the initial point M₀
+ * followed by its neighbours M₁ = M₀ + (δ, 0), M₂ = M₀ + (0, δ),
+ * M₃ = M₀ - (δ, 0) and M₄ = M₀ - (0, δ).
+ *
+ * @tparam N Number of points of the stencil (1, 3 or 5)
  */
-class Point : public Position {
+template <size_t N>
+class StencilPosition : public Position {
+  static_assert(N == 1 || N == 3 || N == 5, "invalid stencil size");
+
  public:
   /**
    * Default constructor
    */
-  Point() = default;
+  StencilPosition() = default;
 
   /**
    * @brief Construct a new object defining the position of the N points
    *
    * @param x Longitude of the initial point
    * @param y Latitude of the initial point
+   * @param delta Initial separation in degrees of neighboring
    * @param start_time Advection starting time particles
    * @param spherical_equatorial True if the coordinates system is Lon/lat
    * otherwise false
    */
-  Point(const double x, const double y, const double start_time,
-        const bool spherical_equatorial)
+  StencilPosition(const double x, const double y, const double delta,
+                  const double start_time, const bool spherical_equatorial)
       : Position(start_time, spherical_equatorial) {
-    x_.push_back(x);
-    y_.push_back(y);
-  }
-
-  /**
-   * Move constructor
-   *
-   * @param rhs right value
-   */
-  Point(Point &&rhs) = default;
-
-  /**
-   * Move assignment operator
-   *
-   * @param rhs right value
-   */
-  auto operator=(Point &&rhs) -> Point & = default;
-};
+    // Unit offsets of the points M₀ to M₄ of the stencil
+    constexpr double dx[] = {0, 1, 0, -1, 0};
+    constexpr double dy[] = {0, 0, 1, 0, -1};
 
-/**
- * @brief Define the position of 3 points
- */
-class Triplet : public Position {
- public:
-  /**
-   * Default constructor
-   */
-  Triplet() = default;
+    for (size_t k = 0; k < N; ++k) {
+      x_[k] = x + dx[k] * delta;
+      y_[k] = y + dy[k] * delta;
+    }
+    size_ = N;
+  }
 
   /**
-   * @brief Construct a new object defining the position of the N points
+   * @brief Construct a new object defining the position of one point
    *
-   * @param x Longitude of the initial point
-   * @param y Latitude of the initial point
-   * @param delta Initial separation in degrees of neighboring
+   * @param x Longitude of the point
+   * @param y Latitude of the point
    * @param start_time Advection starting time particles
    * @param spherical_equatorial True if the coordinates system is Lon/lat
    * otherwise false
    */
-  Triplet(const double x, const double y, const double delta,
-          const double start_time, const bool spherical_equatorial)
-      : Position(start_time, spherical_equatorial) {
-    x_.push_back(x);
-    x_.push_back(x + delta);
-    x_.push_back(x);
-    y_.push_back(y);
-    y_.push_back(y);
-    y_.push_back(y + delta);
-  }
+  template <size_t M = N, typename = std::enable_if_t<M == 1>>
+  StencilPosition(const double x, const double y, const double start_time,
+                  const bool spherical_equatorial)
+      : StencilPosition(x, y, 0, start_time, spherical_equatorial) {}
 
   /**
    * Move constructor
    *
    * @param rhs right value
    */
-  Triplet(Triplet &&rhs) = default;
+  StencilPosition(StencilPosition &&rhs) = default;
 
   /**
    * Move assignment operator
    *
    * @param rhs right value
    */
-  auto operator=(Triplet &&rhs) -> Triplet & = default;
-
-  /**
-   * @brief TODO
-   *
-   * @param a00
-   * @param a01
-   * @param a10
-   * @param a11
-   */
-  inline void StrainTensor(double &a00, double &a01, double &a10,
-                           double &a11) const override {
-    a00 = x_[1] - x_[0];
-    a01 = x_[2] - x_[0];
-    a10 = y_[1] - y_[0];
-    a11 = y_[2] - y_[0];
-  }
+  auto operator=(StencilPosition &&rhs) -> StencilPosition & = default;
 };
 
 /**
- * @brief Define the position of 5 points
+ * @brief Define the position of a triplet of points whose neighbours M₁ and
+ * M₂ are not advected: a single trajectory, M₀, is integrated together with
+ * the gradient G of the flow map (the variational equation) and the
+ * neighbours are placed at M₁ = M₀ + G (δ, 0) and M₂ = M₀ + G (0, δ). The
+ * strain tensor and the separation are therefore computed as for a Triplet
+ * from the linearized flow around M₀.
  */
-class Quintuplet : public Position {
+class Variational : public StencilPosition<3> {
  public:
   /**
    * Default constructor
    */
-  Quintuplet() = default;
+  Variational() { variational_ = true; }
 
   /**
-   * @brief Construct a new object defining the position of the N points
+   * @brief Construct a new object defining the position of the point and
+   * of its linearized neighbours
    *
    * @param x Longitude of the initial point
    * @param y Latitude of the initial point
@@ -409,51 +440,20 @@ class Quintuplet : public Position {
    * @param spherical_equatorial True if the coordinates system is Lon/lat
    * otherwise false
    */
-  Quintuplet(const double x, const double y, const double delta,
-             const double start_time, const bool spherical_equatorial)
-      : Position(start_time, spherical_equatorial) {
-    x_.push_back(x);
-    x_.push_back(x + delta);
-    x_.push_back(x);
-    x_.push_back(x - delta);
-    x_.push_back(x);
-
-    y_.push_back(y);
-    y_.push_back(y);
-    y_.push_back(y + delta);
-    y_.push_back(y);
-    y_.push_back(y - delta);
+  Variational(const double x, const double y, const double delta,
+              const double start_time, const bool spherical_equatorial)
+      : StencilPosition<3>(x, y, delta, start_time, spherical_equatorial) {
+    variational_ = true;
   }
+};
 
-  /**
-   * Move constructor
-   *
-   * @param rhs right value
-   */
-  Quintuplet(Quintuplet &&rhs) = default;
+/// Position of one point
+using Point = StencilPosition<1>;
 
-  /**
-   * Move assignment operator
-   *
-   * @param rhs right value
-   */
-  auto operator=(Quintuplet &&rhs) -> Quintuplet & = default;
+/// Position of 3 points
+using Triplet = StencilPosition<3>;
 
-  /**
-   * @brief TODO
-   *
-   * @param a00
-   * @param a01
-   * @param a10
-   * @param a11
-   */
-  inline void StrainTensor(double &a00, double &a01, double &a10,
-                           double &a11) const override {
-    a00 = x_[1] - x_[3];
-    a01 = x_[2] - x_[4];
-    a10 = y_[1] - y_[3];
-    a11 = y_[2] - y_[4];
-  }
-};
+/// Position of 5 points
+using Quintuplet = StencilPosition<5>;
 
 }  // namespace lagrangian
@@ -0,0 +1,122 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Pool of threads sharing the processing of a range of tasks by work
+ * stealing.
+ *
+ * The threads are started once, when the pool is created, and are reused for
+ * every call to ParallelFor. The range of tasks is initially divided into
+ * equal parts, one per thread. Each thread processes its part by chunks;
+ * when its part is exhausted, it steals the second half of the remaining
+ * tasks of another thread. Thus, the time spent by ParallelFor depends on the
+ * total amount of work and not on the slowest of the static parts.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Function processing the tasks [first, last) on the thread
+   * \#worker (between 0 and size() - 1)
+   */
+  using Task = std::function<void(size_t first, size_t last, size_t worker)>;
+
+  /**
+   * @brief Default constructor
+   *
+   * @param num_threads The number of threads to use for the computation. If
+   * 0 all CPUs are used. If 1 is given, no thread is started and the tasks
+   * are processed by the calling thread, which is useful for debugging.
+   */
+  explicit ThreadPool(int num_threads);
+
+  /**
+   * @brief Stops and joins the threads of the pool.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+  /**
+   * @brief Get the number of threads processing the tasks, including the
+   * calling thread.
+   *
+   * @return The number of workers
+   */
+  [[nodiscard]] inline auto size() const -> size_t { return queues_.size(); }
+
+  /**
+   * @brief Process the tasks [0, size) and wait for their completion.
+   *
+   * @param size Number of tasks to process
+   * @param task Function processing a range of tasks
+   * @param grain Number of tasks handed out at once to a thread
+   *
+   * @throw The first exception thrown by the function, if any.
+   */
+  void ParallelFor(size_t size, const Task &task, size_t grain = 1);
+
+ private:
+  /// Range of tasks owned by a thread
+  struct alignas(64) Queue {
+    std::mutex mutex;
+    size_t first{0};
+    size_t last{0};
+  };
+
+  std::vector<std::thread> threads_;
+  std::vector<std::unique_ptr<Queue>> queues_;
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  size_t generation_{0};
+  size_t pending_{0};
+  bool stop_{false};
+
+  const Task *task_{nullptr};
+  size_t grain_{1};
+  std::exception_ptr exception_{nullptr};
+
+  // Main loop of the threads of the pool
+  void Worker(size_t worker);
+
+  // Process tasks until no work remains in the queues
+  void Execute(size_t worker);
+
+  // Take the next chunk of tasks of the queue owned by the worker
+  auto Pop(size_t worker, size_t &first, size_t &last) -> bool;
+
+  // Move the second half of the tasks of another queue into the queue owned
+  // by the worker
+  auto Steal(size_t worker) -> bool;
+};
+
+}  // namespace lagrangian
@@ -16,6 +16,9 @@
 
 // ___________________________________________________________________________//
 
+#include <array>
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +26,7 @@
 
 #include "lagrangian/axis.hpp"
 #include "lagrangian/reader/factory.hpp"
+#include "lagrangian/thread_pool.hpp"
 
 // ___________________________________________________________________________//
 
@@ -118,6 +122,12 @@ class FileList {
  *
  * The series is described by a list of files containing only one date per
  * file.
+ *
+ * When the grids needed for an interval are loaded, the next grid in the
+ * direction of the integration is read in the background into a spare
+ * reader, so that crossing into a new file only exchanges two readers. The
+ * NetCDF library not being thread-safe, all the files are read under a lock
+ * shared by all the time series.
  */
 class TimeSerie {
  public:
@@ -143,20 +153,46 @@ class TimeSerie {
    * file)
    * @param type Instance of an object implementing the class Reader. By
    * default the class uses the reader of NetCDF grids.
+   * @param storage Type used to store the grids loaded into memory.
    */
   TimeSerie(const std::vector<std::string> &filenames, std::string varname,
             std::string unit = "",
-            reader::Factory::Type type = reader::Factory::kNetCDF);
+            reader::Factory::Type type = reader::Factory::kNetCDF,
+            Grid::Storage storage = Grid::kFloat64);
+
+  /**
+   * @brief Create a new instance of TimeSerie handling the two components of
+   * a vector field stored in the same files. The two components are
+   * interpolated together.
+   *
+   * @param filenames List of files constituting the time series.
+   * @param u_varname Name the variable containing the first component.
+   * @param v_varname Name the variable containing the second component.
+   * @param unit Unit of data required by the user. If the parameter contains
+   * an empty string, the object will not do unit conversion.
+   * @param type Type of the reader used to read the grids.
+   * @param storage Type used to store the grids loaded into memory.
+   */
+  TimeSerie(const std::vector<std::string> &filenames, std::string u_varname,
+            std::string v_varname, std::string unit,
+            reader::Factory::Type type,
+            Grid::Storage storage = Grid::kFloat64);
 
   /**
    * @brief Default method invoked when a TimeSerie is destroyed.
    */
-  ~TimeSerie() {
-    for (auto &item : readers_) {
-      delete item;
-    }
-    delete time_serie_;
-  }
+  ~TimeSerie();
+
+  /**
+   * @brief Restricts the grids read to the region [x_min, x_max] x [y_min,
+   * y_max]. The grids already loaded are discarded.
+   *
+   * @param x_min Minimum longitude in degrees
+   * @param x_max Maximum longitude in degrees
+   * @param y_min Minimum latitude in degrees
+   * @param y_max Maximum latitude in degrees
+   */
+  void SetBoundingBox(double x_min, double x_max, double y_min, double y_max);
 
   /**
    * @brief Computes the value of point (x, y, t) in the series.
@@ -174,6 +210,104 @@ class TimeSerie {
   auto Interpolate(double date, double longitude, double latitude,
                    double fill_value, CellProperties &cell) -> double;
 
+  /**
+   * @brief Computes the values of a set of points at the same date.
+   *
+   * @param date Date (in number of seconds elapsed since 1970-1-1
+   * 00:00:00.0+00:00)
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param result Interpolated values
+   * @param cell Cell properties of the grid used for the interpolation
+   */
+  void InterpolateMany(double date, size_t n, const double *longitude,
+                       const double *latitude, double fill_value,
+                       double *result, CellProperties &cell);
+
+  /**
+   * @brief Computes the two components of the vector field at the point
+   * (x, y, t) in the series.
+   *
+   * @param date Date (in number of seconds elapsed since 1970-1-1
+   * 00:00:00.0+00:00)
+   * @param longitude in degrees
+   * @param latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component
+   * @param v Second component
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @throw std::logic_error if the series does not handle a vector field.
+   */
+  void InterpolateVector(double date, double longitude, double latitude,
+                         double fill_value, double &u, double &v,
+                         CellProperties &cell);
+
+  /**
+   * @brief Computes the two components of the vector field and their
+   * derivatives with respect to the coordinates at the point (x, y, t) in
+   * the series.
+   *
+   * @param date Date (in number of seconds elapsed since 1970-1-1
+   * 00:00:00.0+00:00)
+   * @param longitude in degrees
+   * @param latitude in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First component
+   * @param v Second component
+   * @param u_x Derivative of the first component along the longitude
+   * @param u_y Derivative of the first component along the latitude
+   * @param v_x Derivative of the second component along the longitude
+   * @param v_y Derivative of the second component along the latitude
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @throw std::logic_error if the series does not handle a vector field.
+   */
+  void InterpolateVectorGradient(double date, double longitude,
+                                 double latitude, double fill_value, double &u,
+                                 double &v, double &u_x, double &u_y,
+                                 double &v_x, double &v_y,
+                                 CellProperties &cell);
+
+  /**
+   * @brief Computes the two components of the vector field for a set of
+   * points at the same date.
+   *
+   * @param date Date (in number of seconds elapsed since 1970-1-1
+   * 00:00:00.0+00:00)
+   * @param n Number of points
+   * @param longitude Longitudes in degrees
+   * @param latitude Latitudes in degrees
+   * @param fill_value Value to be taken into account for fill values
+   * @param u First components
+   * @param v Second components
+   * @param cell Cell properties of the grid used for the interpolation
+   *
+   * @throw std::logic_error if the series does not handle a vector field.
+   */
+  void InterpolateVectorMany(double date, size_t n, const double *longitude,
+                             const double *latitude, double fill_value,
+                             double *u, double *v, CellProperties &cell);
+
+  /**
+   * @brief Creates a reader of the values of the series at a given date:
+   * the grids surrounding the date are interpolated in time once for all
+   * the points, the interpolation of the values at this date becoming a
+   * spatial interpolation.
+   *
+   * @param date Date (in number of seconds elapsed since 1970-1-1
+   * 00:00:00.0+00:00)
+   * @param fill_value Value to be taken into account for fill values
+   * @param pool Threads computing the grid
+   *
+   * @return The reader created, or nullptr if the readers of the series
+   * cannot combine their grids.
+   */
+  auto Slab(double date, double fill_value, ThreadPool &pool)
+      -> std::unique_ptr<Reader>;
+
   /**
    * @brief Returns the first date of the time series.
    *
@@ -206,12 +340,45 @@ class TimeSerie {
   FileList *time_serie_;
   int first_index_, last_index_;
   std::string varname_;
+  std::string v_varname_;
   std::string unit_;
   reader::Factory::Type type_;
+  Grid::Storage storage_;
   std::map<std::string, int> files_;
 
+  /// Region read, if bounded_ is true
+  std::array<double, 4> bounding_box_{};
+  bool bounded_{false};
+
+  /// Reader receiving the grid read in the background
+  Reader *spare_{nullptr};
+
+  /// File being read in the background, or an empty string.
+  std::string prefetched_;
+
+  /// Background reading of the file prefetched_
+  std::future<void> prefetch_;
+
   // Load new files in memory if necessary.
   void Load(int ix0, int ix1);
+
+  // Create a reader restricted to the region read, if any.
+  [[nodiscard]] auto NewReader() const -> Reader *;
+
+  // Open the file and load into memory the grids handled by the series.
+  void Read(Reader *reader, const std::string &filename) const;
+
+  // Start reading, in the background, the file #index of the series.
+  void Prefetch(int index);
+
+  // Wait for the end of the background reading. If rethrow is true, the
+  // exception thrown by the reading, if any, is propagated.
+  void WaitPrefetch(bool rethrow);
+
+  // Get the grids surrounding the date and their weights for the
+  // interpolation.
+  void FindGrids(double date, Reader *&r0, Reader *&r1, double &w0,
+                 double &w1);
 };
 
 }  // namespace lagrangian
@@ -0,0 +1,104 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+// ___________________________________________________________________________//
+
+#include <functional>
+#include <vector>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/active_set.hpp"
+#include "lagrangian/integration.hpp"
+#include "lagrangian/particles.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/**
+ * @brief Trajectories of a set of particles (e.g. drifting buoys)
+ *
+ * The positions of the particles are stored in contiguous arrays and all the
+ * particles are moved in parallel at each time step of the integration. A
+ * particle whose velocity becomes undefined is no longer tracked.
+ */
+class Trajectories {
+ public:
+  /**
+   * @brief Function receiving the positions of the particles at a date of
+   * the integration: the date, expressed as a number of seconds elapsed
+   * since 1970, and the longitudes and latitudes of the particles, set to
+   * NaN for the particles no longer tracked. The arrays are only valid
+   * during the call.
+   */
+  using Observer =
+      std::function<void(double date, const double *x, const double *y)>;
+
+  /**
+   * @brief Default constructor
+   *
+   * @param x Initial longitudes of the particles in degrees
+   * @param y Initial latitudes of the particles in degrees
+   *
+   * @throw std::invalid_argument if the number of longitudes and latitudes
+   * differ
+   */
+  Trajectories(std::vector<double> x, std::vector<double> y);
+
+  /**
+   * @brief Get the number of particles
+   *
+   * @return The number of particles
+   */
+  [[nodiscard]] inline auto size() const -> size_t { return x0_.size(); }
+
+  /**
+   * @brief Get the number of dates of the integration, i.e. the number of
+   * calls of the observer by Compute
+   *
+   * @param integration Integration properties
+   *
+   * @return The number of dates
+   */
+  [[nodiscard]] static auto Steps(const Integration &integration) -> size_t;
+
+  /**
+   * @brief Compute the trajectories of the particles from their initial
+   * positions. At each date of the integration, the observer receives the
+   * positions of the particles at this date, then the particles are moved
+   * to the next date.
+   *
+   * @param integration Integration properties (e.g. Path)
+   * @param num_threads The number of threads to use for the computation. If
+   * 0 all CPUs are used. If 1 is given, no parallel computing code is used
+   * at all, which is useful for debugging.
+   * @param observer Function receiving the positions of the particles
+   */
+  void Compute(Integration &integration, int num_threads,
+               const Observer &observer);
+
+ private:
+  /// Initial positions of the particles
+  std::vector<double> x0_;
+  std::vector<double> y0_;
+
+  /// Positions of the particles handed out to the observer
+  std::vector<double> x_;
+  std::vector<double> y_;
+};
+
+}  // namespace lagrangian
@@ -26,6 +26,7 @@ except ImportError:
 
 __all__ = [
     'CellProperties',
+    'Checkpoint',
     'CoordinatesType',
     'DateTime',
     'Field',
@@ -35,6 +36,7 @@ __all__ = [
     'IntegrationMode',
     'Iterator',
     'MapOfFiniteLyapunovExponents',
+    'MapOutput',
     'MapProperties',
     'Path',
     'Position',
@@ -43,19 +45,24 @@ __all__ = [
     'RungeKutta',
     'SampleDataHandler',
     'Stencil',
+    'TiledMapOfFiniteLyapunovExponents',
     'TimeDuration',
+    'Trajectories',
     'Triplet',
     'UnitType',
+    'Variational',
     'axis',
     'debug',
     'field',
     'reader',
+    'set_shared_memory',
     'set_verbose',
     'units',
     'version',
 ]
 from .core import (
     CellProperties,
+    Checkpoint,
     CoordinatesType,
     DateTime,
     Field,
@@ -65,6 +72,7 @@ from .core import (
     IntegrationMode,
     Iterator,
     MapOfFiniteLyapunovExponents,
+    MapOutput,
     MapProperties,
     Path,
     Position,
@@ -72,13 +80,17 @@ from .core import (
     Reader,
     RungeKutta,
     Stencil,
+    TiledMapOfFiniteLyapunovExponents,
     TimeDuration,
+    Trajectories,
     Triplet,
     UnitType,
+    Variational,
     axis,
     debug,
     field,
     reader,
+    set_shared_memory,
     set_verbose,
     units,
     version,
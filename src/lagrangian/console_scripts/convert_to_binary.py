@@ -0,0 +1,127 @@
+# This file is part of lagrangian library.
+#
+# lagrangian is free software: you can redistribute it and/or modify
+# it under the terms of GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# lagrangian is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of GNU Lesser General Public License
+# along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+import argparse
+import collections
+import os
+import re
+
+import lagrangian
+
+#: Unit of the velocities stored for each system of units
+SYSTEM_UNITS = dict(metric='m/s', angular='degrees/s')
+
+
+def directory(path):
+    """Check if path is a directory"""
+    if not os.path.isdir(path):
+        raise argparse.ArgumentTypeError('%r must be a directory' % path)
+    return path
+
+
+def usage():
+    """Parse commands line"""
+    parser = argparse.ArgumentParser(
+        description='Convert the NetCDF grids of a configuration file into '
+        'native binary grids, mapped into memory by the binary reader')
+    parser.add_argument('configuration',
+                        help='configuration file describing the NetCDF '
+                        'grids to convert')
+    parser.add_argument('dst',
+                        help='directory containing the binary grids '
+                        'converted',
+                        type=directory)
+    parser.add_argument('output',
+                        help='configuration file describing the binary '
+                        'grids to create')
+    parser.add_argument('--unit',
+                        help='system of units for velocity',
+                        choices=SYSTEM_UNITS.keys(),
+                        default='metric')
+    parser.add_argument('--verbose', help='Verbose mode', action='store_true')
+    return parser.parse_args()
+
+
+def read_configuration(path: str) -> dict[str, list[str]]:
+    """Read a configuration file: lines "KEY = VALUE", "#" starting a
+    comment, "\\" continuing a line and ${VAR} replaced by the environment
+    variable VAR"""
+    result: dict[str, list[str]] = collections.defaultdict(list)
+    buffer = ''
+    with open(path) as stream:
+        for line in stream:
+            match = re.match(r'^\s*#include\s+"(.*)"', line)
+            if match is not None:
+                included = read_configuration(match.group(1))
+                for key, values in included.items():
+                    result[key] += values
+            buffer += line.split('#')[0].strip()
+            if buffer.endswith('\\'):
+                buffer = buffer[:-1]
+                continue
+            if buffer:
+                key, value = buffer.split('=', 1)
+                value = re.sub(
+                    r'\$\{(\w+)\}',
+                    lambda m: os.environ.get(m.group(1), m.group(0)),
+                    value.strip())
+                result[key.strip()].append(value)
+            buffer = ''
+    return result
+
+
+def target(dst: str, path: str, name: str = '') -> str:
+    """Get the path to the binary grid converted from a NetCDF grid"""
+    basename = os.path.splitext(os.path.basename(path))[0]
+    return os.path.join(dst, basename + ('_' + name if name else '') + '.bin')
+
+
+def main():
+    """Main function"""
+    args = usage()
+    lagrangian.set_verbose(args.verbose)
+    parameters = read_configuration(args.configuration)
+    unit = SYSTEM_UNITS[args.unit]
+    u_name = parameters['U_NAME'][0]
+    v_name = parameters['V_NAME'][0]
+
+    # If the two components are stored in the same files, they are converted
+    # together so that the binary reader can map them without copy.
+    grids = dict()
+    if parameters['U'] == parameters['V']:
+        for path in parameters['U']:
+            grids['U', path] = grids['V', path] = target(args.dst, path)
+            lagrangian.debug(f'Convert {path} to {grids["U", path]}')
+            lagrangian.reader.Binary.convert(path, u_name, v_name, unit,
+                                             grids['U', path])
+    else:
+        for name, key in ((u_name, 'U'), (v_name, 'V')):
+            for path in parameters[key]:
+                grids[key, path] = target(args.dst, path, name)
+                lagrangian.debug(f'Convert {path} to {grids[key, path]}')
+                lagrangian.reader.Binary.convert(path, name, '', unit,
+                                                 grids[key, path])
+
+    with open(args.output, 'w') as stream:
+        for key in ('U', 'V'):
+            for path in parameters[key]:
+                stream.write('%s = %s\n' % (key, grids[key, path]))
+        for key, values in parameters.items():
+            if key not in ('U', 'V'):
+                for value in values:
+                    stream.write('%s = %s\n' % (key, value))
+
+
+if __name__ == '__main__':
+    main()
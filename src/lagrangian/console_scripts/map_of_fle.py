@@ -14,6 +14,7 @@
 # along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
 import argparse
 import datetime
+import os
 import pickle
 import sys
 import time
@@ -36,7 +37,15 @@ SYSTEM_UNITS = dict(metric=lagrangian.UnitType.METRIC,
                     angular=lagrangian.UnitType.ANGULAR)
 
 STENCIL = dict(triplet=lagrangian.Stencil.TRIPLET,
-               quintuplet=lagrangian.Stencil.QUINTUPLET)
+               quintuplet=lagrangian.Stencil.QUINTUPLET,
+               variational=lagrangian.Stencil.VARIATIONAL)
+
+READERS = dict(netcdf=lagrangian.reader.Type.NETCDF,
+               binary=lagrangian.reader.Type.BINARY)
+
+STORAGES = dict(float64=lagrangian.reader.Storage.FLOAT64,
+                float32=lagrangian.reader.Storage.FLOAT32,
+                int16=lagrangian.reader.Storage.INT16)
 
 MODE = dict(fsle=lagrangian.IntegrationMode.FSLE,
             ftle=lagrangian.IntegrationMode.FTLE)
@@ -142,9 +151,24 @@ def usage():
                              default=TimeDirection.default())
     integration.add_argument('--stencil',
                              help='type of stencil used to compute the finite '
-                             'difference.',
+                             'difference. The variational stencil advects a '
+                             'single particle with the gradient of the flow '
+                             'map.',
                              choices=STENCIL.keys(),
                              default='triplet')
+    integration.add_argument('--shared_nodes',
+                             help='advect the nodes of the grid only once, '
+                             'the stencil of a cell being made of its '
+                             'neighbouring nodes. Requires an initial '
+                             'separation equal to the resolution of the '
+                             'grid.',
+                             action='store_true')
+    integration.add_argument('--fast_spherical',
+                             help='move the particles on the sphere with '
+                             'polynomials instead of trigonometric '
+                             'functions. The positions are identical up to '
+                             'the rounding errors.',
+                             action='store_true')
     integration.add_argument('--initial_separation',
                              help='initial separation in degrees of '
                              'neighbouring particules',
@@ -199,16 +223,75 @@ def usage():
                            help='Use a dask local cluster for testing purpose',
                            action='store_true')
 
+    checkpoint = parser.add_argument_group(
+        'checkpoint arguments',
+        'Save the state of the computation to resume it after an '
+        'interruption.')
+    checkpoint.add_argument('--checkpoint',
+                            help='checkpoint file written during the '
+                            'computation. If the file exists, the computation '
+                            'resumes from it. When the calculation is divided '
+                            'by geographical area, the index of the area is '
+                            'appended to the file name.',
+                            metavar='PATH',
+                            default=None)
+    checkpoint.add_argument('--checkpoint_interval',
+                            help='number of time steps between two '
+                            'checkpoints',
+                            type=int,
+                            metavar='STEPS',
+                            default=10)
+
+    memory = parser.add_argument_group(
+        'memory arguments', 'Bound the memory used by the computation.')
+    memory.add_argument('--memory_budget',
+                        help='memory available for the computation of the '
+                        'map, in MiB. The map is computed by bands of '
+                        'longitudes fitting into this budget, each band '
+                        'being written to the output file before the next '
+                        'one starts. The grids of the velocity field, read '
+                        'once and kept in memory until the last band, are '
+                        'not included in the budget.',
+                        type=positive_value,
+                        metavar='MIB',
+                        default=None)
+
     data = parser.add_argument_group('reader arguments',
                                      'Set options of the NetCDF reader.')
     data.add_argument('--unit',
                       help='system of units for velocity',
                       choices=SYSTEM_UNITS.keys(),
                       default='metric')
+    data.add_argument('--reader',
+                      help='format of the grids: NetCDF, or native binary '
+                      'grids created by convert_to_binary',
+                      choices=READERS.keys(),
+                      default='netcdf')
+    data.add_argument('--storage',
+                      help='type used to store the grids loaded into '
+                      'memory: float32 halves and int16 quarters the memory '
+                      'used, at the cost of a loss of precision',
+                      choices=STORAGES.keys(),
+                      default='float64')
     data.add_argument('--mask',
                       help='netCDF grid for fixing undefined cells',
                       nargs=2,
                       metavar=('PATH', 'VARNAME'))
+    data.add_argument('--max_velocity',
+                      help='maximum velocity of the flow in m/s. If set, '
+                      'only the region of the grids that the particles can '
+                      'reach during the advection time is read',
+                      type=positive_value,
+                      metavar='VELOCITY',
+                      default=None)
+    data.add_argument('--shared_memory',
+                      help='share the grids loaded into memory between the '
+                      'processes running on the same node',
+                      action='store_true')
+    data.add_argument('--time_slabs',
+                      help='interpolate the grids in time once per time '
+                      'step, at the cost of three more grids kept in memory',
+                      action='store_true')
 
     parser.add_argument('--verbose', help='Verbose mode', action='store_true')
     parser.add_argument('--version',
@@ -236,9 +319,18 @@ def usage():
             args.final_separation != -1:
         parser.error('argument --final_separation not allowed in FTLE '
                      'mode')
+    if args.checkpoint_interval < 1:
+        parser.error('argument --checkpoint_interval must be strictly '
+                     'positive')
     if not HAVE_DASK:
         args.__dict__['local_cluster'] = None
         args.__dict__['scheduler_file'] = None
+    if args.memory_budget is not None:
+        if args.local_cluster or args.scheduler_file:
+            parser.error('argument --memory_budget not allowed on a cluster')
+        if args.checkpoint is not None:
+            parser.error('argument --memory_budget not allowed with '
+                         '--checkpoint')
     return args
 
 
@@ -300,15 +392,45 @@ class MapProperties(Inherit):
 
 class TimeSerie(Inherit):
     """Derives class "lagrangian.field.TimeSerie" in order to serialize
-    this object."""
+    this object. The optional bounding box restricts the grids read to the
+    region that the particles can reach. If time_slabs is set, the grids are
+    interpolated in time once per time step."""
     BASE = lagrangian.field.TimeSerie
 
+    def __init__(self,
+                 *args,
+                 bounding_box: tuple[float, ...] | None = None,
+                 time_slabs: bool = False,
+                 **kwargs) -> None:
+        super().__init__(*args, **kwargs)
+        self._state = (args,
+                       dict(kwargs,
+                            bounding_box=bounding_box,
+                            time_slabs=time_slabs))
+        if bounding_box is not None:
+            self._base.set_bounding_box(*bounding_box)
+        self._base.time_slabs = time_slabs
+
+    def __setstate__(self, state: bytes) -> None:
+        args, kwargs = pickle.loads(state)
+        self.__init__(*args, **kwargs)
+
 
 class FiniteLyapunovExponentsIntegration(Inherit):
     """Derives class "lagrangian.FiniteLyapunovExponentsIntegration" in order
-    to serialize this object."""
+    to serialize this object. If fast_spherical is set, the points are moved
+    on the sphere with polynomials instead of trigonometric functions."""
     BASE = lagrangian.FiniteLyapunovExponentsIntegration
 
+    def __init__(self, *args, fast_spherical: bool = False, **kwargs) -> None:
+        super().__init__(*args, **kwargs)
+        self._state = (args, dict(kwargs, fast_spherical=fast_spherical))
+        self._base.fast_spherical = fast_spherical
+
+    def __setstate__(self, state: bytes) -> None:
+        args, kwargs = pickle.loads(state)
+        self.__init__(*args, **kwargs)
+
 
 class MapOfFiniteLyapunovExponents(Inherit):
     """Derives class "lagrangian.MapOfFiniteLyapunovExponents" in order
@@ -316,6 +438,12 @@ class MapOfFiniteLyapunovExponents(Inherit):
     BASE = lagrangian.MapOfFiniteLyapunovExponents
 
 
+class TiledMapOfFiniteLyapunovExponents(Inherit):
+    """Derives class "lagrangian.TiledMapOfFiniteLyapunovExponents" in order
+    to unwrap the arguments of its constructor."""
+    BASE = lagrangian.TiledMapOfFiniteLyapunovExponents
+
+
 def check_period(ts: TimeSerie, start_time: datetime.datetime,
                  end_time: datetime.datetime) -> None:
     """
@@ -337,39 +465,84 @@ def check_period(ts: TimeSerie, start_time: datetime.datetime,
                             ts.end_time().strftime('%Y-%m-%dT%H:%M:%S')))
 
 
-def worker_task(args: argparse.Namespace,
-                fle: FiniteLyapunovExponentsIntegration,
-                map_properties: MapProperties, threads: int):
-
+def load_mask(args: argparse.Namespace) -> lagrangian.Reader | None:
+    """Load the grid used to locate the cells which are not computed"""
     # The nodes of the grid result, located on land are undefined. To speed
     # up the calculation we use a external grid to remove these cells from
     # the calculation.
-    if args.mask:
-        reader = lagrangian.reader.NetCDF()
-        reader.open(args.mask[0])
-        reader.load(args.mask[1])
-    else:
-        reader = None
+    if not args.mask:
+        return None
+    reader = lagrangian.reader.NetCDF()
+    reader.open(args.mask[0])
+    reader.load(args.mask[1])
+    return reader
+
+
+def map_outputs(args: argparse.Namespace) -> list:
+    """Return the maps to compute, in the order they are written"""
+    outputs = [
+        lagrangian.MapOutput.THETA1, lagrangian.MapOutput.THETA2,
+        lagrangian.MapOutput.LAMBDA1, lagrangian.MapOutput.LAMBDA2
+    ]
+    if args.diagnostic:
+        outputs += [
+            lagrangian.MapOutput.FINAL_SEPARATION, lagrangian.MapOutput.DELTA_T
+        ]
+    return outputs
+
+
+def worker_task(args: argparse.Namespace,
+                fle: FiniteLyapunovExponentsIntegration,
+                map_properties: MapProperties,
+                threads: int,
+                checkpoint: str | None = None):
+    # The grids read by the workers running on the same node are shared.
+    lagrangian.set_shared_memory(args.shared_memory)
+    reader = load_mask(args)
 
     # Initializes the map to process
     map_of_fle = MapOfFiniteLyapunovExponents(map_properties, fle,
-                                              STENCIL[args.stencil], reader)
+                                              STENCIL[args.stencil], reader,
+                                              args.shared_nodes)
+
+    # Resumes the computation saved in the checkpoint, if any
+    if checkpoint is not None:
+        if os.path.exists(checkpoint):
+            lagrangian.debug(f'Restart from {checkpoint}')
+            map_of_fle.restart(checkpoint)
+        checkpoint_ = lagrangian.Checkpoint(checkpoint,
+                                            args.checkpoint_interval)
+    else:
+        checkpoint_ = None
 
     # Computes map
-    map_of_fle.compute(threads)
+    map_of_fle.compute(threads, checkpoint_)
 
-    result = [
-        map_of_fle.map_of_theta1(),
-        map_of_fle.map_of_theta2(),
-        map_of_fle.map_of_lambda1(),
-        map_of_fle.map_of_lambda2()
-    ]
-    if args.diagnostic:
-        result += [
-            map_of_fle.map_of_final_separation(),
-            map_of_fle.map_of_delta_t()
-        ]
-    return numpy.stack(result)
+    # Extracts all the maps in a single pass over the grid
+    return map_of_fle.maps(map_outputs(args), num_threads=threads)
+
+
+def tiled_task(args: argparse.Namespace,
+               fle: FiniteLyapunovExponentsIntegration,
+               map_properties: MapProperties, threads: int,
+               rootgrp: netCDF4.Dataset) -> None:
+    """Compute the map by bands of longitudes, each band being written to the
+    NetCDF file before the next one starts"""
+    map_of_fle = TiledMapOfFiniteLyapunovExponents(map_properties, fle,
+                                                   STENCIL[args.stencil],
+                                                   load_mask(args),
+                                                   args.shared_nodes)
+    outputs = map_outputs(args)
+    memory_budget = int(args.memory_budget * 1024 * 1024)
+    lagrangian.debug('Bands of %d longitudes' %
+                     map_of_fle.tile_size(memory_budget, len(outputs)))
+
+    def write_tile(ix: int, exponents: numpy.ndarray) -> None:
+        write_exponents(args, rootgrp, exponents,
+                        slice(ix, ix + exponents.shape[1]))
+        rootgrp.sync()
+
+    map_of_fle.compute(outputs, write_tile, memory_budget, num_threads=threads)
 
 
 def build_dask_array(
@@ -386,16 +559,18 @@ def build_dask_array(
     for (i, y_chunk) in enumerate(y_chunks):
         map_properties_ = MapProperties(x_axis.size, len(y_chunk), x_axis[0],
                                         y_chunk[0], map_properties.step)
+        checkpoint = (None if args.checkpoint is None else
+                      f'{args.checkpoint}.{i}')
         dsk[(name, 0, 0, i)] = (worker_task, args, fsle, map_properties_,
-                                threads_per_worker)
+                                threads_per_worker, checkpoint)
 
     return dask.array.Array(dsk, name, chunks, 'float64')  # type: ignore
 
 
-def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
-                 map_properties: MapProperties, nx: int, ny: int,
-                 start_time: datetime.datetime):
-    """Write the NetCDF product"""
+def create_netcdf(args: argparse.Namespace, map_properties: MapProperties,
+                  nx: int, ny: int,
+                  start_time: datetime.datetime) -> netCDF4.Dataset:
+    """Create the NetCDF product, without the values of the exponents"""
     # Fill value for double in NetCDF file
     NC_FILL_DOUBLE = netCDF4.default_fillvals['f8']
 
@@ -431,7 +606,6 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
     theta1.long_name = 'Orientation of the eigenvectors associated to the' \
         'maximum eigenvalues of Cauchy-Green strain tensor'
     theta1.units = 'degree'
-    theta1[:] = exponents[0, :]
 
     theta2 = rootgrp.createVariable('theta2',
                                     'f8', (
@@ -442,7 +616,6 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
     theta2.long_name = 'Orientation of the eigenvectors associated to the' \
         'minimum eigenvalues of Cauchy-Green strain tensor'
     theta2.units = 'degree'
-    theta2[:] = exponents[1, :]
 
     lambda1 = rootgrp.createVariable('lambda1',
                                      'f8', (
@@ -453,7 +626,6 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
     lambda1.long_name = 'FLE associated to the maximum eigenvalues of ' \
         'Cauchy-Green strain tensor'
     lambda1.units = '1/day'
-    lambda1[:] = convert_from_sec_to_day_inv(exponents[2, :], NC_FILL_DOUBLE)
 
     lambda2 = rootgrp.createVariable('lambda2',
                                      'f8', (
@@ -464,7 +636,6 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
     lambda2.long_name = 'FLE associated to the minimum eigenvalues of ' \
         'Cauchy-Green strain tensor'
     lambda2.units = '1/day'
-    lambda2[:] = convert_from_sec_to_day_inv(exponents[3, :], NC_FILL_DOUBLE)
 
     if args.diagnostic:
         separation_distance = rootgrp.createVariable('separation_distance',
@@ -475,7 +646,6 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
                                                      fill_value=NC_FILL_DOUBLE)
         separation_distance.long_name = 'effective final separation distance'
         separation_distance.units = 'degree'
-        separation_distance[:] = exponents[4, :]
 
         if MODE[args.mode] == lagrangian.IntegrationMode.FSLE:
             advection_time = rootgrp.createVariable('advection_time',
@@ -487,9 +657,41 @@ def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
             advection_time.long_name = 'actual advection time'
             advection_time.units = 'number of days elapsed ' \
                 'since %s' % start_time.isoformat()
-            advection_time[:] = convert_from_sec_to_day(
+
+    return rootgrp
+
+
+def write_exponents(args: argparse.Namespace,
+                    rootgrp: netCDF4.Dataset,
+                    exponents: numpy.ndarray,
+                    index: slice = slice(None)) -> None:
+    """Write the exponents of the longitudes selected by index into the
+    NetCDF product"""
+    # Fill value for double in NetCDF file
+    NC_FILL_DOUBLE = netCDF4.default_fillvals['f8']
+
+    variables = rootgrp.variables
+    variables['theta1'][index, :] = exponents[0, :]
+    variables['theta2'][index, :] = exponents[1, :]
+    variables['lambda1'][index, :] = convert_from_sec_to_day_inv(
+        exponents[2, :], NC_FILL_DOUBLE)
+    variables['lambda2'][index, :] = convert_from_sec_to_day_inv(
+        exponents[3, :], NC_FILL_DOUBLE)
+
+    if args.diagnostic:
+        variables['separation_distance'][index, :] = exponents[4, :]
+
+        if MODE[args.mode] == lagrangian.IntegrationMode.FSLE:
+            variables['advection_time'][index, :] = convert_from_sec_to_day(
                 exponents[5, :], NC_FILL_DOUBLE)
 
+
+def write_netcdf(args: argparse.Namespace, exponents: numpy.ndarray,
+                 map_properties: MapProperties, nx: int, ny: int,
+                 start_time: datetime.datetime):
+    """Write the NetCDF product"""
+    rootgrp = create_netcdf(args, map_properties, nx, ny, start_time)
+    write_exponents(args, rootgrp, exponents)
     rootgrp.close()
 
 
@@ -502,6 +704,7 @@ def main():
 
     # Set debug
     lagrangian.set_verbose(args.verbose)
+    lagrangian.set_shared_memory(args.shared_memory)
 
     # Display set parameter values for the integration
     for item in args._get_kwargs():
@@ -514,8 +717,38 @@ def main():
     if not args.y_min < args.y_max:
         raise RuntimeError('Invalid definition of y range.')
 
+    nx = int((args.x_max - args.x_min) / args.resolution) + 1
+    ny = int((args.y_max - args.y_min) / args.resolution) + 1
+
+    # By default the initial separation is the grid step
+    if args.initial_separation is None:
+        args.initial_separation = args.resolution
+    if args.shared_nodes and args.initial_separation != args.resolution:
+        raise RuntimeError('The nodes of the grid can be shared only if the '
+                           'initial separation is equal to the resolution.')
+    if args.shared_nodes and args.stencil == 'variational':
+        raise RuntimeError('The nodes of the grid cannot be shared by the '
+                           'variational stencils.')
+
+    # The grids are restricted to the region covered by the particles,
+    # widened by the distance they can travel during the advection time.
+    if args.max_velocity is not None:
+        bounding_box: tuple[float, ...] | None = (
+            args.x_min - args.initial_separation,
+            args.x_min + (nx - 1) * args.resolution + args.initial_separation,
+            args.y_min - args.initial_separation,
+            args.y_min + (ny - 1) * args.resolution + args.initial_separation,
+            args.max_velocity * args.advection_time.total_seconds())
+    else:
+        bounding_box = None
+
     # Initializes the time series to process
-    ts = TimeSerie(args.configuration, SYSTEM_UNITS[args.unit])
+    ts = TimeSerie(args.configuration,
+                   SYSTEM_UNITS[args.unit],
+                   reader_type=READERS[args.reader],
+                   storage=STORAGES[args.storage],
+                   bounding_box=bounding_box,
+                   time_slabs=args.time_slabs)
     delta = datetime.timedelta(0, args.integration_time_step * 60 * 60)
 
     start_time = args.start_time
@@ -529,22 +762,20 @@ def main():
 
     check_period(ts, start_time, end_time)
 
-    nx = int((args.x_max - args.x_min) / args.resolution) + 1
-    ny = int((args.y_max - args.y_min) / args.resolution) + 1
-
-    # By default the initial separation is the grid step
-    if args.initial_separation is None:
-        args.initial_separation = args.resolution
-
     # Build the map properties
     map_properties = MapProperties(nx, ny, args.x_min, args.y_min,
                                    args.resolution)
 
     # Initializes the FLE to process
-    fle = FiniteLyapunovExponentsIntegration(start_time, end_time, delta,
-                                             MODE[args.mode],
-                                             args.final_separation,
-                                             args.initial_separation, ts)
+    fle = FiniteLyapunovExponentsIntegration(
+        start_time,
+        end_time,
+        delta,
+        MODE[args.mode],
+        args.final_separation,
+        args.initial_separation,
+        ts,
+        fast_spherical=args.fast_spherical)
 
     if args.local_cluster or args.scheduler_file:
         if args.local_cluster:
@@ -567,8 +798,17 @@ def main():
         array = build_dask_array(args, fle, map_properties, workers,
                                  threads_per_worker)
         exponents = array.compute()
+    elif args.memory_budget is not None:
+        # The bands of the map are written as soon as they are computed
+        rootgrp = create_netcdf(args, map_properties, nx, ny, start_time)
+        try:
+            tiled_task(args, fle, map_properties, args.threads, rootgrp)
+        finally:
+            rootgrp.close()
+        return
     else:
-        exponents = worker_task(args, fle, map_properties, args.threads)
+        exponents = worker_task(args, fle, map_properties, args.threads,
+                                args.checkpoint)
 
     write_netcdf(args, exponents, map_properties, nx, ny, start_time)
 
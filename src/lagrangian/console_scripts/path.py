@@ -21,6 +21,8 @@ import re
 import sys
 
 import dateutil.parser
+import netCDF4
+import numpy
 
 import lagrangian
 
@@ -73,9 +75,21 @@ def usage():
                         help='print the version number and exit',
                         action='store_true')
     parser.add_argument('--output',
-                        help='Output positions',
-                        type=FileType('w'),
-                        default=sys.stdout)
+                        help='Output positions (standard output by default)')
+    parser.add_argument('--format',
+                        help='Format of the output positions: text lines '
+                        '(identifier, longitude, latitude and date) or a '
+                        'NetCDF file of the longitudes and latitudes '
+                        'indexed by date and particle',
+                        choices=['text', 'netcdf'],
+                        default='text')
+    parser.add_argument('--threads',
+                        help='number of threads to use for the '
+                        'computation. If 0 all CPUs are used. If 1 is given, '
+                        'no parallel computing code is used at all, which '
+                        'is useful for debugging',
+                        type=int,
+                        default=0)
 
     # Checks whether the user wishes to display the version number
     args, _ = parser.parse_known_args()
@@ -89,54 +103,10 @@ def usage():
     parser.add_argument('input', help='Input positions', type=FileType('r'))
     parser.add_argument('start_time', help='Start time', type=date_type)
     parser.add_argument('end_time', help='End time', type=date_type)
-    return parser.parse_args()
-
-
-class Position:
-    """
-    Handle a buoy
-    """
-    IDENT = 0
-
-    def __init__(self, x, y):
-        self.__ident = Position.IDENT
-        self.__process = True
-        self.__x = x
-        self.__y = y
-
-        Position.IDENT += 1
-
-    def update(self, process, x, y):
-        """
-        Update the position
-        """
-        self.__process = process
-        self.__x = x
-        self.__y = y
-
-    @property
-    def x(self):
-        """
-        Longitude in degrees
-        """
-        return self.__x
-
-    @property
-    def y(self):
-        """
-        Latitude in degrees
-        """
-        return self.__y
-
-    @property
-    def process(self):
-        """
-        Test whether the buoy drift is completed
-        """
-        return self.__process
-
-    def __str__(self):
-        return '%d\t%f\t%f' % (self.__ident, self.__x, self.__y)
+    args = parser.parse_args()
+    if args.format == 'netcdf' and args.output is None:
+        parser.error('the NetCDF format requires an output file')
+    return args
 
 
 def decode_x(value):
@@ -167,6 +137,110 @@ def decode_y(value):
     return value
 
 
+def load_positions(stream):
+    """
+    Load the initial positions of the buoys
+    """
+    x = []
+    y = []
+    ix = 1
+    for line in stream:
+        try:
+            line = line[:line.find('#')].strip()
+            if line:
+                columns = re.split(r'\s+', line)
+                if len(columns) < 2:
+                    raise RuntimeError('missing position')
+                x.append(decode_x(columns[0]))
+                y.append(decode_y(columns[1]))
+        except Exception as err:
+            raise RuntimeError('Parse error in input file at '
+                               'line %d: %s' % (ix, ''.join(err.args)))
+        ix += 1
+    return numpy.array(x), numpy.array(y)
+
+
+class TextWriter:
+    """
+    Writes a text line for each position from which a buoy could be moved.
+    The lines of a date are written once the buoys are moved to the next
+    date: the position where the velocity of a buoy becomes undefined is
+    not written.
+    """
+
+    def __init__(self, stream):
+        self.stream = stream
+        self.previous = None
+
+    def write(self, date, x, y, mask):
+        """
+        Write the positions selected by mask
+        """
+        numpy.savetxt(self.stream,
+                      numpy.column_stack(
+                          (numpy.arange(x.size)[mask], x[mask], y[mask])),
+                      fmt='%d\t%f\t%f\t' + date.isoformat())
+
+    def __call__(self, date, x, y):
+        # The buoys tracked at this date were moved from the previous one
+        tracked = ~(numpy.isnan(x) | numpy.isnan(y))
+        if self.previous is not None:
+            self.write(*self.previous, tracked)
+        self.previous = (date, x, y)
+
+    def close(self):
+        """
+        Write the last date and close the output stream
+        """
+        if self.previous is not None:
+            date, x, y = self.previous
+            self.write(date, x, y, ~(numpy.isnan(x) | numpy.isnan(y)))
+            self.previous = None
+        if self.stream is not sys.stdout:
+            self.stream.close()
+
+
+class NetCDFWriter:
+    """
+    Writes the positions of the buoys, one record per date, into a NetCDF
+    file
+    """
+
+    def __init__(self, path, size):
+        self.dataset = netCDF4.Dataset(path, 'w')
+        self.dataset.createDimension('time', None)
+        self.dataset.createDimension('particle', size)
+        time = self.dataset.createVariable('time', 'f8', ('time', ))
+        time.long_name = 'Date of the positions'
+        time.units = 'seconds since 1970-01-01 00:00:00'
+        for name, long_name, units in [
+            ('x', 'Longitudes', 'degrees_east'),
+            ('y', 'Latitudes', 'degrees_north'),
+        ]:
+            variable = self.dataset.createVariable(name,
+                                                   'f8',
+                                                   ('time', 'particle'),
+                                                   chunksizes=(1, size),
+                                                   fill_value=numpy.nan)
+            variable.long_name = long_name
+            variable.units = units
+        self.index = 0
+
+    def __call__(self, date, x, y):
+        epoch = datetime.datetime(1970, 1, 1)
+        self.dataset.variables['time'][self.index] = (
+            date - epoch).total_seconds()
+        self.dataset.variables['x'][self.index, :] = x
+        self.dataset.variables['y'][self.index, :] = y
+        self.index += 1
+
+    def close(self):
+        """
+        Close the NetCDF file
+        """
+        self.dataset.close()
+
+
 def main():
     """
     Main program
@@ -180,46 +254,27 @@ def main():
         raise RuntimeError('The start date (%s) is before the beginning '
                            'of the time series (%s)' %
                            (args.start_time.strftime('%Y-%m-%dT%H:%M:%S'),
-                            ts.start_time.strftime('%Y-%m-%dT%H:%M:%S')))
+                            ts.start_time().strftime('%Y-%m-%dT%H:%M:%S')))
 
     if args.end_time > ts.end_time():
         raise RuntimeError('The end date (%s) is after the ending '
                            'of the time series (%s)' %
                            (args.end_time.strftime('%Y-%m-%dT%H:%M:%S'),
-                            ts.end_time.strftime('%Y-%m-%dT%H:%M:%S')))
+                            ts.end_time().strftime('%Y-%m-%dT%H:%M:%S')))
 
     path = lagrangian.Path(args.start_time, args.end_time, delta, ts)
-    positions = []
-
-    # Loading input file
-    ix = 1
-    for line in args.input:
-        try:
-            line = line[:line.find('#')].strip()
-            if line:
-                columns = re.split(r'\s+', line)
-                if len(columns) < 2:
-                    raise RuntimeError('missing position')
-                positions.append(
-                    Position(decode_x(columns[0]), decode_y(columns[1])))
-        except Exception as err:
-            raise RuntimeError('Parse error in input file at '
-                               'line %d: %s' % (ix, ''.join(err.args)))
-        ix += 1
-
-    it = path.iterator()
-
-    for time_step in it:
-        path.fetch(time_step)
-        for item in positions:
-            if item.process:
-                result = path.compute(it, item.x, item.y)
-                if result is not None:
-                    args.output.write('%s\t%s\n' %
-                                      (item, time_step.isoformat()))
-                    item.update(True, result[0], result[1])
-                else:
-                    item.update(False, item.x, item.y)
+    x, y = load_positions(args.input)
+    trajectories = lagrangian.Trajectories(x, y)
+
+    if args.format == 'netcdf':
+        writer = NetCDFWriter(args.output, len(trajectories))
+    else:
+        writer = TextWriter(
+            sys.stdout if args.output is None else open(args.output, 'w'))
+    try:
+        trajectories.compute(path, writer, num_threads=args.threads)
+    finally:
+        writer.close()
 
 
 if __name__ == '__main__':
@@ -21,15 +21,30 @@ import numpy.typing
 class Advect:
     def __init__(self, nx: typing.SupportsInt, ny: typing.SupportsInt, x_min: typing.SupportsFloat, y_min: typing.SupportsFloat, step: typing.SupportsFloat) -> None: ...
     def Initialize(self, integration: Integration, field: Reader | None = ...) -> None: ...
-    def compute(self, integration: Integration, num_threads: typing.SupportsInt = ...) -> None: ...
+    @overload
+    def compute(self, integration: Integration, num_threads: typing.SupportsInt = ..., checkpoint: Checkpoint | None = ...) -> None: ...
+    @overload
+    def compute(self, integration: Integration, dates: list, num_threads: typing.SupportsInt = ..., float32: bool = ..., fill_value: typing.SupportsFloat = ..., checkpoint: Checkpoint | None = ...) -> tuple[numpy.typing.NDArray, numpy.typing.NDArray]: ...
+    @overload
+    def compute(self, integration: Integration, dates: list, callback: typing.Callable[[typing.Any, numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.float64]], None], num_threads: typing.SupportsInt = ..., fill_value: typing.SupportsFloat = ..., checkpoint: Checkpoint | None = ...) -> None: ...
     def map_of_x(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_y(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
+    def restart(self, integration: Integration, filename: str) -> None: ...
 
 class CellProperties:
     def __init__(self) -> None: ...
     @staticmethod
     def none() -> CellProperties: ...
 
+class Checkpoint:
+    def __init__(self, filename: str, interval: typing.SupportsInt = ...) -> None: ...
+    def request(self) -> None: ...
+    def wait(self) -> None: ...
+    @property
+    def filename(self) -> str: ...
+    @property
+    def interval(self) -> int: ...
+
 class CoordinatesType:
     __members__: ClassVar[dict] = ...  # read-only
     CARTESIAN: ClassVar[CoordinatesType] = ...
@@ -52,7 +67,10 @@ class DateTime:
 
 class Field:
     def __init__(self, unit_type: UnitType, coordinate_type: CoordinatesType = ...) -> None: ...
+    @overload
     def compute(self, t, x: typing.SupportsFloat, y: typing.SupportsFloat, cell: CellProperties = ...) -> tuple[float, float]|None: ...
+    @overload
+    def compute(self, t, x: numpy.typing.ArrayLike, y: numpy.typing.ArrayLike, num_threads: typing.SupportsInt = ...) -> tuple[numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.bool_]]: ...
     def fetch(self, first, last) -> tuple[float, float]|None: ...
     def unit(self) -> str: ...
     @property
@@ -79,6 +97,7 @@ class FiniteLyapunovExponentsIntegration(Integration):
     def mode(self) -> IntegrationMode: ...
 
 class Integration:
+    fast_spherical: bool
     def __init__(self, start_time, end_time, delta_t, field: Field) -> None: ...
     def compute(self, it: Iterator, x0: typing.SupportsFloat, y0: typing.SupportsFloat) -> object: ...
     def fetch(self, date) -> None: ...
@@ -106,14 +125,36 @@ class Iterator:
     def __next__(self): ...
 
 class MapOfFiniteLyapunovExponents:
-    def __init__(self, map_properties: MapProperties, fle: FiniteLyapunovExponentsIntegration, stencil: Stencil = ..., reader: Reader = ...) -> None: ...
-    def compute(self, num_threads: typing.SupportsInt = ...) -> None: ...
+    def __init__(self, map_properties: MapProperties, fle: FiniteLyapunovExponentsIntegration, stencil: Stencil = ..., reader: Reader = ..., shared_nodes: bool = ...) -> None: ...
+    def compute(self, num_threads: typing.SupportsInt = ..., checkpoint: Checkpoint | None = ...) -> None: ...
     def map_of_delta_t(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_final_separation(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_lambda1(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_lambda2(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_theta1(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
     def map_of_theta2(self, fill_value: typing.SupportsFloat = ...) -> numpy.typing.NDArray[numpy.float64]: ...
+    def maps(self, outputs: list[MapOutput], fill_value: typing.SupportsFloat = ..., num_threads: typing.SupportsInt = ...) -> numpy.typing.NDArray[numpy.float64]: ...
+    def restart(self, filename: str) -> None: ...
+
+class MapOutput:
+    __members__: ClassVar[dict] = ...  # read-only
+    DELTA_T: ClassVar[MapOutput] = ...
+    FINAL_SEPARATION: ClassVar[MapOutput] = ...
+    LAMBDA1: ClassVar[MapOutput] = ...
+    LAMBDA2: ClassVar[MapOutput] = ...
+    THETA1: ClassVar[MapOutput] = ...
+    THETA2: ClassVar[MapOutput] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
 
 class MapProperties:
     def __init__(self, nx: typing.SupportsInt, ny: typing.SupportsInt, x_min: typing.SupportsFloat, y_min: typing.SupportsFloat, step: typing.SupportsFloat) -> None: ...
@@ -160,12 +201,16 @@ class Reader:
 
 class RungeKutta:
     def __init__(self, arg0: typing.SupportsFloat, arg1: Field) -> None: ...
+    @overload
     def compute(self, t, x: typing.SupportsFloat, y: typing.SupportsFloat, cell: CellProperties = ...) -> tuple: ...
+    @overload
+    def compute(self, t, x: numpy.typing.ArrayLike, y: numpy.typing.ArrayLike, num_threads: typing.SupportsInt = ...) -> tuple[numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.bool_]]: ...
 
 class Stencil:
     __members__: ClassVar[dict] = ...  # read-only
     QUINTUPLET: ClassVar[Stencil] = ...
     TRIPLET: ClassVar[Stencil] = ...
+    VARIATIONAL: ClassVar[Stencil] = ...
     __entries: ClassVar[dict] = ...
     def __init__(self, value: typing.SupportsInt) -> None: ...
     def __eq__(self, other: object) -> bool: ...
@@ -178,16 +223,37 @@ class Stencil:
     @property
     def value(self) -> int: ...
 
+class TiledMapOfFiniteLyapunovExponents:
+    def __init__(self, map_properties: MapProperties, fle: FiniteLyapunovExponentsIntegration, stencil: Stencil = ..., reader: Reader = ..., shared_nodes: bool = ...) -> None: ...
+    def compute(self, outputs: list[MapOutput], callback: typing.Callable[[int, numpy.typing.NDArray[numpy.float64]], None], memory_budget: typing.SupportsInt, fill_value: typing.SupportsFloat = ..., num_threads: typing.SupportsInt = ...) -> None: ...
+    def tile_size(self, memory_budget: typing.SupportsInt, outputs: typing.SupportsInt) -> int: ...
+
 class TimeDuration:
     def __init__(self, arg0) -> None: ...
     def to_timedelta(self, *args, **kwargs): ...
 
+class Trajectories:
+    def __init__(self, x: numpy.typing.ArrayLike, y: numpy.typing.ArrayLike) -> None: ...
+    def __len__(self) -> int: ...
+    @overload
+    def compute(self, integration: Integration, num_threads: typing.SupportsInt = ...) -> tuple[numpy.typing.NDArray[numpy.datetime64], numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.float64]]: ...
+    @overload
+    def compute(self, integration: Integration, callback: typing.Callable[[typing.Any, numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.float64]], None], num_threads: typing.SupportsInt = ...) -> None: ...
+    @staticmethod
+    def steps(integration: Integration) -> int: ...
+
 class Triplet(Position):
     @overload
     def __init__(self) -> None: ...
     @overload
     def __init__(self, x: typing.SupportsFloat, y: typing.SupportsFloat, delta: typing.SupportsFloat, start_time, spherical_equatorial: bool = ...) -> None: ...
 
+class Variational(Triplet):
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, x: typing.SupportsFloat, y: typing.SupportsFloat, delta: typing.SupportsFloat, start_time, spherical_equatorial: bool = ...) -> None: ...
+
 class UnitType:
     __members__: ClassVar[dict] = ...  # read-only
     ANGULAR: ClassVar[UnitType] = ...
@@ -205,5 +271,6 @@ class UnitType:
     def value(self) -> int: ...
 
 def debug(message: str) -> None: ...
+def set_shared_memory(value: bool) -> None: ...
 def set_verbose(value: bool) -> None: ...
 def version() -> str: ...
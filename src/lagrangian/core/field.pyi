@@ -1,11 +1,15 @@
+import typing
+
 from . import CoordinatesType, Field, UnitType, reader
 
 class Python(Field):
     def __init__(self, *args, **kwargs) -> None: ...
 
 class TimeSerie(Field):
-    def __init__(self, configuration_file: str, unit_type: UnitType = ..., coordinates_type: CoordinatesType = ..., reader_type: reader.Type = ...) -> None: ...
+    time_slabs: bool
+    def __init__(self, configuration_file: str, unit_type: UnitType = ..., coordinates_type: CoordinatesType = ..., reader_type: reader.Type = ..., storage: reader.Storage = ...) -> None: ...
     def end_time(self, *args, **kwargs): ...
+    def set_bounding_box(self, x_min: typing.SupportsFloat, x_max: typing.SupportsFloat, y_min: typing.SupportsFloat, y_max: typing.SupportsFloat, distance: typing.SupportsFloat = ...) -> None: ...
     def start_time(self, *args, **kwargs): ...
 
 class Vonkarman(Field):
@@ -1,18 +1,50 @@
 import typing
-from typing import ClassVar
+from typing import ClassVar, overload
+
+import numpy
+import numpy.typing
 
 from . import CellProperties
 from . import Reader as core_Reader
 
+class Binary(NetCDF):
+    def __init__(self, storage: Storage = ...) -> None: ...
+    @staticmethod
+    def convert(source: str, u_name: str, v_name: str, unit: str, target: str) -> None: ...
+
 class NetCDF(core_Reader):
-    def __init__(self) -> None: ...
+    def __init__(self, storage: Storage = ...) -> None: ...
     def date(self, *args, **kwargs): ...
+    @overload
     def interpolate(self, lon: typing.SupportsFloat, lat: typing.SupportsFloat, fill_value: typing.SupportsFloat = ..., cell: CellProperties = ...) -> float: ...
+    @overload
+    def interpolate(self, lon: numpy.typing.ArrayLike, lat: numpy.typing.ArrayLike, fill_value: typing.SupportsFloat = ..., num_threads: typing.SupportsInt = ...) -> tuple[numpy.typing.NDArray[numpy.float64], numpy.typing.NDArray[numpy.bool_]]: ...
+    def interpolate_vector(self, lon: typing.SupportsFloat, lat: typing.SupportsFloat, fill_value: typing.SupportsFloat = ..., cell: CellProperties = ...) -> tuple: ...
     def load(self, name: str, unit: str = ...) -> None: ...
+    def load_vector(self, u_name: str, v_name: str, unit: str = ...) -> None: ...
     def open(self, path: str) -> None: ...
+    def set_bounding_box(self, x_min: typing.SupportsFloat, x_max: typing.SupportsFloat, y_min: typing.SupportsFloat, y_max: typing.SupportsFloat) -> None: ...
+
+class Storage:
+    __members__: ClassVar[dict] = ...  # read-only
+    FLOAT32: ClassVar[Storage] = ...
+    FLOAT64: ClassVar[Storage] = ...
+    INT16: ClassVar[Storage] = ...
+    __entries: ClassVar[dict] = ...
+    def __init__(self, value: typing.SupportsInt) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
 
 class Type:
     __members__: ClassVar[dict] = ...  # read-only
+    BINARY: ClassVar[Type] = ...
     NETCDF: ClassVar[Type] = ...
     __entries: ClassVar[dict] = ...
     def __init__(self, value: typing.SupportsInt) -> None: ...
@@ -0,0 +1,163 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/checkpoint.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/// Identifies a checkpoint file
+static const char kMagic[8] = {'L', 'A', 'G', 'R', 'C', 'K', 'P', 'T'};
+
+/// Version of the file format. Also used to detect a file written with
+/// another byte order.
+static const uint32_t kVersion = 1;
+
+/// Header of a checkpoint file, followed by the values archived
+struct CheckpointHeader {
+  char magic[8];     //!< kMagic
+  uint32_t version;  //!< kVersion
+  uint32_t word;     //!< Size of the type size_t
+  uint64_t size;     //!< Number of bytes archived
+};
+
+// ___________________________________________________________________________//
+
+// Write the buffered data of a file to the disk. Returns false on error.
+static auto Sync(std::FILE *stream) -> bool {
+  if (std::fflush(stream) != 0) {
+    return false;
+  }
+#if defined(__unix__) || defined(__APPLE__)
+  return fsync(fileno(stream)) == 0;
+#elif defined(_WIN32)
+  return _commit(_fileno(stream)) == 0;
+#else
+  return true;
+#endif
+}
+
+// ___________________________________________________________________________//
+
+void Archive::Save(const std::string &filename) const {
+  CheckpointHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.word = sizeof(size_t);
+  header.size = buffer_.size();
+
+  // The previous checkpoint is replaced only once the new one is complete
+  // and written to the disk: a crash leaves either the previous checkpoint
+  // or the new one.
+  auto temporary = filename + ".tmp";
+  {
+    auto stream = std::unique_ptr<std::FILE, int (*)(std::FILE *)>(
+        std::fopen(temporary.c_str(), "wb"), &std::fclose);
+    if (stream == nullptr) {
+      throw std::runtime_error(temporary + ": unable to create the file");
+    }
+    auto *file = stream.get();
+    if (std::fwrite(&header, sizeof(CheckpointHeader), 1, file) != 1 ||
+        std::fwrite(buffer_.data(), 1, buffer_.size(), file) !=
+            buffer_.size() ||
+        !Sync(file)) {
+      throw std::runtime_error(temporary + ": unable to write the file");
+    }
+  }
+
+  // Unlike std::rename, replaces the existing file on all platforms.
+  std::error_code ec;
+  std::filesystem::rename(temporary, filename, ec);
+  if (ec) {
+    throw std::runtime_error(filename + ": unable to replace the file");
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto Archive::Load(const std::string &filename) -> Archive {
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    throw std::runtime_error(filename + ": unable to open the file");
+  }
+  auto length = static_cast<uint64_t>(stream.tellg());
+  stream.seekg(0);
+
+  CheckpointHeader header{};
+  if (length < sizeof(CheckpointHeader) ||
+      !stream.read(reinterpret_cast<char *>(&header),
+                   sizeof(CheckpointHeader)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(filename + ": not a checkpoint");
+  }
+  if (header.version != kVersion || header.word != sizeof(size_t)) {
+    throw std::runtime_error(filename +
+                             ": unsupported version or architecture of the "
+                             "checkpoint");
+  }
+  if (length - sizeof(CheckpointHeader) != header.size) {
+    throw std::runtime_error(filename + ": truncated or corrupted file");
+  }
+
+  Archive result;
+  result.buffer_.resize(header.size);
+  if (!stream.read(result.buffer_.data(),
+                   static_cast<std::streamsize>(header.size))) {
+    throw std::runtime_error(filename + ": unable to read the file");
+  }
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+Checkpoint::~Checkpoint() {
+  // The error of a write that nobody waited for is lost.
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+// ___________________________________________________________________________//
+
+void Checkpoint::Write(Archive &&archive) {
+  Wait();
+  pending_ = std::async(std::launch::async,
+                        [this, archive = std::move(archive)]() -> void {
+                          archive.Save(filename_);
+                        });
+}
+
+// ___________________________________________________________________________//
+
+void Checkpoint::Wait() {
+  if (pending_.valid()) {
+    pending_.get();
+  }
+}
+
+}  // namespace lagrangian
@@ -0,0 +1,149 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/engine.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+template <typename FieldType, typename Space,
+          FiniteLyapunovExponentsIntegration::Mode mode>
+void StaticFiniteLyapunovExponentsEngine<FieldType, Space, mode>::Move(
+    const Iterator &it, Particles &particles, const size_t *const indexes,
+    const size_t n, CellProperties &cell) const {
+  particles.Compute(rk_, it, indexes, n, cell);
+}
+
+// ___________________________________________________________________________//
+
+template <typename FieldType, typename Space,
+          FiniteLyapunovExponentsIntegration::Mode mode>
+void StaticFiniteLyapunovExponentsEngine<FieldType, Space, mode>::Compute(
+    const Iterator &it, Particles &particles, const size_t *const indexes,
+    const size_t n, CellProperties &cell) const {
+  particles.Compute(rk_, it, indexes, n, cell);
+
+  // In FTLE mode, the stencils are never separated.
+  if constexpr (mode == FiniteLyapunovExponentsIntegration::kFSLE) {
+    for (size_t ix = 0; ix < n; ++ix) {
+      const auto index = indexes[ix];
+
+      if (!particles.IsMissing(index) &&
+          particles.MaxDistanceExceeds(index, separation_threshold_)) {
+        particles.set_completed(index);
+      }
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+// Create the engine specialized for the mode of the integration of a field
+// of type FieldType in the space Space
+template <typename FieldType, typename Space>
+static auto CreateEngine(const FiniteLyapunovExponentsIntegration &fle,
+                         const FieldType *const field)
+    -> std::unique_ptr<FiniteLyapunovExponentsEngine> {
+  if (fle.get_mode() == FiniteLyapunovExponentsIntegration::kFSLE) {
+    return std::make_unique<StaticFiniteLyapunovExponentsEngine<
+        FieldType, Space, FiniteLyapunovExponentsIntegration::kFSLE>>(fle,
+                                                                      field);
+  }
+  return std::make_unique<StaticFiniteLyapunovExponentsEngine<
+      FieldType, Space, FiniteLyapunovExponentsIntegration::kFTLE>>(fle,
+                                                                    field);
+}
+
+// Create the engine specialized for the coordinate system and the mode of
+// the integration of a field of type FieldType
+template <typename FieldType>
+static auto CreateEngine(const FiniteLyapunovExponentsIntegration &fle,
+                         const FieldType *const field)
+    -> std::unique_ptr<FiniteLyapunovExponentsEngine> {
+  // The points are moved on the sphere only if the velocities are metric,
+  // see coordinates::Dynamic.
+  const auto spherical_equatorial =
+      field->get_unit_type() == Field::kMetric &&
+      field->get_coordinates_type() == Field::kSphericalEquatorial;
+
+  if (spherical_equatorial) {
+    if (fle.fast_spherical()) {
+      return CreateEngine<FieldType, coordinates::FastSphericalEquatorial>(
+          fle, field);
+    }
+    return CreateEngine<FieldType, coordinates::SphericalEquatorial>(fle,
+                                                                     field);
+  }
+  return CreateEngine<FieldType, coordinates::Cartesian>(fle, field);
+}
+
+// ___________________________________________________________________________//
+
+auto FiniteLyapunovExponentsEngine::Create(
+    const FiniteLyapunovExponentsIntegration &fle)
+    -> std::unique_ptr<FiniteLyapunovExponentsEngine> {
+  const auto *const field = fle.get_field();
+
+  if (const auto *time_serie = dynamic_cast<const field::TimeSerie *>(field);
+      time_serie != nullptr) {
+    return CreateEngine(fle, time_serie);
+  }
+  if (const auto *vonkarman = dynamic_cast<const field::Vonkarman *>(field);
+      vonkarman != nullptr) {
+    return CreateEngine(fle, vonkarman);
+  }
+  return std::make_unique<DynamicFiniteLyapunovExponentsEngine>(fle);
+}
+
+// ___________________________________________________________________________//
+
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::TimeSerie, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::Cartesian,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::SphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFSLE>;
+template class StaticFiniteLyapunovExponentsEngine<
+    field::Vonkarman, coordinates::FastSphericalEquatorial,
+    FiniteLyapunovExponentsIntegration::kFTLE>;
+
+}  // namespace lagrangian
@@ -18,32 +18,177 @@
 
 // ___________________________________________________________________________//
 
+#include "lagrangian/misc.hpp"
+
+// ___________________________________________________________________________//
+
 namespace lagrangian::field {
 
 TimeSerie::TimeSerie(const std::string &configuration_file,
                      const Field::UnitType unit_type,
                      const Field::CoordinatesType coordinates_type,
-                     const reader::Factory::Type reader_type)
+                     const reader::Factory::Type reader_type,
+                     const Grid::Storage storage)
     : Field(unit_type, coordinates_type) {
   Parameter p(configuration_file);
 
-  u_ = std::make_shared<lagrangian::TimeSerie>(p.Values<std::string>("U"),
-                                               p.Value<std::string>("U_NAME"),
-                                               GetUnit(), reader_type);
-  v_ = std::make_shared<lagrangian::TimeSerie>(p.Values<std::string>("V"),
-                                               p.Value<std::string>("V_NAME"),
-                                               GetUnit(), reader_type);
+  auto u_files = p.Values<std::string>("U");
+  auto v_files = p.Values<std::string>("V");
+
+  if (u_files == v_files) {
+    uv_ = std::make_shared<lagrangian::TimeSerie>(
+        u_files, p.Value<std::string>("U_NAME"), p.Value<std::string>("V_NAME"),
+        GetUnit(), reader_type, storage);
+  } else {
+    u_ = std::make_shared<lagrangian::TimeSerie>(
+        u_files, p.Value<std::string>("U_NAME"), GetUnit(), reader_type,
+        storage);
+    v_ = std::make_shared<lagrangian::TimeSerie>(
+        v_files, p.Value<std::string>("V_NAME"), GetUnit(), reader_type,
+        storage);
+  }
   fill_value_ = p.Exists("FILL_VALUE") ? p.Value<double>("FILL_VALUE") : 0;
 }
 
 // ___________________________________________________________________________//
 
+void TimeSerie::SetBoundingBox(double x_min, double x_max, double y_min,
+                               double y_max, const double distance) {
+  // Margins, in degrees, of the latitudes and of the longitudes at the
+  // highest latitude reached.
+  const auto dy = RadiansToDegrees(distance / kEarthRadius);
+  y_min = std::max(y_min - dy, -90.0);
+  y_max = std::min(y_max + dy, 90.0);
+
+  const auto cos_y = std::cos(
+      DegreesToRadians(std::max(std::abs(y_min), std::abs(y_max))));
+  if (cos_y * 180 <= dy) {
+    x_min = -180;
+    x_max = 180;
+  } else {
+    x_min -= dy / cos_y;
+    x_max += dy / cos_y;
+  }
+
+  for (auto &item : {uv_, u_, v_}) {
+    if (item != nullptr) {
+      item->SetBoundingBox(x_min, x_max, y_min, y_max);
+    }
+  }
+  slabs_ = {};
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::FetchStep(const double t0, const double t1, ThreadPool &pool) {
+  Load(t0, t1);
+  if (!time_slabs_) {
+    return;
+  }
+
+  // The dates are compared with a tolerance because the Runge-Kutta method
+  // computes them from the time step and not from these bounds.
+  const auto tolerance = 1e-6 * std::abs(t1 - t0);
+  const double dates[] = {t0, t0 + (t1 - t0) / 2, t1};
+  std::array<Slab, 3> slabs;
+
+  for (size_t ix = 0; ix < slabs.size(); ++ix) {
+    auto &slab = slabs[ix];
+
+    // The last slab of the previous step is the first one of this step.
+    auto &last = slabs_.back();
+    if (ix == 0 && (last.uv != nullptr || last.u != nullptr) &&
+        std::abs(last.date - t0) <= tolerance) {
+      slab = std::move(last);
+      continue;
+    }
+
+    slab.date = dates[ix];
+    if (uv_ != nullptr) {
+      slab.uv = uv_->Slab(slab.date, fill_value_, pool);
+    } else {
+      slab.u = u_->Slab(slab.date, fill_value_, pool);
+      slab.v = v_->Slab(slab.date, fill_value_, pool);
+    }
+
+    // The grids cannot be combined: the velocities are interpolated
+    // between the two grids surrounding each date.
+    if (slab.uv == nullptr && (slab.u == nullptr || slab.v == nullptr)) {
+      slabs_ = {};
+      return;
+    }
+  }
+  slabs_ = std::move(slabs);
+  slab_tolerance_ = tolerance;
+}
+
+// ___________________________________________________________________________//
+
 bool TimeSerie::Compute(const double t, const double x, const double y,
                         double &u, double &v, CellProperties &cell) const {
-  u = u_->Interpolate(t, x, y, fill_value_, cell);
-  v = v_->Interpolate(t, x, y, fill_value_, cell);
+  if (const auto *slab = FindSlab(t); slab != nullptr) {
+    if (slab->uv != nullptr) {
+      slab->uv->InterpolateVector(x, y, fill_value_, u, v, cell);
+    } else {
+      u = slab->u->Interpolate(x, y, fill_value_, cell);
+      v = slab->v->Interpolate(x, y, fill_value_, cell);
+    }
+  } else if (uv_ != nullptr) {
+    uv_->InterpolateVector(t, x, y, fill_value_, u, v, cell);
+  } else {
+    u = u_->Interpolate(t, x, y, fill_value_, cell);
+    v = v_->Interpolate(t, x, y, fill_value_, cell);
+  }
 
   return !(std::isnan(u) || std::isnan(v));
 }
 
+// ___________________________________________________________________________//
+
+bool TimeSerie::ComputeGradient(const double t, const double x, const double y,
+                                double &u, double &v, double &u_x, double &u_y,
+                                double &v_x, double &v_y,
+                                CellProperties &cell) const {
+  if (uv_ == nullptr) {
+    return Field::ComputeGradient(t, x, y, u, v, u_x, u_y, v_x, v_y, cell);
+  }
+  if (const auto *slab = FindSlab(t); slab != nullptr) {
+    slab->uv->InterpolateVectorGradient(x, y, fill_value_, u, v, u_x, u_y,
+                                        v_x, v_y, cell);
+  } else {
+    uv_->InterpolateVectorGradient(t, x, y, fill_value_, u, v, u_x, u_y, v_x,
+                                   v_y, cell);
+  }
+
+  return !(std::isnan(u) || std::isnan(v) || std::isnan(u_x) ||
+           std::isnan(u_y) || std::isnan(v_x) || std::isnan(v_y));
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::ComputeMany(const double t, const size_t n,
+                            const double *const x, const double *const y,
+                            double *const u, double *const v,
+                            CellProperties &cell) const {
+  if (const auto *slab = FindSlab(t); slab != nullptr) {
+    if (slab->uv != nullptr) {
+      slab->uv->InterpolateVectorMany(n, x, y, fill_value_, u, v, cell);
+    } else {
+      slab->u->InterpolateMany(n, x, y, fill_value_, u, cell);
+      slab->v->InterpolateMany(n, x, y, fill_value_, v, cell);
+    }
+  } else if (uv_ != nullptr) {
+    uv_->InterpolateVectorMany(t, n, x, y, fill_value_, u, v, cell);
+  } else {
+    u_->InterpolateMany(t, n, x, y, fill_value_, u, cell);
+    v_->InterpolateMany(t, n, x, y, fill_value_, v, cell);
+  }
+
+  for (size_t ix = 0; ix < n; ++ix) {
+    if (std::isnan(u[ix]) || std::isnan(v[ix])) {
+      u[ix] = v[ix] = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+}
+
 }  // namespace lagrangian::field
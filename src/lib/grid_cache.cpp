@@ -0,0 +1,444 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/grid_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LAGRANGIAN_SHARED_MEMORY
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/trace.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+Grid::Grid(std::vector<double> values, const Storage storage)
+    : size_(values.size()), storage_(storage) {
+  switch (storage) {
+    case kFloat64:
+      float64_ = std::move(values);
+      data_ = float64_.data();
+      break;
+    case kFloat32:
+      float32_.assign(values.begin(), values.end());
+      data_ = float32_.data();
+      break;
+    case kInt16: {
+      // The values are packed on the range of the defined values, the
+      // smallest packed value being reserved for the undefined values.
+      auto min = std::numeric_limits<double>::infinity();
+      auto max = -std::numeric_limits<double>::infinity();
+      for (auto item : values) {
+        if (!std::isnan(item)) {
+          min = std::min(min, item);
+          max = std::max(max, item);
+        }
+      }
+      if (min < max) {
+        offset_ = (min + max) * 0.5;
+        scale_ = (max - min) / 65532;
+      } else if (min == max) {
+        offset_ = min;
+      }
+      int16_.resize(values.size());
+      for (size_t ix = 0; ix < values.size(); ++ix) {
+        int16_[ix] = std::isnan(values[ix])
+                         ? kInt16Missing
+                         : static_cast<int16_t>(std::clamp(
+                               std::lround((values[ix] - offset_) / scale_),
+                               -32766L, 32766L));
+      }
+      data_ = int16_.data();
+      break;
+    }
+    default:
+      throw std::invalid_argument("invalid lagrangian::Grid::Storage value");
+  }
+}
+
+// ___________________________________________________________________________//
+
+Grid::Grid(const void *data, const size_t size, const Storage storage,
+           const double scale, const double offset,
+           std::shared_ptr<void> memory)
+    : data_(data),
+      size_(size),
+      storage_(storage),
+      scale_(scale),
+      offset_(offset),
+      memory_(std::move(memory)) {}
+
+// ___________________________________________________________________________//
+
+auto Grid::nbytes() const noexcept -> size_t {
+  switch (storage_) {
+    case kFloat32:
+      return size_ * sizeof(float);
+    case kInt16:
+      return size_ * sizeof(int16_t);
+    default:
+      return size_ * sizeof(double);
+  }
+}
+
+// ___________________________________________________________________________//
+
+namespace {
+
+// Cache of the grids used by this process
+struct Cache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::weak_ptr<const Grid>> grids;
+  bool shared_memory{false};
+
+  // Number of GridCache::Pin alive and grids they keep in memory
+  size_t pins{0};
+  std::unordered_map<std::string, std::shared_ptr<const Grid>> pinned;
+};
+
+auto GetCache() -> Cache & {
+  static Cache cache;
+  return cache;
+}
+
+// Identifier of a grid: the file (path, size and date of last modification)
+// and the data read from it
+auto MakeKey(const std::string &filename, const std::string &description)
+    -> std::string {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  auto path = fs::canonical(filename, ec);
+  auto key = ec ? filename : path.string();
+  auto size = fs::file_size(path, ec);
+  if (!ec) {
+    auto mtime = fs::last_write_time(path, ec);
+    if (!ec) {
+      key += ":" + std::to_string(size) + ":" +
+             std::to_string(mtime.time_since_epoch().count());
+    }
+  }
+  return key + ":" + description;
+}
+
+#ifdef LAGRANGIAN_SHARED_MEMORY
+
+/// Identifies the segments created by this library
+constexpr uint64_t kMagic = 0x6c616772616e6769;
+
+/// Maximum time waited for a segment written by another process
+constexpr auto kTimeout = std::chrono::minutes(10);
+
+/// State of a segment
+enum SegmentState : uint32_t { kWriting = 0, kReady = 1 };
+
+/// Header of a segment, followed by the key of the grid and its values
+struct Header {
+  uint64_t magic;
+  std::atomic<uint32_t> state;
+  int32_t pid;
+  uint64_t size;
+  uint64_t key_size;
+  uint32_t storage;
+  double scale;
+  double offset;
+};
+
+// Offset of the values in a segment (aligned on a cache line)
+auto DataOffset(const std::string &key) -> size_t {
+  return (sizeof(Header) + key.size() + 63) & ~size_t(63);
+}
+
+// Name of the segment storing a grid (FNV-1a hash of its key)
+auto SegmentName(const std::string &key) -> std::string {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (auto item : key) {
+    hash = (hash ^ static_cast<unsigned char>(item)) * 0x100000001b3;
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "/lagrangian-%016llx",
+                static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+// Memory mapping of a segment
+struct Mapping {
+  void *address;
+  size_t length;
+  std::string name;
+  bool owner;
+
+  Mapping(void *address, const size_t length, std::string name,
+          const bool owner)
+      : address(address), length(length), name(std::move(name)), owner(owner) {}
+
+  ~Mapping() {
+    munmap(address, length);
+    if (owner) {
+      shm_unlink(name.c_str());
+    }
+  }
+};
+
+// Creates a new segment containing the grid. Returns nullptr if the segment
+// already exists.
+auto CreateSegment(const std::string &key, const std::string &name,
+                   const GridCache::Loader &loader,
+                   const Grid::Storage storage) -> std::shared_ptr<const Grid> {
+  auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    if (errno == EEXIST) {
+      return nullptr;
+    }
+    throw std::system_error(errno, std::generic_category(), name);
+  }
+
+  std::shared_ptr<const Grid> grid;
+  void *address = MAP_FAILED;
+  auto offset = DataOffset(key);
+  size_t length = 0;
+  try {
+    grid = std::make_shared<const Grid>(loader(), storage);
+    length = offset + grid->nbytes();
+    if (ftruncate(fd, static_cast<off_t>(length)) == -1 ||
+        (address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0)) == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), name);
+    }
+  } catch (...) {
+    close(fd);
+    shm_unlink(name.c_str());
+    if (grid == nullptr) {
+      throw;
+    }
+    // The grid is read but cannot be shared
+    return grid;
+  }
+  close(fd);
+
+  auto header = new (address)
+      Header{kMagic,          {kWriting},   getpid(),     grid->size(),
+             key.size(),      grid->storage(), grid->scale(), grid->offset()};
+  auto base = static_cast<char *>(address);
+  std::memcpy(base + sizeof(Header), key.data(), key.size());
+  std::memcpy(base + offset, grid->data(), grid->nbytes());
+  header->state.store(kReady, std::memory_order_release);
+
+  auto mapping = std::make_shared<Mapping>(address, length, name, true);
+  return std::make_shared<const Grid>(base + offset, grid->size(),
+                                      grid->storage(), grid->scale(),
+                                      grid->offset(), std::move(mapping));
+}
+
+// Maps a segment created by another process. Returns nullptr if the segment
+// does not exist (anymore) or cannot be used.
+auto OpenSegment(const std::string &key, const std::string &name,
+                 bool &retry) -> std::shared_ptr<const Grid> {
+  retry = false;
+  auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1) {
+    retry = errno == ENOENT;
+    return nullptr;
+  }
+
+  auto offset = DataOffset(key);
+  auto deadline = std::chrono::steady_clock::now() + kTimeout;
+  struct stat status {};
+
+  // Waits until the creator has set the size of the segment
+  while (fstat(fd, &status) == 0 &&
+         static_cast<size_t>(status.st_size) < offset) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      close(fd);
+      return nullptr;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto length = static_cast<size_t>(status.st_size);
+  auto address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+  auto mapping = std::make_shared<Mapping>(address, length, name, false);
+  auto base = static_cast<const char *>(address);
+  auto header = reinterpret_cast<const Header *>(base);
+
+  // Waits until the creator has written the grid
+  while (header->state.load(std::memory_order_acquire) != kReady) {
+    if (std::chrono::steady_clock::now() > deadline ||
+        (kill(header->pid, 0) == -1 && errno == ESRCH)) {
+      return nullptr;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // The segment may belong to another grid having the same hash
+  if (header->magic != kMagic || header->key_size != key.size() ||
+      std::memcmp(base + sizeof(Header), key.data(), key.size()) != 0) {
+    return nullptr;
+  }
+  auto grid = std::make_shared<const Grid>(
+      base + offset, header->size, static_cast<Grid::Storage>(header->storage),
+      header->scale, header->offset, std::move(mapping));
+  if (offset + grid->nbytes() > length) {
+    return nullptr;
+  }
+  return grid;
+}
+
+// Gets a grid stored in a shared memory segment
+auto LoadShared(const std::string &key, const GridCache::Loader &loader,
+                const Grid::Storage storage) -> std::shared_ptr<const Grid> {
+  auto name = SegmentName(key);
+
+  try {
+    // The segment may be removed by its creator between the two calls:
+    // tries again to create it.
+    for (auto attempt = 0; attempt < 3; ++attempt) {
+      auto grid = CreateSegment(key, name, loader, storage);
+      if (grid != nullptr) {
+        Debug(str(boost::format("Created the shared memory segment %s") %
+                  name));
+        return grid;
+      }
+      auto retry = false;
+      grid = OpenSegment(key, name, retry);
+      if (grid != nullptr) {
+        Debug(str(boost::format("Mapped the shared memory segment %s") %
+                  name));
+        return grid;
+      }
+      if (!retry) {
+        break;
+      }
+    }
+  } catch (std::system_error &err) {
+    Debug(str(boost::format("Unable to use the shared memory segment: %s") %
+              err.what()));
+  }
+  return std::make_shared<const Grid>(loader(), storage);
+}
+
+#endif
+
+}  // namespace
+
+// ___________________________________________________________________________//
+
+auto GridCache::Get(const std::string &filename,
+                    const std::string &description, const Loader &loader,
+                    const Grid::Storage storage)
+    -> std::shared_ptr<const Grid> {
+  auto key = MakeKey(filename, description) + ":" + std::to_string(storage);
+  auto &cache = GetCache();
+
+  // The lock is held while the grid is loaded so that two threads asking for
+  // the same grid do not read it twice.
+  std::lock_guard<std::mutex> lock(cache.mutex);
+
+  auto it = cache.grids.find(key);
+  if (it != cache.grids.end()) {
+    auto grid = it->second.lock();
+    if (grid != nullptr) {
+      if (cache.pins != 0) {
+        cache.pinned.emplace(key, grid);
+      }
+      return grid;
+    }
+  }
+
+  // Forgets the grids no longer used
+  for (auto jt = cache.grids.begin(); jt != cache.grids.end();) {
+    jt = jt->second.expired() ? cache.grids.erase(jt) : std::next(jt);
+  }
+
+  std::shared_ptr<const Grid> grid;
+#ifdef LAGRANGIAN_SHARED_MEMORY
+  grid = cache.shared_memory ? LoadShared(key, loader, storage)
+                             : std::make_shared<const Grid>(loader(), storage);
+#else
+  grid = std::make_shared<const Grid>(loader(), storage);
+#endif
+  cache.grids[key] = grid;
+  if (cache.pins != 0) {
+    cache.pinned[key] = grid;
+  }
+  return grid;
+}
+
+// ___________________________________________________________________________//
+
+GridCache::Pin::Pin() {
+  auto &cache = GetCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  ++cache.pins;
+}
+
+// ___________________________________________________________________________//
+
+GridCache::Pin::~Pin() {
+  auto &cache = GetCache();
+  std::unordered_map<std::string, std::shared_ptr<const Grid>> pinned;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (--cache.pins == 0) {
+      pinned.swap(cache.pinned);
+    }
+  }
+  // The grids are released, and their segments unmapped, outside the lock
+}
+
+// ___________________________________________________________________________//
+
+void GridCache::SetSharedMemory(const bool value) {
+#ifndef LAGRANGIAN_SHARED_MEMORY
+  if (value) {
+    throw std::runtime_error(
+        "shared memory is not supported on this platform");
+  }
+#endif
+  auto &cache = GetCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.shared_memory = value;
+}
+
+// ___________________________________________________________________________//
+
+auto GridCache::shared_memory() -> bool {
+  auto &cache = GetCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.shared_memory;
+}
+
+}  // namespace lagrangian
@@ -20,11 +20,45 @@ namespace lagrangian {
 
 auto FiniteLyapunovExponentsIntegration::ComputeExponents(
     const Position *const position, FiniteLyapunovExponents &fle) -> bool {
+  double a00;
+  double a01;
+  double a10;
+  double a11;
+
+  position->StrainTensor(a00, a01, a10, a11);
+
+  return ComputeExponents(position->get_time(), position->MaxDistance(), a00,
+                          a01, a10, a11, fle);
+}
+
+// ___________________________________________________________________________//
+
+auto FiniteLyapunovExponentsIntegration::ComputeExponents(
+    const Particles &particles, const size_t index,
+    FiniteLyapunovExponents &fle) -> bool {
+  double a00;
+  double a01;
+  double a10;
+  double a11;
+
+  particles.StrainTensor(index, a00, a01, a10, a11);
+
+  return ComputeExponents(particles.get_time(index),
+                          particles.MaxDistance(index), a00, a01, a10, a11,
+                          fle);
+}
+
+// ___________________________________________________________________________//
+
+auto FiniteLyapunovExponentsIntegration::ComputeExponents(
+    const double time, const double final_separation, double a00, double a01,
+    const double a10, const double a11, FiniteLyapunovExponents &fle) const
+    -> bool {
   // Advection time T
-  fle.set_delta_t(position->get_time() - start_time_);
+  fle.set_delta_t(time - start_time_);
 
   // Compute the Effective separation
-  fle.set_final_separation(position->MaxDistance());
+  fle.set_final_separation(final_separation);
 
   if (fabs(fle.get_delta_t()) < std::numeric_limits<double>::epsilon()) {
     fle.NaN();
@@ -35,13 +69,6 @@ auto FiniteLyapunovExponentsIntegration::ComputeExponents(
   // ∇Φ =  1 / δ₀  * [ a₀₀ a₀₁ ]
   //                 [ a₁₀ a₁₁ ]
   // where δ₀ is the initial separation distance of the particles
-  double a00;
-  double a01;
-  double a10;
-  double a11;
-
-  position->StrainTensor(a00, a01, a10, a11);
-
   if (field_->get_unit_type() == Field::kAngular) {
     a00 = NormalizeLongitude(a00, 360, 180);
     a01 = NormalizeLongitude(a01, 360, 180);
@@ -12,35 +12,207 @@
 //
 // You should have received a copy of GNU Lesser General Public License
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
-#include <thread>
+#include "lagrangian/map.hpp"
 
-// ___________________________________________________________________________//
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
-#include "lagrangian/map.hpp"
+#include "lagrangian/grid_cache.hpp"
+#include "lagrangian/thread_pool.hpp"
 
 // ___________________________________________________________________________//
 
 namespace lagrangian::map {
 
+/// Number of cells handed out at once to the threads
+static const size_t kCellsPerTask = 256;
+
+/// Maximum difference, in seconds, between the date of a snapshot and the
+/// date of the integration matching it
+static const double kDateTolerance = 1e-3;
+
+/// Computations whose state is stored in a checkpoint
+enum CheckpointType : uint32_t {
+  kFiniteLyapunovExponentsCheckpoint = 1,
+  kAdvectCheckpoint = 2
+};
+
+// ___________________________________________________________________________//
+
+// Write the header of a checkpoint: the type of computation, the grid, the
+// time steps of the integration and the number of time steps computed.
+static void WriteHeader(Archive &archive, const CheckpointType type,
+                        const MapProperties &map, const Iterator &start,
+                        const size_t steps) {
+  archive.Write(type);
+  archive.Write(map.get_nx());
+  archive.Write(map.get_ny());
+  archive.Write(map.get_x_min());
+  archive.Write(map.get_y_min());
+  archive.Write(map.get_step());
+  archive.Write(start());
+  archive.Write(start.inc());
+  archive.Write(steps);
+}
+
+// ___________________________________________________________________________//
+
+// Read the header of a checkpoint, checks that it was written for this
+// computation and returns the number of time steps computed.
+static auto ReadHeader(Archive &archive, const CheckpointType type,
+                       const MapProperties &map, const Iterator &start)
+    -> size_t {
+  CheckpointType checkpoint_type;
+  int nx;
+  int ny;
+  double x_min;
+  double y_min;
+  double step;
+  double begin;
+  double inc;
+  size_t steps;
+
+  archive.Read(checkpoint_type);
+  archive.Read(nx);
+  archive.Read(ny);
+  archive.Read(x_min);
+  archive.Read(y_min);
+  archive.Read(step);
+  archive.Read(begin);
+  archive.Read(inc);
+  archive.Read(steps);
+
+  if (checkpoint_type != type || nx != map.get_nx() || ny != map.get_ny() ||
+      x_min != map.get_x_min() || y_min != map.get_y_min() ||
+      step != map.get_step()) {
+    throw std::invalid_argument("the checkpoint was written for another map");
+  }
+  if (begin != start() || inc != start.inc()) {
+    throw std::invalid_argument(
+        "the checkpoint was written for another integration");
+  }
+  return steps;
+}
+
+// ___________________________________________________________________________//
+
+// Write the properties of the FLE integration that the state of the cells
+// depends on: the mode, the separations and the stencil advected.
+static void WriteIntegration(
+    Archive &archive,
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+    const Particles &particles) {
+  archive.Write(fle.get_mode());
+  archive.Write(fle.get_min_separation());
+  archive.Write(fle.get_delta());
+  archive.Write(particles.stencil_size());
+  archive.Write(particles.is_variational());
+}
+
+// ___________________________________________________________________________//
+
+// Read the properties of the FLE integration written by WriteIntegration and
+// checks that they define this computation. The stencil is checked only if
+// the particles are initialized.
+static void ReadIntegration(
+    Archive &archive,
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+    const Particles &particles) {
+  lagrangian::FiniteLyapunovExponentsIntegration::Mode mode;
+  double min_separation;
+  double delta;
+  size_t stencil_size;
+  bool variational;
+
+  archive.Read(mode);
+  archive.Read(min_separation);
+  archive.Read(delta);
+  archive.Read(stencil_size);
+  archive.Read(variational);
+
+  if (mode != fle.get_mode() || min_separation != fle.get_min_separation() ||
+      delta != fle.get_delta()) {
+    throw std::invalid_argument(
+        "the checkpoint was written for another integration");
+  }
+  if (particles.size() != 0 && (stencil_size != particles.stencil_size() ||
+                                variational != particles.is_variational())) {
+    throw std::invalid_argument(
+        "the checkpoint was written for another stencil");
+  }
+}
+
+// ___________________________________________________________________________//
+
+// Check that the cells of a set read from a checkpoint are cells of a grid
+// of size cells.
+static void CheckCells(const ActiveSet &set, const size_t size) {
+  for (size_t ix = 0; ix < set.size(); ++ix) {
+    if (set[ix] >= size) {
+      throw std::runtime_error("truncated or corrupted checkpoint");
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+// Move the iterator to the time step #steps. The iterator is incremented as
+// during the computation to reach exactly the same dates.
+static void Skip(Iterator &it, size_t steps) {
+  for (; steps != 0; --steps) {
+    ++it;
+  }
+}
+
+// ___________________________________________________________________________//
+
+// Write a checkpoint in the background if it is due
+template <typename Save>
+static void WriteCheckpoint(Checkpoint *checkpoint, const size_t steps,
+                            const Save &save) {
+  if (checkpoint != nullptr && checkpoint->IsDue(steps)) {
+    Debug(str(boost::format("Writing checkpoint %s after %d time steps") %
+              checkpoint->get_filename() % steps));
+    checkpoint->Write(save());
+  }
+}
+
+// ___________________________________________________________________________//
+
 void FiniteLyapunovExponents::Initialize(
     lagrangian::FiniteLyapunovExponentsIntegration &fle,
-    const lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil) {
+    const lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil,
+    const bool shared_nodes) {
   auto spherical_equatorial =
       fle.get_field()->get_coordinates_type() == Field::kSphericalEquatorial;
-  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
-    for (auto iy = 0; iy < map_.get_ny(); ++iy) {
-      // If the user restart initialization, it must release the
-      // allocated resources
-      auto position = map_.GetItem(ix, iy);
-      delete position;
 
-      // Allocate and store the new stencil
-      position = fle.SetInitialPoint(map_.GetXValue(ix), map_.GetYValue(iy),
-                                     stencil, spherical_equatorial);
-      map_.SetItem(ix, iy, position);
-      indexes_.push_back(Index(ix, iy));
+  // If the user restart initialization, the previous stencils are released
+  particles_ = Particles(
+      static_cast<size_t>(map_.get_nx()) * map_.get_ny(),
+      lagrangian::FiniteLyapunovExponentsIntegration::GetStencilSize(stencil),
+      fle.get_start_time(), spherical_equatorial,
+      stencil == lagrangian::FiniteLyapunovExponentsIntegration::kVariational);
+  indexes_.clear();
+  indexes_.reserve(particles_.size());
+  shared_cells_.clear();
+  active_nodes_.clear();
+  steps_ = 0;
+
+  size_t index = 0;
+
+  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
+    for (auto iy = 0; iy < map_.get_ny(); ++iy, ++index) {
+      fle.SetInitialPoint(map_.GetXValue(ix), map_.GetYValue(iy), index,
+                          particles_);
+      indexes_.push_back(index);
     }
   }
+
+  if (shared_nodes) {
+    ShareNodes(fle);
+  }
 }
 
 // ___________________________________________________________________________//
@@ -48,104 +220,331 @@ void FiniteLyapunovExponents::Initialize(
 void FiniteLyapunovExponents::Initialize(
     lagrangian::FiniteLyapunovExponentsIntegration &fle,
     const lagrangian::Reader *reader,
-    const lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil) {
+    const lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil,
+    const bool shared_nodes) {
   CellProperties cell;
   auto spherical_equatorial =
       fle.get_field()->get_coordinates_type() == Field::kSphericalEquatorial;
 
-  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
-    for (auto iy = 0; iy < map_.get_ny(); ++iy) {
-      // If the user restart initialization, it must release the
-      // allocated resources
-      auto position = map_.GetItem(ix, iy);
-      delete position;
+  // If the user restart initialization, the previous stencils are released
+  particles_ = Particles(
+      static_cast<size_t>(map_.get_nx()) * map_.get_ny(),
+      lagrangian::FiniteLyapunovExponentsIntegration::GetStencilSize(stencil),
+      fle.get_start_time(), spherical_equatorial,
+      stencil == lagrangian::FiniteLyapunovExponentsIntegration::kVariational);
+  indexes_.clear();
+  indexes_.reserve(particles_.size());
+  shared_cells_.clear();
+  active_nodes_.clear();
+  steps_ = 0;
+
+  size_t index = 0;
 
-      // Allocate and store the new stencil
-      position = fle.SetInitialPoint(map_.GetXValue(ix), map_.GetYValue(iy),
-                                     stencil, spherical_equatorial);
+  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
+    for (auto iy = 0; iy < map_.get_ny(); ++iy, ++index) {
+      fle.SetInitialPoint(map_.GetXValue(ix), map_.GetYValue(iy), index,
+                          particles_);
 
       if (std::isnan(reader->Interpolate(
               map_.GetXValue(ix), map_.GetYValue(iy),
               std::numeric_limits<double>::quiet_NaN(), cell))) {
-        position->set_completed();
+        particles_.set_completed(index);
       } else {
-        indexes_.push_back(Index(ix, iy));
+        indexes_.push_back(index);
       }
-      map_.SetItem(ix, iy, position);
     }
   }
+
+  if (shared_nodes) {
+    ShareNodes(fle);
+  }
 }
 
 // ___________________________________________________________________________//
 
-void FiniteLyapunovExponents::ComputeHt(
-    Splitter<Index> &splitter,
-    lagrangian::FiniteLyapunovExponentsIntegration &fle, Iterator &it) {
-  // Creating an object containing the properties of the interpolation
-  CellProperties cell;
+auto FiniteLyapunovExponents::GetNode(const size_t index,
+                                      const size_t member) const -> int64_t {
+  // Unit offsets of the points M₀ to M₄ of the stencil
+  static const int64_t dx[] = {0, 1, 0, -1, 0};
+  static const int64_t dy[] = {0, 0, 1, 0, -1};
+
+  const int64_t nx = map_.get_nx();
+  const int64_t ny = map_.get_ny();
+  const auto ix = static_cast<int64_t>(index) / ny + dx[member];
+  const auto iy = static_cast<int64_t>(index) % ny + dy[member];
+
+  if (ix < 0 || ix >= nx || iy < 0 || iy >= ny) {
+    return -1;
+  }
+  return ix * ny + iy;
+}
+
+// ___________________________________________________________________________//
+
+void FiniteLyapunovExponents::ShareNodes(
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle) {
+  // The variational stencils advect a single point.
+  if (particles_.is_variational()) {
+    throw std::invalid_argument(
+        "the nodes of the grid cannot be shared by variational stencils");
+  }
 
-  auto first = splitter.begin();
-  while (first != splitter.end()) {
-    auto ix = first->get_i();
-    auto iy = first->get_j();
-    auto position = map_.GetItem(ix, iy);
+  // The neighbouring nodes of the grid coincide with the points of the
+  // stencils only if the stencils are as wide as the grid step.
+  if (std::fabs(fle.get_delta() - map_.get_step()) >
+      1e-9 * std::fabs(map_.get_step())) {
+    throw std::invalid_argument(
+        "the nodes of the grid can be shared only if the initial separation "
+        "is equal to the step of the grid");
+  }
+
+  auto spherical_equatorial =
+      fle.get_field()->get_coordinates_type() == Field::kSphericalEquatorial;
+  auto size = particles_.size();
 
-    if (!fle.Compute(it, position, cell)) {
-      position->Missing();
+  nodes_ = Particles(size, 1, fle.get_start_time(), spherical_equatorial);
+  shared_.assign(size, 0);
+
+  std::vector<uint8_t> used(size, 0);
+  ActiveSet cells;
+  cells.reserve(indexes_.size());
+
+  for (size_t ix = 0; ix < indexes_.size(); ++ix) {
+    auto index = indexes_[ix];
+    auto shared = true;
+
+    // The cells located on the edges of the grid or next to a hidden cell
+    // keep their own stencil.
+    for (size_t k = 1; shared && k < particles_.stencil_size(); ++k) {
+      auto node = GetNode(index, k);
+      shared = node != -1 && !particles_.is_completed(node);
+    }
+
+    if (shared) {
+      shared_[index] = 1;
+      shared_cells_.push_back(index);
+      for (size_t k = 0; k < particles_.stencil_size(); ++k) {
+        used[GetNode(index, k)] = 1;
+      }
     } else {
-      if (fle.Separation(position)) {
-        position->set_completed();
+      cells.push_back(index);
+    }
+  }
+  indexes_ = std::move(cells);
+
+  size_t index = 0;
+
+  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
+    for (auto iy = 0; iy < map_.get_ny(); ++iy, ++index) {
+      if (used[index] != 0) {
+        nodes_.SetStencil(index, map_.GetXValue(ix), map_.GetYValue(iy), 0);
+        active_nodes_.push_back(index);
       }
     }
-    ++first;
   }
+
+  Debug(str(boost::format("%d cells computed from %d shared nodes, %d cells "
+                          "with their own stencil") %
+            shared_cells_.size() % active_nodes_.size() % indexes_.size()));
 }
 
 // ___________________________________________________________________________//
 
-void FiniteLyapunovExponents::Compute(
-    lagrangian::FiniteLyapunovExponentsIntegration &fle, int num_threads) {
-  auto it = fle.GetIterator();
-  std::list<std::thread> threads;
+auto FiniteLyapunovExponents::IsNodeUsed(const size_t node) const -> bool {
+  // The point #k of the stencil of a cell is the point #opposite[k] of the
+  // stencil of the node.
+  static const size_t opposite[] = {0, 3, 4, 1, 2};
 
-  if (num_threads == 0) {
-    num_threads = std::thread::hardware_concurrency();
+  for (size_t k = 0; k < particles_.stencil_size(); ++k) {
+    auto cell = GetNode(node, opposite[k]);
+    if (cell != -1 && shared_[cell] != 0 && !Completed(cell)) {
+      return true;
+    }
   }
+  return false;
+}
+
+// ___________________________________________________________________________//
+
+void FiniteLyapunovExponents::UpdateSharedCells(
+    size_t first, const size_t last,
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle) {
+  const auto stencil_size = particles_.stencil_size();
+  int64_t nodes[5];
+
+  for (; first < last; ++first) {
+    auto index = shared_cells_[first];
+    auto missing = false;
+
+    for (size_t k = 0; k < stencil_size; ++k) {
+      nodes[k] = GetNode(index, k);
+      missing |= nodes_.IsMissing(nodes[k]);
+    }
+
+    // As for a stencil, the cell is undefined if one of its points could not
+    // be moved.
+    if (missing) {
+      particles_.Missing(index);
+      continue;
+    }
+
+    for (size_t k = 0; k < stencil_size; ++k) {
+      particles_.SetPoint(k, index, nodes_.get_x(0, nodes[k]),
+                          nodes_.get_y(0, nodes[k]));
+    }
+    particles_.set_time(index, nodes_.get_time(index));
+
+    if (fle.Separation(particles_, index)) {
+      particles_.set_completed(index);
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+void FiniteLyapunovExponents::ComputeHt(
+    const size_t first, const size_t last,
+    const FiniteLyapunovExponentsEngine &engine, Iterator &it) {
+  // Creating an object containing the properties of the interpolation
+  CellProperties cell;
+
+  engine.Compute(it, particles_, indexes_.data() + first, last - first, cell);
+}
+
+// ___________________________________________________________________________//
+
+void FiniteLyapunovExponents::Compute(
+    lagrangian::FiniteLyapunovExponentsIntegration &fle, int num_threads,
+    Checkpoint *const checkpoint) {
+  const auto start = fle.GetIterator();
+  auto it = start;
+  Skip(it, steps_);
+  auto engine = FiniteLyapunovExponentsEngine::Create(fle);
+  ThreadPool pool(num_threads);
 
   // Number of cells to process
   double items = map_.get_nx() * map_.get_ny();
-  auto splitters = indexes_.Split(num_threads);
 
   while (it.GoAfter()) {
-    fle.Fetch(it());
+    fle.Fetch(it(), pool);
 
     auto date =
         DateTime(DateTime::FromUnixTime(it())).ToString("%Y-%m-%d %H:%M:%S");
 
     Debug(str(boost::format("Start time step %s (%d cells)") % date %
-              indexes_.size()));
-
-    for (auto &item : splitters) {
-      threads.emplace_back(
-          std::thread(&lagrangian::map::FiniteLyapunovExponents::ComputeHt,
-                      this, std::ref(item), std::ref(fle), std::ref(it)));
-    }
-
-    for (auto &item : threads) {
-      item.join();
+              (indexes_.size() + shared_cells_.size())));
+
+    pool.ParallelFor(
+        indexes_.size(),
+        [&](const size_t first, const size_t last, size_t /*worker*/) {
+          ComputeHt(first, last, *engine, it);
+        },
+        kCellsPerTask);
+
+    // The shared nodes are moved once, then the cells built on them are
+    // updated.
+    if (!shared_cells_.empty()) {
+      pool.ParallelFor(
+          active_nodes_.size(),
+          [&](const size_t first, const size_t last, size_t /*worker*/) {
+            CellProperties cell;
+            engine->Move(it, nodes_, active_nodes_.data() + first,
+                         last - first, cell);
+          },
+          kCellsPerTask);
+
+      pool.ParallelFor(
+          shared_cells_.size(),
+          [&](const size_t first, const size_t last, size_t /*worker*/) {
+            UpdateSharedCells(first, last, fle);
+          },
+          kCellsPerTask);
     }
-    threads.clear();
 
     // Removing cells that are completed
-    splitters = indexes_.Erase(std::bind(&FiniteLyapunovExponents::Completed,
-                                         this, std::placeholders::_1),
-                               num_threads);
+    indexes_.Erase(
+        [this](const size_t index) -> bool { return Completed(index); }, pool);
+    shared_cells_.Erase(
+        [this](const size_t index) -> bool { return Completed(index); }, pool);
+
+    // Removing nodes that are no longer used
+    active_nodes_.Erase(
+        [this](const size_t node) -> bool {
+          return nodes_.IsMissing(node) || !IsNodeUsed(node);
+        },
+        pool);
 
     Debug(str(boost::format("Close time step %s (%.02f%% completed)") % date %
-              ((items - indexes_.size()) / items * 100)));
+              ((items - indexes_.size() - shared_cells_.size()) / items *
+               100)));
 
     ++it;
+    WriteCheckpoint(checkpoint, ++steps_,
+                    [&]() -> Archive { return Save(fle, start); });
   }
+  if (checkpoint != nullptr) {
+    checkpoint->Wait();
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto FiniteLyapunovExponents::Save(
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+    const Iterator &start) const -> Archive {
+  Archive result;
+  WriteHeader(result, kFiniteLyapunovExponentsCheckpoint, map_, start,
+              steps_);
+  WriteIntegration(result, fle, particles_);
+  particles_.Write(result);
+  indexes_.Write(result);
+  shared_cells_.Write(result);
+  nodes_.Write(result);
+  active_nodes_.Write(result);
+  result.Write(shared_);
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void FiniteLyapunovExponents::Restart(
+    const lagrangian::FiniteLyapunovExponentsIntegration &fle,
+    const std::string &filename) {
+  auto archive = Archive::Load(filename);
+  auto steps = ReadHeader(archive, kFiniteLyapunovExponentsCheckpoint, map_,
+                          fle.GetIterator());
+  ReadIntegration(archive, fle, particles_);
+  Particles particles;
+  ActiveSet indexes;
+  ActiveSet shared_cells;
+  Particles nodes;
+  ActiveSet active_nodes;
+  std::vector<uint8_t> shared;
+
+  particles.Read(archive);
+  indexes.Read(archive);
+  shared_cells.Read(archive);
+  nodes.Read(archive);
+  active_nodes.Read(archive);
+  archive.Read(shared);
+
+  const auto size = static_cast<size_t>(map_.get_nx()) * map_.get_ny();
+  if (particles.size() != size ||
+      (!shared_cells.empty() &&
+       (nodes.size() != size || shared.size() != size))) {
+    throw std::runtime_error("truncated or corrupted checkpoint");
+  }
+  CheckCells(indexes, size);
+  CheckCells(shared_cells, size);
+  CheckCells(active_nodes, nodes.size());
+
+  particles_ = std::move(particles);
+  indexes_ = std::move(indexes);
+  shared_cells_ = std::move(shared_cells);
+  nodes_ = std::move(nodes);
+  active_nodes_ = std::move(active_nodes);
+  shared_ = std::move(shared);
+  steps_ = steps;
 }
 
 // ___________________________________________________________________________//
@@ -155,68 +554,86 @@ void Advect::Initialize(Integration &integration,
   CellProperties cell;
   auto spherical_equatorial = integration.get_field()->get_coordinates_type() ==
                               Field::kSphericalEquatorial;
-  auto start_time = integration.get_start_time();
 
-  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
-    for (auto iy = 0; iy < map_.get_ny(); ++iy) {
-      // If the user restart initialization, it must release the
-      // allocated resources
-      auto position = map_.GetItem(ix, iy);
-      delete position;
+  // If the user restart initialization, the previous particles are released
+  particles_ = Particles(static_cast<size_t>(map_.get_nx()) * map_.get_ny(), 1,
+                         integration.get_start_time(), spherical_equatorial);
+  indexes_.clear();
+  indexes_.reserve(particles_.size());
+  steps_ = 0;
 
-      // Allocate and store the new stencil
-      position = new Point(map_.GetXValue(ix), map_.GetYValue(iy), start_time,
-                           spherical_equatorial);
+  size_t index = 0;
+
+  for (auto ix = 0; ix < map_.get_nx(); ++ix) {
+    for (auto iy = 0; iy < map_.get_ny(); ++iy, ++index) {
+      particles_.SetStencil(index, map_.GetXValue(ix), map_.GetYValue(iy), 0);
 
       if (reader.has_value() &&
           std::isnan((*reader)->Interpolate(
               map_.GetXValue(ix), map_.GetYValue(iy),
               std::numeric_limits<double>::quiet_NaN(), cell))) {
-        position->set_completed();
+        particles_.set_completed(index);
       } else {
-        indexes_.push_back(Index(ix, iy));
+        indexes_.push_back(index);
       }
-      map_.SetItem(ix, iy, position);
     }
   }
 }
 
 // ___________________________________________________________________________//
 
-void Advect::ComputeHt(Splitter<Index> &splitter, const RungeKutta &rk4,
-                       Iterator &it) {
+void Advect::ComputeHt(const size_t first, const size_t last,
+                       const RungeKutta &rk4, Iterator &it) {
   // Creating an object containing the properties of the interpolation
   CellProperties cell;
 
-  auto first = splitter.begin();
-  while (first != splitter.end()) {
-    auto ix = first->get_i();
-    auto iy = first->get_j();
-    auto position = map_.GetItem(ix, iy);
+  particles_.Compute(rk4, it, indexes_.data() + first, last - first, cell);
+}
 
-    if (!position->Compute(rk4, it, cell)) {
-      position->Missing();
-    }
-    ++first;
-  }
+// ___________________________________________________________________________//
+
+void Advect::Compute(Integration &integration, int num_threads,
+                     Checkpoint *const checkpoint) {
+  Compute(integration, num_threads, {}, 0, nullptr, checkpoint);
 }
 
 // ___________________________________________________________________________//
 
-void Advect::Compute(Integration &integration, int num_threads) {
-  auto it = integration.GetIterator();
-  std::list<std::thread> threads;
+void Advect::Compute(Integration &integration, int num_threads,
+                     const std::vector<double> &dates, const double fill_value,
+                     const Observer &observer, Checkpoint *const checkpoint) {
+  const auto start = integration.GetIterator();
+  auto it = start;
+
+  // Number of dates reached by the integration, including the date reached
+  // after the last time step.
+  size_t dates_reached = 1;
+  for (auto item = it; item.GoAfter(); ++item) {
+    ++dates_reached;
+  }
 
-  if (num_threads == 0) {
-    num_threads = std::thread::hardware_concurrency();
+  // Index of the time step at which each snapshot is taken
+  std::vector<size_t> steps;
+  steps.reserve(dates.size());
+  for (auto date : dates) {
+    auto step = std::round((date - it()) / it.inc());
+    if (step < 0 || step >= dates_reached ||
+        std::abs(it() + step * it.inc() - date) > kDateTolerance) {
+      throw std::invalid_argument(
+          "the date of a snapshot must be a date of the integration");
+    }
+    steps.push_back(static_cast<size_t>(step));
   }
 
+  ThreadPool pool(num_threads);
+  Skip(it, steps_);
+
   // Number of cells to process
   double items = map_.get_nx() * map_.get_ny();
-  auto splitters = indexes_.Split(num_threads);
 
   while (it.GoAfter()) {
-    integration.Fetch(it());
+    Snapshot(steps_, steps, fill_value, observer, pool);
+    integration.Fetch(it(), pool);
 
     auto date =
         DateTime(DateTime::FromUnixTime(it())).ToString("%Y-%m-%d %H:%M:%S");
@@ -224,27 +641,279 @@ void Advect::Compute(Integration &integration, int num_threads) {
     Debug(str(boost::format("Start time step %s (%d cells)") % date %
               indexes_.size()));
 
-    for (auto &item : splitters) {
-      threads.emplace_back(
-          std::thread(&lagrangian::map::Advect::ComputeHt, this, std::ref(item),
-                      std::ref(integration.get_rk4()), std::ref(it)));
-    }
-
-    for (auto &item : threads) {
-      item.join();
-    }
-    threads.clear();
+    pool.ParallelFor(
+        indexes_.size(),
+        [&](const size_t first, const size_t last, size_t /*worker*/) {
+          ComputeHt(first, last, integration.get_rk4(), it);
+        },
+        kCellsPerTask);
 
     // Removing cells that are completed
-    splitters = indexes_.Erase(
-        std::bind(&Advect::Completed, this, std::placeholders::_1),
-        num_threads);
+    indexes_.Erase(
+        [this](const size_t index) -> bool { return Completed(index); }, pool);
 
     Debug(str(boost::format("Close time step %s (%.02f%% completed)") % date %
               ((items - indexes_.size()) / items * 100)));
 
     ++it;
+    WriteCheckpoint(checkpoint, ++steps_,
+                    [&]() -> Archive { return Save(start); });
   }
+  Snapshot(steps_, steps, fill_value, observer, pool);
+  if (checkpoint != nullptr) {
+    checkpoint->Wait();
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto Advect::Save(const Iterator &start) const -> Archive {
+  Archive result;
+  WriteHeader(result, kAdvectCheckpoint, map_, start, steps_);
+  particles_.Write(result);
+  indexes_.Write(result);
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void Advect::Restart(const Integration &integration,
+                     const std::string &filename) {
+  auto archive = Archive::Load(filename);
+  auto steps =
+      ReadHeader(archive, kAdvectCheckpoint, map_, integration.GetIterator());
+  Particles particles;
+  ActiveSet indexes;
+
+  particles.Read(archive);
+  indexes.Read(archive);
+
+  if (particles.size() !=
+      static_cast<size_t>(map_.get_nx()) * map_.get_ny()) {
+    throw std::runtime_error("truncated or corrupted checkpoint");
+  }
+  CheckCells(indexes, particles.size());
+
+  particles_ = std::move(particles);
+  indexes_ = std::move(indexes);
+  steps_ = steps;
+}
+
+// ___________________________________________________________________________//
+
+void Advect::Snapshot(const size_t step, const std::vector<size_t> &steps,
+                      const double fill_value, const Observer &observer,
+                      ThreadPool &pool) {
+  auto copied = false;
+
+  for (size_t ix = 0; ix < steps.size(); ++ix) {
+    if (steps[ix] != step) {
+      continue;
+    }
+    if (!copied) {
+      x_.resize(particles_.size());
+      y_.resize(particles_.size());
+      pool.ParallelFor(
+          particles_.size(),
+          [&](const size_t first, const size_t last, size_t /*worker*/) {
+            for (auto index = first; index < last; ++index) {
+              if (particles_.IsMissing(index)) {
+                x_[index] = y_[index] = fill_value;
+              } else {
+                x_[index] = particles_.get_x(0, index);
+                y_[index] = particles_.get_y(0, index);
+              }
+            }
+          },
+          kCellsPerTask);
+      copied = true;
+    }
+    observer(ix, x_.data(), y_.data());
+  }
+}
+
+// ___________________________________________________________________________//
+
+// Get the map of a coordinate of the particles
+template <typename Getter>
+static auto GetMapOfCoordinate(const MapProperties &map,
+                               const Particles &particles,
+                               const double fill_value, const Getter &getter)
+    -> std::unique_ptr<Map<double>> {
+  auto result =
+      std::make_unique<Map<double>>(map.get_nx(), map.get_ny(), map.get_x_min(),
+                                    map.get_y_min(), map.get_step());
+  auto *data = result->data();
+
+  for (size_t index = 0; index < particles.size(); ++index) {
+    data[index] =
+        particles.IsMissing(index) ? fill_value : getter(particles, index);
+  }
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+auto Advect::GetMapOfX(const double fill_value) const
+    -> std::unique_ptr<Map<double>> {
+  return GetMapOfCoordinate(
+      map_, particles_, fill_value,
+      [](const Particles &particles, const size_t index) -> double {
+        return particles.get_x(0, index);
+      });
+}
+
+// ___________________________________________________________________________//
+
+auto Advect::GetMapOfY(const double fill_value) const
+    -> std::unique_ptr<Map<double>> {
+  return GetMapOfCoordinate(
+      map_, particles_, fill_value,
+      [](const Particles &particles, const size_t index) -> double {
+        return particles.get_y(0, index);
+      });
 }
 
 }  // namespace lagrangian::map
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+using GetExponent = double (lagrangian::FiniteLyapunovExponents::*)() const;
+
+/// Functions returning the value of each map and its default value when the
+/// computation of the cell is not over, indexed by
+/// MapOfFiniteLyapunovExponents::Output
+static const std::pair<GetExponent, GetExponent> kGetters[] = {
+    {&FiniteLyapunovExponents::get_lambda1,
+     &FiniteLyapunovExponents::GetUndefinedExponent},
+    {&FiniteLyapunovExponents::get_lambda2,
+     &FiniteLyapunovExponents::GetUndefinedExponent},
+    {&FiniteLyapunovExponents::get_theta1,
+     &FiniteLyapunovExponents::GetUndefinedVector},
+    {&FiniteLyapunovExponents::get_theta2,
+     &FiniteLyapunovExponents::GetUndefinedVector},
+    {&FiniteLyapunovExponents::get_delta_t,
+     &FiniteLyapunovExponents::GetUndefinedDeltaT},
+    {&FiniteLyapunovExponents::get_final_separation,
+     &FiniteLyapunovExponents::GetUndefinedFinalSeparation}};
+
+// ___________________________________________________________________________//
+
+void MapOfFiniteLyapunovExponents::ComputeMaps(
+    const std::vector<Output> &outputs, const double nan,
+    lagrangian::FiniteLyapunovExponentsIntegration &fle_integration,
+    double *const result, const int num_threads) const {
+  auto cells = particles_.size();
+
+  // In FTLE mode, all the cells are always completed
+  auto ftle = fle_integration.get_mode() ==
+              lagrangian::FiniteLyapunovExponentsIntegration::kFTLE;
+
+  ThreadPool pool(num_threads);
+  pool.ParallelFor(
+      cells,
+      [&](size_t first, const size_t last, size_t /*worker*/) {
+        lagrangian::FiniteLyapunovExponents fle{};
+
+        for (; first < last; ++first) {
+          if (particles_.IsMissing(first)) {
+            for (size_t ix = 0; ix < outputs.size(); ++ix) {
+              result[ix * cells + first] = nan;
+            }
+            continue;
+          }
+
+          auto defined =
+              fle_integration.ComputeExponents(particles_, first, fle);
+          auto completed = ftle || particles_.is_completed(first);
+
+          for (size_t ix = 0; ix < outputs.size(); ++ix) {
+            const auto &getter = kGetters[outputs[ix]];
+            result[ix * cells + first] =
+                !completed ? (fle.*getter.second)()
+                : defined  ? (fle.*getter.first)()
+                           : std::numeric_limits<double>::quiet_NaN();
+          }
+        }
+      },
+      map::kCellsPerTask);
+}
+
+// ___________________________________________________________________________//
+
+auto TiledMapOfFiniteLyapunovExponents::GetMemoryPerCell(
+    const lagrangian::FiniteLyapunovExponentsIntegration::Stencil stencil,
+    const bool shared_nodes, const size_t outputs) -> size_t {
+  const auto points =
+      lagrangian::FiniteLyapunovExponentsIntegration::GetStencilSize(stencil);
+
+  // Points, time and state of a stencil, then its index in the active set
+  // and in the buffer of compaction
+  auto result = points * 2 * sizeof(double) + sizeof(double) +
+                sizeof(uint8_t) + 2 * sizeof(size_t);
+
+  // Node advected, its active set and the flags of the shared cells
+  if (shared_nodes) {
+    result += 2 * sizeof(double) + sizeof(double) + 3 * sizeof(uint8_t) +
+              2 * sizeof(size_t);
+  }
+  return result + outputs * sizeof(double);
+}
+
+// ___________________________________________________________________________//
+
+auto TiledMapOfFiniteLyapunovExponents::GetTileSize(
+    const size_t memory_budget, const size_t outputs) const -> int {
+  auto column = static_cast<size_t>(map_.get_ny()) *
+                GetMemoryPerCell(stencil_, shared_nodes_, outputs);
+  auto result = memory_budget / column;
+  if (result == 0) {
+    throw std::invalid_argument(
+        "the memory budget is too small to compute a longitude of the map");
+  }
+  return static_cast<int>(
+      std::min(result, static_cast<size_t>(map_.get_nx())));
+}
+
+// ___________________________________________________________________________//
+
+void TiledMapOfFiniteLyapunovExponents::Compute(
+    lagrangian::FiniteLyapunovExponentsIntegration &fle,
+    const std::vector<MapOfFiniteLyapunovExponents::Output> &outputs,
+    const double nan, const size_t memory_budget, const int num_threads,
+    const Observer &observer) const {
+  const auto columns = GetTileSize(memory_budget, outputs.size());
+  const auto tiles = (map_.get_nx() + columns - 1) / columns;
+  std::vector<double> maps;
+
+  // Each tile runs the whole integration again: the grids of the velocity
+  // field loaded by the first tile are kept in memory for the next ones.
+  GridCache::Pin pin;
+
+  for (auto ix = 0; ix < map_.get_nx(); ix += columns) {
+    const auto nx = std::min(columns, map_.get_nx() - ix);
+
+    Debug(str(boost::format("Start tile %d/%d (%d longitudes)") %
+              (ix / columns + 1) % tiles % nx));
+
+    // The stencils of the tile are released before the next tile starts
+    {
+      MapOfFiniteLyapunovExponents tile(nx, map_.get_ny(), map_.GetXValue(ix),
+                                        map_.get_y_min(), map_.get_step());
+      if (reader_ != nullptr) {
+        tile.Initialize(fle, reader_, stencil_, shared_nodes_);
+      } else {
+        tile.Initialize(fle, stencil_, shared_nodes_);
+      }
+      tile.Compute(fle, num_threads);
+
+      maps.resize(outputs.size() * nx * map_.get_ny());
+      tile.ComputeMaps(outputs, nan, fle, maps.data(), num_threads);
+    }
+    observer(ix, nx, maps.data());
+  }
+}
+
+}  // namespace lagrangian
@@ -89,6 +89,44 @@ void Variable::Read(std::vector<double> &data, const std::string &to) const {
 
 // ___________________________________________________________________________//
 
+void Variable::Read(std::vector<double> &data,
+                    const std::vector<size_t> &start,
+                    const std::vector<size_t> &count) const {
+  size_t size = 1;
+  for (auto item : count) {
+    size *= item;
+  }
+  data.resize(size);
+  if (size == 0) {
+    return;
+  }
+  ncvar_.getVar(start, count, &data[0]);
+
+  // Set "missing" data to nan
+  scale_missing_.SetMissingToNan(data);
+
+  // Convert data with scale and offset
+  scale_missing_.ConvertScaleOffset(data);
+}
+
+// ___________________________________________________________________________//
+
+void Variable::Read(std::vector<double> &data,
+                    const std::vector<size_t> &start,
+                    const std::vector<size_t> &count,
+                    const std::string &to) const {
+  std::string from;
+
+  if (!GetUnitsString(from)) {
+    throw std::logic_error(name_ + ":" + CF::UNITS + ": no such attribute");
+  }
+
+  Read(data, start, count);
+  Units::GetConverter(from, to).Convert(data);
+}
+
+// ___________________________________________________________________________//
+
 Variable::Variable(const netCDF::NcVar &ncvar)
     : name_(ncvar.getName()), ncvar_(ncvar) {
   // Set globals attributes
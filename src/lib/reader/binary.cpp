@@ -0,0 +1,354 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/reader/binary.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LAGRANGIAN_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/units.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian::reader {
+
+/// Size of a memory page: alignment of the values stored in the file
+static const size_t kPageSize = 4096;
+
+/// Maximum length of the strings stored in the header
+static const size_t kStringSize = 64;
+
+/// Identifies the binary grids
+static const char kMagic[8] = {'L', 'A', 'G', 'R', 'B', 'I', 'N', '\0'};
+
+/// Version of the file format. Also used to detect a file written with
+/// another byte order.
+static const uint32_t kVersion = 1;
+
+/**
+ * @brief Header of a binary grid, stored in the first page of the file.
+ *
+ * It is followed by the points of the X and Y axes, then, on the next page
+ * boundary, by the values of the grid: the components of the node (ix, iy)
+ * are stored at the index (ix * ny + iy) * components.
+ */
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t components;
+  uint64_t nx;
+  uint64_t ny;
+  uint32_t x_type;
+  uint32_t y_type;
+  int64_t date;
+  char x_unit[kStringSize];
+  char y_unit[kStringSize];
+  char unit[kStringSize];
+  char variables[2][kStringSize];
+};
+
+static_assert(sizeof(BinaryHeader) <= kPageSize);
+
+// Offset of the values of the grid in the file
+static inline auto DataOffset(const BinaryHeader &header) -> size_t {
+  auto size = kPageSize + (header.nx + header.ny) * sizeof(double);
+  return (size + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+// Copy a string into a field of the header
+static void SetString(char *target, const std::string &value) {
+  if (value.size() >= kStringSize) {
+    throw std::invalid_argument(value + ": string too long");
+  }
+  std::strncpy(target, value.c_str(), kStringSize);
+}
+
+// Get a string stored in the header
+static auto GetString(const char *source) -> std::string {
+  return {source, strnlen(source, kStringSize)};
+}
+
+// ___________________________________________________________________________//
+
+// Read-only content of a file
+struct FileContent {
+  const char *address{nullptr};
+  size_t length{0};
+#ifdef LAGRANGIAN_MMAP
+  ~FileContent() {
+    if (address != nullptr) {
+      munmap(const_cast<char *>(address), length);
+    }
+  }
+#else
+  std::vector<char> buffer;
+#endif
+};
+
+// Map a file into memory, or read it if the system does not support it
+static auto MapFile(const std::string &filename)
+    -> std::shared_ptr<FileContent> {
+  auto result = std::make_shared<FileContent>();
+#ifdef LAGRANGIAN_MMAP
+  auto fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(), filename);
+  }
+  struct stat status {};
+  if (fstat(fd, &status) == -1) {
+    auto err = errno;
+    close(fd);
+    throw std::system_error(err, std::generic_category(), filename);
+  }
+  result->length = static_cast<size_t>(status.st_size);
+  auto address = result->length == 0
+                     ? MAP_FAILED
+                     : mmap(nullptr, result->length, PROT_READ, MAP_SHARED,
+                            fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    throw std::runtime_error(filename + ": unable to map the file");
+  }
+  result->address = static_cast<const char *>(address);
+#else
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    throw std::runtime_error(filename + ": unable to open the file");
+  }
+  result->buffer.resize(static_cast<size_t>(stream.tellg()));
+  stream.seekg(0);
+  stream.read(result->buffer.data(), result->buffer.size());
+  result->address = result->buffer.data();
+  result->length = result->buffer.size();
+#endif
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void Binary::Open(const std::string &filename) {
+  auto content = MapFile(filename);
+
+  BinaryHeader header{};
+  if (content->length < kPageSize) {
+    throw std::runtime_error(filename + ": not a binary grid");
+  }
+  std::memcpy(&header, content->address, sizeof(BinaryHeader));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(filename + ": not a binary grid");
+  }
+  if (header.version != kVersion) {
+    throw std::runtime_error(filename +
+                             ": unsupported version or byte order of the "
+                             "binary grid");
+  }
+  if (header.components < 1 || header.components > 2 ||
+      content->length < DataOffset(header) + header.nx * header.ny *
+                                                 header.components *
+                                                 sizeof(double)) {
+    throw std::runtime_error(filename + ": truncated or corrupted file");
+  }
+
+  auto points = reinterpret_cast<const double *>(content->address + kPageSize);
+  axis_x_ = Axis(std::vector<double>(points, points + header.nx),
+                 static_cast<Axis::Type>(header.x_type),
+                 GetString(header.x_unit));
+  axis_y_ = Axis(std::vector<double>(points + header.nx,
+                                     points + header.nx + header.ny),
+                 static_cast<Axis::Type>(header.y_type),
+                 GetString(header.y_unit));
+
+  variables_.clear();
+  for (uint32_t ix = 0; ix < header.components; ++ix) {
+    variables_.emplace_back(GetString(header.variables[ix]));
+  }
+  unit_ = GetString(header.unit);
+  date_ = header.date;
+  values_ = reinterpret_cast<const double *>(content->address +
+                                             DataOffset(header));
+  filename_ = filename;
+  mapping_ = std::move(content);
+  data_ = nullptr;
+  components_ = 1;
+}
+
+// ___________________________________________________________________________//
+
+auto Binary::FindComponent(const std::string &name) const -> size_t {
+  for (size_t ix = 0; ix < variables_.size(); ++ix) {
+    if (variables_[ix] == name) {
+      return ix;
+    }
+  }
+  throw std::logic_error(name + ": no such variable");
+}
+
+// ___________________________________________________________________________//
+
+auto Binary::Read(const std::vector<size_t> &components,
+                  const std::string &unit) -> std::shared_ptr<const Grid> {
+  if (mapping_ == nullptr) {
+    throw std::logic_error("No binary grid opened");
+  }
+
+  UnitConverter converter;
+  if (!unit.empty() && unit != unit_) {
+    if (unit_.empty()) {
+      throw std::logic_error(filename_ +
+                             ": the unit of the grid is undefined");
+    }
+    converter = Units::GetConverter(unit_, unit);
+  }
+
+  auto nodes = static_cast<size_t>(axis_x_.GetNumElements()) *
+               static_cast<size_t>(axis_y_.GetNumElements());
+  auto stride = variables_.size();
+
+  // The values stored are used as they are.
+  auto identity = components.size() == stride && converter.IsNull() &&
+                  storage_ == Grid::kFloat64;
+  for (size_t ix = 0; identity && ix < components.size(); ++ix) {
+    identity = components[ix] == ix;
+  }
+  if (identity) {
+    return std::make_shared<const Grid>(values_, nodes * stride, mapping_);
+  }
+
+  std::vector<double> values(nodes * components.size());
+  for (size_t ix = 0; ix < nodes; ++ix) {
+    for (size_t jx = 0; jx < components.size(); ++jx) {
+      auto value = values_[ix * stride + components[jx]];
+      converter.Convert(value);
+      values[ix * components.size() + jx] = value;
+    }
+  }
+  return std::make_shared<const Grid>(std::move(values), storage_);
+}
+
+// ___________________________________________________________________________//
+
+void Binary::Load(const std::string &varname, const std::string &unit) {
+  data_ = Read({FindComponent(varname)}, unit);
+  pGetIndex_ = &Binary::GetIndexXY;
+  components_ = 1;
+}
+
+// ___________________________________________________________________________//
+
+void Binary::LoadVector(const std::string &u_name, const std::string &v_name,
+                        const std::string &unit) {
+  data_ = Read({FindComponent(u_name), FindComponent(v_name)}, unit);
+  pGetIndex_ = &Binary::GetIndexXY;
+  components_ = 2;
+}
+
+// ___________________________________________________________________________//
+
+auto Binary::GetDateTime(const std::string &name) const -> DateTime {
+  // Checks that the variable exists
+  FindComponent(name);
+  return DateTime::FromUnixTime(static_cast<long double>(date_) * 1e-6L);
+}
+
+// ___________________________________________________________________________//
+
+void Binary::Convert(const std::string &source, const std::string &u_name,
+                     const std::string &v_name, const std::string &unit,
+                     const std::string &target) {
+  Binary grid;
+  grid.NetCDF::Open(source);
+  if (v_name.empty()) {
+    grid.NetCDF::Load(u_name, unit);
+  } else {
+    grid.NetCDF::LoadVector(u_name, v_name, unit);
+  }
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.components = static_cast<uint32_t>(grid.components_);
+  header.nx = static_cast<uint64_t>(grid.axis_x_.GetNumElements());
+  header.ny = static_cast<uint64_t>(grid.axis_y_.GetNumElements());
+  header.x_type = static_cast<uint32_t>(grid.axis_x_.get_type());
+  header.y_type = static_cast<uint32_t>(grid.axis_y_.get_type());
+  header.date = std::llround(grid.NetCDF::GetDateTime(u_name).ToUnixTime() *
+                             1e6L);
+
+  std::string axis_unit;
+  if (grid.axis_x_.get_units(axis_unit)) {
+    SetString(header.x_unit, axis_unit);
+  }
+  if (grid.axis_y_.get_units(axis_unit)) {
+    SetString(header.y_unit, axis_unit);
+  }
+  SetString(header.unit, unit);
+  SetString(header.variables[0], u_name);
+  if (!v_name.empty()) {
+    SetString(header.variables[1], v_name);
+  }
+
+  std::ofstream stream(target, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw std::runtime_error(target + ": unable to create the file");
+  }
+
+  std::vector<char> page(kPageSize, 0);
+  std::memcpy(page.data(), &header, sizeof(BinaryHeader));
+  stream.write(page.data(), kPageSize);
+
+  std::vector<double> points;
+  for (auto axis : {&grid.axis_x_, &grid.axis_y_}) {
+    for (auto ix = 0; ix < axis->GetNumElements(); ++ix) {
+      points.push_back(axis->GetCoordinateValue(ix));
+    }
+  }
+  stream.write(reinterpret_cast<const char *>(points.data()),
+               static_cast<std::streamsize>(points.size() * sizeof(double)));
+  stream.write(page.data(), static_cast<std::streamsize>(
+                                DataOffset(header) - kPageSize -
+                                points.size() * sizeof(double)));
+
+  // The values are stored in the order [X, Y] whatever the layout of the
+  // NetCDF variable
+  std::vector<double> row(header.ny * header.components);
+  for (uint64_t ix = 0; ix < header.nx; ++ix) {
+    for (uint64_t iy = 0; iy < header.ny; ++iy) {
+      auto node = grid.GetNode(static_cast<int>(ix), static_cast<int>(iy));
+      for (size_t jx = 0; jx < header.components; ++jx) {
+        row[iy * header.components + jx] = grid.data_->Get(node + jx);
+      }
+    }
+    stream.write(reinterpret_cast<const char *>(row.data()),
+                 static_cast<std::streamsize>(row.size() * sizeof(double)));
+  }
+
+  if (!stream.flush()) {
+    throw std::runtime_error(target + ": unable to write the file");
+  }
+}
+
+}  // namespace lagrangian::reader
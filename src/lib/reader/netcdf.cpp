@@ -14,10 +14,27 @@
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
 #include "lagrangian/reader/netcdf.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+
+// ___________________________________________________________________________//
+
+#include "lagrangian/simd.hpp"
+
 // ___________________________________________________________________________//
 
 namespace lagrangian::reader {
 
+/// Number of points interpolated at once by NetCDF::InterpolateMany
+static const size_t kBlockSize = 64;
+
+/// Number of values combined at once by the threads of NetCDF::Blend
+static const size_t kValuesPerTask = 16384;
+
+// ___________________________________________________________________________//
+
 static inline double BilinearInterpolation(const double x0, const double x1,
                                            const double y0, const double y1,
                                            const double z00, const double z10,
@@ -35,8 +52,67 @@ static inline double BilinearInterpolation(const double x0, const double x1,
 
 // ___________________________________________________________________________//
 
+/**
+ * @brief Parameters of the bilinear interpolation of a block of points
+ *
+ * The points outside the grid are placed in the cell [0, 1]² whose four
+ * corners are set to the fill value.
+ */
+struct BilinearWeights {
+  double dx0[kBlockSize];
+  double dx1[kBlockSize];
+  double dy0[kBlockSize];
+  double dy1[kBlockSize];
+  double area[kBlockSize];
+
+  // Set the parameters of the point #ix located in the cell
+  inline void Set(const size_t ix, const double x, const double y,
+                  const CellProperties &cell) noexcept {
+    dx0[ix] = x - cell.x0();
+    dx1[ix] = cell.x1() - x;
+    dy0[ix] = y - cell.y0();
+    dy1[ix] = cell.y1() - y;
+    area[ix] = (cell.x1() - cell.x0()) * (cell.y1() - cell.y0());
+  }
+
+  // Set the parameters of the point #ix located outside the grid
+  inline void SetOutside(const size_t ix) noexcept {
+    dx0[ix] = dy0[ix] = 0;
+    dx1[ix] = dy1[ix] = area[ix] = 1;
+  }
+
+  // Interpolates the values of the n first points of the block from the
+  // values of the corners of their cells
+  void Interpolate(const size_t n, const double *const z00,
+                   const double *const z10, const double *const z01,
+                   const double *const z11, double *const z) const noexcept {
+    const auto last = simd::VectorizableSize(n);
+    size_t ix = 0;
+
+    for (; ix < last; ix += simd::kWidth) {
+      const auto vdx0 = simd::Load(dx0 + ix);
+      const auto vdx1 = simd::Load(dx1 + ix);
+      const auto a = simd::Add(simd::Mul(vdx1, simd::Load(z00 + ix)),
+                               simd::Mul(vdx0, simd::Load(z10 + ix)));
+      const auto b = simd::Add(simd::Mul(vdx1, simd::Load(z01 + ix)),
+                               simd::Mul(vdx0, simd::Load(z11 + ix)));
+      const auto c = simd::Add(simd::Mul(simd::Load(dy1 + ix), a),
+                               simd::Mul(simd::Load(dy0 + ix), b));
+      simd::Store(z + ix, simd::Div(c, simd::Load(area + ix)));
+    }
+    for (; ix < n; ++ix) {
+      z[ix] = (dy1[ix] * (dx1[ix] * z00[ix] + dx0[ix] * z10[ix]) +
+               dy0[ix] * (dx1[ix] * z01[ix] + dx0[ix] * z11[ix])) /
+              area[ix];
+    }
+  }
+};
+
+// ___________________________________________________________________________//
+
 void NetCDF::Open(const std::string &filename) {
   netcdf_ = lagrangian::NetCDF(filename);
+  filename_ = filename;
 
   auto variables = netcdf_.get_variables();
   auto it = variables.begin();
@@ -83,6 +159,201 @@ void NetCDF::Open(const std::string &filename) {
   if (axis_y_.get_type() == Axis::kLatitude) {
     axis_y_.Convert("degrees");
   }
+
+  ny_ = static_cast<size_t>(axis_y_.GetNumElements());
+  SelectRegion();
+}
+
+// ___________________________________________________________________________//
+
+void NetCDF::SetBoundingBox(const double x_min, const double x_max,
+                            const double y_min, const double y_max) {
+  if (!(x_min <= x_max && y_min <= y_max)) {
+    throw std::invalid_argument("invalid bounding box");
+  }
+  bounding_box_ = {x_min, x_max, y_min, y_max};
+  bounded_ = true;
+}
+
+// ___________________________________________________________________________//
+
+/**
+ * @brief Get the range of the indexes of an axis covering the interval
+ * [min, max] and the nodes surrounding it.
+ *
+ * @param axis Axis to process
+ * @param min Lower bound of the interval
+ * @param max Upper bound of the interval
+ *
+ * @return the index of the first node and the number of nodes
+ */
+static auto AxisRange(const Axis &axis, const double min, const double max)
+    -> std::pair<size_t, size_t> {
+  auto i0 = axis.FindIndexBounded(min);
+  auto i1 = axis.FindIndexBounded(max);
+
+  if (i0 > i1) {
+    std::swap(i0, i1);
+  }
+  i0 = std::max(i0 - 1, 0);
+  i1 = std::min(i1 + 1, axis.GetNumElements() - 1);
+  return {static_cast<size_t>(i0), static_cast<size_t>(i1 - i0 + 1)};
+}
+
+// ___________________________________________________________________________//
+
+/**
+ * @brief Builds the axis made of the nodes of the ranges of an axis. The
+ * nodes of the second range, located after the end of a longitude axis, are
+ * shifted by one turn.
+ *
+ * @param axis Axis to process
+ * @param ranges Ranges [first, first + count) of indexes
+ *
+ * @return the axis built
+ */
+static auto AxisSubset(const Axis &axis,
+                       const std::vector<std::pair<size_t, size_t>> &ranges)
+    -> Axis {
+  std::vector<double> points;
+  std::string unit;
+  double shift = 0;
+
+  for (const auto &[first, count] : ranges) {
+    for (auto ix = first; ix < first + count; ++ix) {
+      points.push_back(axis.GetCoordinateValue(static_cast<int>(ix)) + shift);
+    }
+    shift = axis.get_increment() > 0 ? 360 : -360;
+  }
+  axis.get_units(unit);
+  return {std::move(points), axis.get_type(), unit};
+}
+
+// ___________________________________________________________________________//
+
+void NetCDF::SelectRegion() {
+  x_ranges_.clear();
+  if (!bounded_) {
+    return;
+  }
+
+  const auto &[x_min, x_max, y_min, y_max] = bounding_box_;
+  const auto nx = static_cast<size_t>(axis_x_.GetNumElements());
+  const auto width = x_max - x_min;
+
+  if (axis_x_.get_type() != Axis::kLongitude) {
+    x_ranges_.emplace_back(AxisRange(axis_x_, x_min, x_max));
+  } else if (width >= 360 || axis_x_.get_increment() < 0) {
+    x_ranges_.emplace_back(0, nx);
+  } else if (axis_x_.is_circle()) {
+    // Nodes surrounding the region, counted from the beginning of the axis,
+    // which the region can cross.
+    const auto step = axis_x_.get_increment();
+    const auto x0 = axis_x_.Normalize(x_min, 360) - axis_x_.get_start();
+    auto first = static_cast<int64_t>(std::floor(x0 / step)) - 1;
+    const auto last = static_cast<int64_t>(std::ceil((x0 + width) / step)) + 1;
+    const auto count = static_cast<size_t>(last - first + 1);
+
+    if (count >= nx) {
+      x_ranges_.emplace_back(0, nx);
+    } else {
+      first = (first + static_cast<int64_t>(nx)) % static_cast<int64_t>(nx);
+      const auto start = static_cast<size_t>(first);
+      if (start + count <= nx) {
+        x_ranges_.emplace_back(start, count);
+      } else {
+        x_ranges_.emplace_back(start, nx - start);
+        x_ranges_.emplace_back(0, count - (nx - start));
+      }
+    }
+  } else {
+    // The region, expressed relative to the beginning of the axis, may
+    // overlap the axis once shifted by one turn.
+    const auto lo = axis_x_.Normalize(x_min, 360);
+    const auto hi = lo + width;
+    const auto before = lo <= axis_x_.GetMaxValue();
+    const auto after = hi - 360 >= axis_x_.GetMinValue();
+
+    if (before && after) {
+      x_ranges_.emplace_back(0, nx);
+    } else if (after) {
+      x_ranges_.emplace_back(AxisRange(axis_x_, lo - 360, hi - 360));
+    } else {
+      x_ranges_.emplace_back(AxisRange(axis_x_, lo, hi));
+    }
+  }
+  y_range_ = AxisRange(axis_y_, y_min, y_max);
+
+  if (x_ranges_.size() != 1 || x_ranges_[0].second != nx) {
+    axis_x_ = AxisSubset(axis_x_, x_ranges_);
+  }
+  if (y_range_.second != ny_) {
+    axis_y_ = AxisSubset(axis_y_, {y_range_});
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto NetCDF::ReadRegion(const netcdf::Variable &variable,
+                        const std::string &unit) const
+    -> std::vector<double> {
+  std::vector<double> values;
+
+  if (x_ranges_.empty()) {
+    unit.empty() ? variable.Read(values) : variable.Read(values, unit);
+    return values;
+  }
+
+  if (variable.get_shape().size() != 2) {
+    throw std::logic_error(variable.get_name() +
+                           ": a region can only be read from a "
+                           "two-dimensional variable");
+  }
+
+  const auto yx = GetIndexFunction(variable) == &NetCDF::GetIndexYX;
+  const auto nx = static_cast<size_t>(axis_x_.GetNumElements());
+  const auto ny = y_range_.second;
+  std::vector<double> buffer;
+  size_t offset = 0;
+
+  for (const auto &[first, count] : x_ranges_) {
+    const auto start = yx ? std::vector<size_t>{y_range_.first, first}
+                          : std::vector<size_t>{first, y_range_.first};
+    const auto shape = yx ? std::vector<size_t>{ny, count}
+                          : std::vector<size_t>{count, ny};
+
+    unit.empty() ? variable.Read(buffer, start, shape)
+                 : variable.Read(buffer, start, shape, unit);
+    if (x_ranges_.size() == 1) {
+      return buffer;
+    }
+
+    // The parts of the hyperslab are joined along the X axis
+    values.resize(nx * ny);
+    for (size_t ix = 0; ix < count; ++ix) {
+      for (size_t iy = 0; iy < ny; ++iy) {
+        values[yx ? iy * nx + offset + ix : (offset + ix) * ny + iy] =
+            buffer[yx ? iy * count + ix : ix * ny + iy];
+      }
+    }
+    offset += count;
+  }
+  return values;
+}
+
+// ___________________________________________________________________________//
+
+auto NetCDF::RegionKey() const -> std::string {
+  std::ostringstream result;
+
+  if (!x_ranges_.empty()) {
+    result << "@";
+    for (const auto &[first, count] : x_ranges_) {
+      result << first << "+" << count << ",";
+    }
+    result << y_range_.first << "+" << y_range_.second;
+  }
+  return result.str();
 }
 
 // ___________________________________________________________________________//
@@ -90,37 +361,61 @@ void NetCDF::Open(const std::string &filename) {
 void NetCDF::Load(const std::string &name, const std::string &unit) {
   netcdf::Variable variable = FindVariable(name);
 
-  unit.empty() ? variable.Read(data_) : variable.Read(data_, unit);
+  auto loader = [&]() { return ReadRegion(variable, unit); };
+  data_ = GridCache::Get(filename_, name + ":" + unit + RegionKey(), loader,
+                         storage_);
 
-  pGetIndex_ =
-      variable.get_shape(0) == static_cast<size_t>(axis_y_.GetNumElements())
-          ? &NetCDF::GetIndexYX
-          : &NetCDF::GetIndexXY;
+  pGetIndex_ = GetIndexFunction(variable);
+  components_ = 1;
 }
 
 // ___________________________________________________________________________//
 
-double NetCDF::Interpolate(const double longitude, const double latitude,
-                           const double fill_value,
-                           CellProperties &cell) const {
-  if (data_.empty()) {
-    throw std::logic_error("No data loaded into memory");
+void NetCDF::LoadVector(const std::string &u_name, const std::string &v_name,
+                        const std::string &unit) {
+  netcdf::Variable u_variable = FindVariable(u_name);
+  netcdf::Variable v_variable = FindVariable(v_name);
+
+  if (u_variable.get_shape() != v_variable.get_shape()) {
+    throw std::logic_error(u_name + " and " + v_name +
+                           " must have the same shape");
   }
 
-  double x = axis_x_.Normalize(longitude, 360);
+  auto loader = [&]() {
+    auto u = ReadRegion(u_variable, unit);
+    auto v = ReadRegion(v_variable, unit);
+
+    std::vector<double> values(u.size() * 2);
+    for (size_t ix = 0; ix < u.size(); ++ix) {
+      values[ix * 2] = u[ix];
+      values[ix * 2 + 1] = v[ix];
+    }
+    return values;
+  };
+  data_ = GridCache::Get(filename_,
+                         u_name + "," + v_name + ":" + unit + RegionKey(),
+                         loader, storage_);
 
-  if (!cell.Contains(x, latitude)) {
+  pGetIndex_ = GetIndexFunction(u_variable);
+  components_ = 2;
+}
+
+// ___________________________________________________________________________//
+
+auto NetCDF::FindCell(const double x, const double y,
+                      CellProperties &cell) const -> bool {
+  if (!cell.Contains(x, y)) {
     int ix0;
     int ix1;
     int iy0;
     int iy1;
 
     if (!axis_x_.FindIndexes(x, ix0, ix1) ||
-        !axis_y_.FindIndexes(latitude, iy0, iy1)) {
+        !axis_y_.FindIndexes(y, iy0, iy1)) {
       // The search for the new cell is forced for the next call to this
       // method.
       cell = CellProperties::NONE();
-      return fill_value;
+      return false;
     }
 
     cell.Update(axis_x_.GetCoordinateValue(ix0),
@@ -128,6 +423,23 @@ double NetCDF::Interpolate(const double longitude, const double latitude,
                 axis_y_.GetCoordinateValue(iy0),
                 axis_y_.GetCoordinateValue(iy1), ix0, ix1, iy0, iy1);
   }
+  return true;
+}
+
+// ___________________________________________________________________________//
+
+double NetCDF::Interpolate(const double longitude, const double latitude,
+                           const double fill_value,
+                           CellProperties &cell) const {
+  if (data_ == nullptr) {
+    throw std::logic_error("No data loaded into memory");
+  }
+
+  double x = axis_x_.Normalize(longitude, 360);
+
+  if (!FindCell(x, latitude, cell)) {
+    return fill_value;
+  }
 
   return BilinearInterpolation(cell.x0(), cell.x1(), cell.y0(), cell.y1(),
                                GetValue(cell.ix0(), cell.iy0(), fill_value),
@@ -139,6 +451,241 @@ double NetCDF::Interpolate(const double longitude, const double latitude,
 
 // ___________________________________________________________________________//
 
+void NetCDF::InterpolateMany(const size_t n, const double *const longitude,
+                             const double *const latitude,
+                             const double fill_value, double *const result,
+                             CellProperties &cell) const {
+  if (data_ == nullptr) {
+    throw std::logic_error("No data loaded into memory");
+  }
+
+  BilinearWeights weights;
+  double z00[kBlockSize];
+  double z10[kBlockSize];
+  double z01[kBlockSize];
+  double z11[kBlockSize];
+
+  for (size_t first = 0; first < n; first += kBlockSize) {
+    const auto size = std::min(kBlockSize, n - first);
+
+    // Search for the cells and gathering of the values of their corners
+    for (size_t ix = 0; ix < size; ++ix) {
+      const auto x = axis_x_.Normalize(longitude[first + ix], 360);
+      const auto y = latitude[first + ix];
+
+      if (FindCell(x, y, cell)) {
+        weights.Set(ix, x, y, cell);
+        z00[ix] = GetValue(cell.ix0(), cell.iy0(), fill_value);
+        z10[ix] = GetValue(cell.ix1(), cell.iy0(), fill_value);
+        z01[ix] = GetValue(cell.ix0(), cell.iy1(), fill_value);
+        z11[ix] = GetValue(cell.ix1(), cell.iy1(), fill_value);
+      } else {
+        weights.SetOutside(ix);
+        z00[ix] = z10[ix] = z01[ix] = z11[ix] = fill_value;
+      }
+    }
+    weights.Interpolate(size, z00, z10, z01, z11, result + first);
+  }
+}
+
+// ___________________________________________________________________________//
+
+void NetCDF::InterpolateVector(const double longitude, const double latitude,
+                               const double fill_value, double &u, double &v,
+                               CellProperties &cell) const {
+  if (components_ != 2) {
+    throw std::logic_error("No vector field loaded into memory");
+  }
+
+  double x = axis_x_.Normalize(longitude, 360);
+
+  if (!FindCell(x, latitude, cell)) {
+    u = v = fill_value;
+    return;
+  }
+
+  // The two components of a grid node are stored side by side
+  const auto &grid = *data_;
+  const auto i00 = GetNode(cell.ix0(), cell.iy0());
+  const auto i10 = GetNode(cell.ix1(), cell.iy0());
+  const auto i01 = GetNode(cell.ix0(), cell.iy1());
+  const auto i11 = GetNode(cell.ix1(), cell.iy1());
+
+  u = BilinearInterpolation(
+      cell.x0(), cell.x1(), cell.y0(), cell.y1(),
+      Fill(grid.Get(i00), fill_value), Fill(grid.Get(i10), fill_value),
+      Fill(grid.Get(i01), fill_value), Fill(grid.Get(i11), fill_value), x,
+      latitude);
+  v = BilinearInterpolation(
+      cell.x0(), cell.x1(), cell.y0(), cell.y1(),
+      Fill(grid.Get(i00 + 1), fill_value), Fill(grid.Get(i10 + 1), fill_value),
+      Fill(grid.Get(i01 + 1), fill_value), Fill(grid.Get(i11 + 1), fill_value),
+      x, latitude);
+}
+
+// ___________________________________________________________________________//
+
+// Computes the derivatives of the bilinear interpolation of a cell
+static inline void BilinearGradient(const double x0, const double x1,
+                                    const double y0, const double y1,
+                                    const double z00, const double z10,
+                                    const double z01, const double z11,
+                                    const double x, const double y,
+                                    double &z_x, double &z_y) noexcept {
+  auto area = (x1 - x0) * (y1 - y0);
+
+  z_x = ((y1 - y) * (z10 - z00) + (y - y0) * (z11 - z01)) / area;
+  z_y = ((x1 - x) * (z01 - z00) + (x - x0) * (z11 - z10)) / area;
+}
+
+// ___________________________________________________________________________//
+
+void NetCDF::InterpolateVectorGradient(const double longitude,
+                                       const double latitude,
+                                       const double fill_value, double &u,
+                                       double &v, double &u_x, double &u_y,
+                                       double &v_x, double &v_y,
+                                       CellProperties &cell) const {
+  if (components_ != 2) {
+    throw std::logic_error("No vector field loaded into memory");
+  }
+
+  double x = axis_x_.Normalize(longitude, 360);
+
+  if (!FindCell(x, latitude, cell)) {
+    // The velocity is constant outside the grid
+    u = v = fill_value;
+    u_x = u_y = v_x = v_y = std::isnan(fill_value) ? fill_value : 0;
+    return;
+  }
+
+  const auto &grid = *data_;
+  const auto i00 = GetNode(cell.ix0(), cell.iy0());
+  const auto i10 = GetNode(cell.ix1(), cell.iy0());
+  const auto i01 = GetNode(cell.ix0(), cell.iy1());
+  const auto i11 = GetNode(cell.ix1(), cell.iy1());
+
+  for (size_t k = 0; k < 2; ++k) {
+    const auto z00 = Fill(grid.Get(i00 + k), fill_value);
+    const auto z10 = Fill(grid.Get(i10 + k), fill_value);
+    const auto z01 = Fill(grid.Get(i01 + k), fill_value);
+    const auto z11 = Fill(grid.Get(i11 + k), fill_value);
+
+    (k == 0 ? u : v) =
+        BilinearInterpolation(cell.x0(), cell.x1(), cell.y0(), cell.y1(), z00,
+                              z10, z01, z11, x, latitude);
+    BilinearGradient(cell.x0(), cell.x1(), cell.y0(), cell.y1(), z00, z10,
+                     z01, z11, x, latitude, k == 0 ? u_x : v_x,
+                     k == 0 ? u_y : v_y);
+  }
+}
+
+// ___________________________________________________________________________//
+
+void NetCDF::InterpolateVectorMany(const size_t n,
+                                   const double *const longitude,
+                                   const double *const latitude,
+                                   const double fill_value, double *const u,
+                                   double *const v,
+                                   CellProperties &cell) const {
+  if (components_ != 2) {
+    throw std::logic_error("No vector field loaded into memory");
+  }
+
+  const auto &grid = *data_;
+  BilinearWeights weights;
+  double u00[kBlockSize];
+  double u10[kBlockSize];
+  double u01[kBlockSize];
+  double u11[kBlockSize];
+  double v00[kBlockSize];
+  double v10[kBlockSize];
+  double v01[kBlockSize];
+  double v11[kBlockSize];
+
+  for (size_t first = 0; first < n; first += kBlockSize) {
+    const auto size = std::min(kBlockSize, n - first);
+
+    // Search for the cells and gathering of the values of their corners
+    for (size_t ix = 0; ix < size; ++ix) {
+      const auto x = axis_x_.Normalize(longitude[first + ix], 360);
+      const auto y = latitude[first + ix];
+
+      if (FindCell(x, y, cell)) {
+        const auto i00 = GetNode(cell.ix0(), cell.iy0());
+        const auto i10 = GetNode(cell.ix1(), cell.iy0());
+        const auto i01 = GetNode(cell.ix0(), cell.iy1());
+        const auto i11 = GetNode(cell.ix1(), cell.iy1());
+
+        weights.Set(ix, x, y, cell);
+        u00[ix] = Fill(grid.Get(i00), fill_value);
+        v00[ix] = Fill(grid.Get(i00 + 1), fill_value);
+        u10[ix] = Fill(grid.Get(i10), fill_value);
+        v10[ix] = Fill(grid.Get(i10 + 1), fill_value);
+        u01[ix] = Fill(grid.Get(i01), fill_value);
+        v01[ix] = Fill(grid.Get(i01 + 1), fill_value);
+        u11[ix] = Fill(grid.Get(i11), fill_value);
+        v11[ix] = Fill(grid.Get(i11 + 1), fill_value);
+      } else {
+        weights.SetOutside(ix);
+        u00[ix] = u10[ix] = u01[ix] = u11[ix] = fill_value;
+        v00[ix] = v10[ix] = v01[ix] = v11[ix] = fill_value;
+      }
+    }
+    weights.Interpolate(size, u00, u10, u01, u11, u + first);
+    weights.Interpolate(size, v00, v10, v01, v11, v + first);
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto NetCDF::Blend(const Reader &other, const double w0, const double w1,
+                   const double fill_value, ThreadPool &pool) const
+    -> std::unique_ptr<Reader> {
+  const auto *rhs = dynamic_cast<const NetCDF *>(&other);
+
+  // The grids must be defined on the same nodes and stored in the same order
+  if (rhs == nullptr || data_ == nullptr || rhs->data_ == nullptr ||
+      components_ != rhs->components_ || pGetIndex_ != rhs->pGetIndex_ ||
+      data_->size() != rhs->data_->size() || axis_x_ != rhs->axis_x_ ||
+      axis_y_ != rhs->axis_y_) {
+    return nullptr;
+  }
+
+  const auto &a = *data_;
+  const auto &b = *rhs->data_;
+  const auto w = w0 + w1;
+  std::vector<double> values(a.size());
+
+  pool.ParallelFor(
+      values.size(),
+      [&](size_t first, const size_t last, size_t /*worker*/) {
+        for (; first < last; ++first) {
+          const auto a_i = a.Get(first);
+          const auto b_i = b.Get(first);
+
+          // The nodes undefined in both grids remain undefined.
+          values[first] =
+              std::isnan(a_i) && std::isnan(b_i)
+                  ? a_i
+                  : (w0 * Fill(a_i, fill_value) + w1 * Fill(b_i, fill_value)) /
+                        w;
+        }
+      },
+      kValuesPerTask);
+
+  auto result = std::make_unique<NetCDF>();
+  result->axis_x_ = axis_x_;
+  result->axis_y_ = axis_y_;
+  result->filename_ = filename_;
+  result->data_ = std::make_shared<const Grid>(std::move(values));
+  result->pGetIndex_ = pGetIndex_;
+  result->components_ = components_;
+  return result;
+}
+
+// ___________________________________________________________________________//
+
 DateTime NetCDF::GetDateTime(const std::string &name) const {
   netcdf::Variable variable = FindVariable(name);
   netcdf::Attribute attribute = variable.FindAttributeIgnoreCase("date");
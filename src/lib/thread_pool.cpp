@@ -0,0 +1,198 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/thread_pool.hpp"
+
+#include <algorithm>
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  for (auto ix = 0; ix < num_threads; ++ix) {
+    queues_.emplace_back(std::make_unique<Queue>());
+  }
+
+  // The calling thread is the worker #0
+  for (auto ix = 1; ix < num_threads; ++ix) {
+    threads_.emplace_back(&ThreadPool::Worker, this, ix);
+  }
+}
+
+// ___________________________________________________________________________//
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+
+  for (auto &item : threads_) {
+    item.join();
+  }
+}
+
+// ___________________________________________________________________________//
+
+void ThreadPool::Worker(const size_t worker) {
+  size_t generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&]() -> bool {
+        return stop_ || generation != generation_;
+      });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+    }
+
+    Execute(worker);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto ThreadPool::Pop(const size_t worker, size_t &first, size_t &last)
+    -> bool {
+  auto &queue = *queues_[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+
+  if (queue.first == queue.last) {
+    return false;
+  }
+  first = queue.first;
+  last = std::min(first + grain_, queue.last);
+  queue.first = last;
+  return true;
+}
+
+// ___________________________________________________________________________//
+
+auto ThreadPool::Steal(const size_t worker) -> bool {
+  const auto workers = queues_.size();
+
+  for (size_t ix = 1; ix < workers; ++ix) {
+    auto &victim = *queues_[(worker + ix) % workers];
+    size_t first;
+    size_t last;
+    {
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      auto remaining = victim.last - victim.first;
+      if (remaining == 0) {
+        continue;
+      }
+      first = victim.last - (remaining + 1) / 2;
+      last = victim.last;
+      victim.last = first;
+    }
+
+    // The stolen tasks can in turn be stolen from this worker.
+    auto &queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.first = first;
+    queue.last = last;
+    return true;
+  }
+  return false;
+}
+
+// ___________________________________________________________________________//
+
+void ThreadPool::Execute(const size_t worker) {
+  size_t first;
+  size_t last;
+
+  try {
+    while (Pop(worker, first, last) ||
+           (Steal(worker) && Pop(worker, first, last))) {
+      (*task_)(first, last, worker);
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (exception_ == nullptr) {
+      exception_ = std::current_exception();
+    }
+
+    // The remaining tasks are abandoned.
+    for (auto &item : queues_) {
+      std::lock_guard<std::mutex> queue_lock(item->mutex);
+      item->first = item->last;
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+void ThreadPool::ParallelFor(const size_t size, const Task &task,
+                             const size_t grain) {
+  if (size == 0) {
+    return;
+  }
+
+  // No parallel code is used at all.
+  if (threads_.empty()) {
+    task(0, size, 0);
+    return;
+  }
+
+  const auto workers = queues_.size();
+
+  task_ = &task;
+  grain_ = std::max<size_t>(grain, 1);
+  exception_ = nullptr;
+
+  for (size_t ix = 0; ix < workers; ++ix) {
+    auto &queue = *queues_[ix];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.first = (ix * size) / workers;
+    queue.last = ((ix + 1) * size) / workers;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = threads_.size();
+    ++generation_;
+  }
+  start_.notify_all();
+
+  Execute(0);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() -> bool { return pending_ == 0; });
+  }
+  task_ = nullptr;
+
+  if (exception_ != nullptr) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+}  // namespace lagrangian
@@ -14,11 +14,13 @@
 // along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cfloat>
+#include <mutex>
 #include <utility>
 
 // ___________________________________________________________________________//
 
 #include "lagrangian/parameter.hpp"
+#include "lagrangian/simd.hpp"
 #include "lagrangian/time_serie.hpp"
 #include "lagrangian/trace.hpp"
 
@@ -26,6 +28,90 @@
 
 namespace lagrangian {
 
+/// Number of values interpolated at once by the batched interpolations
+static const size_t kBlockSize = 64;
+
+// ___________________________________________________________________________//
+
+/**
+ * @brief Get the lock serializing the accesses to the files
+ *
+ * @return The mutex
+ */
+static auto IoMutex() -> std::mutex & {
+  static std::mutex result;
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::Read(Reader *const reader, const std::string &filename) const {
+  std::lock_guard<std::mutex> lock(IoMutex());
+
+  Debug(str(boost::format("Loading %s from %s") % varname_ % filename));
+  reader->Open(filename);
+  if (v_varname_.empty()) {
+    reader->Load(varname_, unit_);
+  } else {
+    reader->LoadVector(varname_, v_varname_, unit_);
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto TimeSerie::NewReader() const -> Reader * {
+  auto *result = reader::Factory::NewReader(type_, storage_);
+  if (bounded_) {
+    result->SetBoundingBox(bounding_box_[0], bounding_box_[1],
+                           bounding_box_[2], bounding_box_[3]);
+  }
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::WaitPrefetch(const bool rethrow) {
+  if (prefetch_.valid()) {
+    try {
+      prefetch_.get();
+    } catch (...) {
+      prefetched_.clear();
+      if (rethrow) {
+        throw;
+      }
+    }
+  }
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::Prefetch(const int index) {
+  if (index < 0 || index >= time_serie_->GetNumElements()) {
+    return;
+  }
+
+  const auto &filename = time_serie_->GetItem(index);
+
+  // The file is already loaded or being loaded.
+  if (files_.find(filename) != files_.end() || filename == prefetched_) {
+    return;
+  }
+
+  // The previous reading, no longer needed, can not be cancelled.
+  WaitPrefetch(false);
+
+  if (spare_ == nullptr) {
+    spare_ = NewReader();
+  }
+  prefetched_ = filename;
+  prefetch_ = std::async(std::launch::async,
+                         [this, reader = spare_, filename]() {
+                           Read(reader, filename);
+                         });
+}
+
+// ___________________________________________________________________________//
+
 void TimeSerie::Load(int ix0, const int ix1) {
   // Should we load new data into memory ?
   if (ix0 < first_index_ || ix0 > last_index_ || ix1 < first_index_ ||
@@ -70,10 +156,14 @@ void TimeSerie::Load(int ix0, const int ix1) {
     for (auto &new_file : new_files) {
       // If it's a new file, we need to open it.
       if (files_.find(new_file.first) == files_.end()) {
-        Debug(str(boost::format("Loading %s from %s") % varname_ %
-                  new_file.first));
-        readers_[new_file.second]->Open(new_file.first);
-        readers_[new_file.second]->Load(varname_, unit_);
+        if (new_file.first == prefetched_) {
+          // The file has been read in the background.
+          WaitPrefetch(true);
+          std::swap(readers_[new_file.second], spare_);
+          prefetched_.clear();
+        } else {
+          Read(readers_[new_file.second], new_file.first);
+        }
       }
     }
     files_ = new_files;
@@ -112,6 +202,8 @@ FileList::FileList(const std::vector<std::string> &filenames,
 
   // For all files, find the time to create an associative array: date,
   // filename.
+  std::lock_guard<std::mutex> lock(IoMutex());
+
   for (auto &item : filenames) {
     reader->Open(item);
     files.emplace_back(
@@ -135,16 +227,18 @@ FileList::FileList(const std::vector<std::string> &filenames,
 
 TimeSerie::TimeSerie(const std::vector<std::string> &filenames,
                      std::string varname, std::string unit,
-                     const reader::Factory::Type type)
+                     const reader::Factory::Type type,
+                     const Grid::Storage storage)
     : first_index_(-1),
       last_index_(-1),
       varname_(std::move(varname)),
       unit_(std::move(unit)),
-      type_(type) {
+      type_(type),
+      storage_(storage) {
   // Instances used to read velocity fields
   try {
-    readers_.emplace_back(reader::Factory::NewReader(type_));
-    readers_.emplace_back(reader::Factory::NewReader(type_));
+    readers_.emplace_back(reader::Factory::NewReader(type_, storage_));
+    readers_.emplace_back(reader::Factory::NewReader(type_, storage_));
   } catch (...) {
     for (auto &item : readers_) {
       delete item;
@@ -159,9 +253,40 @@ TimeSerie::TimeSerie(const std::vector<std::string> &filenames,
 
 // ___________________________________________________________________________//
 
-auto TimeSerie::Interpolate(const double date, const double longitude,
-                            const double latitude, const double fill_value,
-                            CellProperties &cell) -> double {
+TimeSerie::TimeSerie(const std::vector<std::string> &filenames,
+                     std::string u_varname, std::string v_varname,
+                     std::string unit, const reader::Factory::Type type,
+                     const Grid::Storage storage)
+    : TimeSerie(filenames, std::move(u_varname), std::move(unit), type,
+                storage) {
+  v_varname_ = std::move(v_varname);
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::SetBoundingBox(const double x_min, const double x_max,
+                               const double y_min, const double y_max) {
+  WaitPrefetch(false);
+  prefetched_.clear();
+
+  for (auto &item : readers_) {
+    item->SetBoundingBox(x_min, x_max, y_min, y_max);
+  }
+  if (spare_ != nullptr) {
+    spare_->SetBoundingBox(x_min, x_max, y_min, y_max);
+  }
+  bounding_box_ = {x_min, x_max, y_min, y_max};
+  bounded_ = true;
+
+  // The grids loaded must be read again
+  files_.clear();
+  first_index_ = last_index_ = -1;
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::FindGrids(const double date, Reader *&r0, Reader *&r1,
+                          double &w0, double &w1) {
   int it0;
   int it1;
 
@@ -174,25 +299,214 @@ auto TimeSerie::Interpolate(const double date, const double longitude,
 
   const auto t0 = time_serie_->GetDate(it0);
   const auto t1 = time_serie_->GetDate(it1);
+  const auto dx = 1 / (t1 - t0);
 
-  it0 -= first_index_;
-  it1 -= first_index_;
+  r0 = readers_[it0 - first_index_];
+  r1 = readers_[it1 - first_index_];
+  w0 = (t1 - date) * dx;
+  w1 = (date - t0) * dx;
+}
 
-  const auto dx = 1 / (t1 - t0);
+// ___________________________________________________________________________//
+
+TimeSerie::~TimeSerie() {
+  WaitPrefetch(false);
 
-  const auto x0 =
-      readers_[it0]->Interpolate(longitude, latitude, fill_value, cell);
-  const auto x1 =
-      readers_[it1]->Interpolate(longitude, latitude, fill_value, cell);
+  // Closing the files
+  std::lock_guard<std::mutex> lock(IoMutex());
+  for (auto &item : readers_) {
+    delete item;
+  }
+  delete spare_;
+  delete time_serie_;
+}
 
-  const auto w0 = (t1 - date) * dx;
-  const auto w1 = (date - t0) * dx;
+// ___________________________________________________________________________//
+
+auto TimeSerie::Interpolate(const double date, const double longitude,
+                            const double latitude, const double fill_value,
+                            CellProperties &cell) -> double {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  const auto x0 = r0->Interpolate(longitude, latitude, fill_value, cell);
+  const auto x1 = r1->Interpolate(longitude, latitude, fill_value, cell);
 
   return (w0 * x0 + w1 * x1) / (w0 + w1);
 }
 
 // ___________________________________________________________________________//
 
+/**
+ * @brief Linear interpolation in time of a block of values
+ *
+ * @param n Number of values
+ * @param w0 Weight of the first grid
+ * @param w1 Weight of the second grid
+ * @param x0 Values of the first grid, replaced by the interpolated values
+ * @param x1 Values of the second grid
+ */
+static inline void TimeInterpolation(const size_t n, const double w0,
+                                     const double w1, double *const x0,
+                                     const double *const x1) {
+  const auto w = w0 + w1;
+  const auto last = simd::VectorizableSize(n);
+  size_t ix = 0;
+
+  for (; ix < last; ix += simd::kWidth) {
+    simd::Store(
+        x0 + ix,
+        simd::Div(simd::Add(simd::Mul(simd::Set(w0), simd::Load(x0 + ix)),
+                            simd::Mul(simd::Set(w1), simd::Load(x1 + ix))),
+                  simd::Set(w)));
+  }
+  for (; ix < n; ++ix) {
+    x0[ix] = (w0 * x0[ix] + w1 * x1[ix]) / w;
+  }
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::InterpolateMany(const double date, const size_t n,
+                                const double *const longitude,
+                                const double *const latitude,
+                                const double fill_value, double *const result,
+                                CellProperties &cell) {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  // Values of the second grid, interpolated by blocks
+  double x1[kBlockSize];
+
+  r0->InterpolateMany(n, longitude, latitude, fill_value, result, cell);
+
+  for (size_t first = 0; first < n; first += kBlockSize) {
+    const auto size = std::min(kBlockSize, n - first);
+    r1->InterpolateMany(size, longitude + first, latitude + first, fill_value,
+                        x1, cell);
+    TimeInterpolation(size, w0, w1, result + first, x1);
+  }
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::InterpolateVector(const double date, const double longitude,
+                                  const double latitude,
+                                  const double fill_value, double &u,
+                                  double &v, CellProperties &cell) {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+  double u0;
+  double u1;
+  double v0;
+  double v1;
+
+  if (v_varname_.empty()) {
+    throw std::logic_error(varname_ + ": not a vector field");
+  }
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  r0->InterpolateVector(longitude, latitude, fill_value, u0, v0, cell);
+  r1->InterpolateVector(longitude, latitude, fill_value, u1, v1, cell);
+
+  u = (w0 * u0 + w1 * u1) / (w0 + w1);
+  v = (w0 * v0 + w1 * v1) / (w0 + w1);
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::InterpolateVectorGradient(
+    const double date, const double longitude, const double latitude,
+    const double fill_value, double &u, double &v, double &u_x, double &u_y,
+    double &v_x, double &v_y, CellProperties &cell) {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+  double z0[6];
+  double z1[6];
+
+  if (v_varname_.empty()) {
+    throw std::logic_error(varname_ + ": not a vector field");
+  }
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  r0->InterpolateVectorGradient(longitude, latitude, fill_value, z0[0], z0[1],
+                                z0[2], z0[3], z0[4], z0[5], cell);
+  r1->InterpolateVectorGradient(longitude, latitude, fill_value, z1[0], z1[1],
+                                z1[2], z1[3], z1[4], z1[5], cell);
+
+  // The derivatives are interpolated in time as the components
+  TimeInterpolation(6, w0, w1, z0, z1);
+  u = z0[0];
+  v = z0[1];
+  u_x = z0[2];
+  u_y = z0[3];
+  v_x = z0[4];
+  v_y = z0[5];
+}
+
+// ___________________________________________________________________________//
+
+void TimeSerie::InterpolateVectorMany(const double date, const size_t n,
+                                      const double *const longitude,
+                                      const double *const latitude,
+                                      const double fill_value, double *const u,
+                                      double *const v, CellProperties &cell) {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+
+  if (v_varname_.empty()) {
+    throw std::logic_error(varname_ + ": not a vector field");
+  }
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  // Values of the second grid, interpolated by blocks
+  double u1[kBlockSize];
+  double v1[kBlockSize];
+
+  r0->InterpolateVectorMany(n, longitude, latitude, fill_value, u, v, cell);
+
+  for (size_t first = 0; first < n; first += kBlockSize) {
+    const auto size = std::min(kBlockSize, n - first);
+    r1->InterpolateVectorMany(size, longitude + first, latitude + first,
+                              fill_value, u1, v1, cell);
+    TimeInterpolation(size, w0, w1, u + first, u1);
+    TimeInterpolation(size, w0, w1, v + first, v1);
+  }
+}
+
+// ___________________________________________________________________________//
+
+auto TimeSerie::Slab(const double date, const double fill_value,
+                     ThreadPool &pool) -> std::unique_ptr<Reader> {
+  Reader *r0;
+  Reader *r1;
+  double w0;
+  double w1;
+
+  FindGrids(date, r0, r1, w0, w1);
+
+  return r0->Blend(*r1, w0, w1, fill_value, pool);
+}
+
+// ___________________________________________________________________________//
+
 void TimeSerie::Load(const double t0, const double t1) {
   int it00;
   int it01;
@@ -213,12 +527,15 @@ void TimeSerie::Load(const double t0, const double t1) {
     readers_.resize(required_size);
 
     for (size_t ix = previous_size; ix < required_size; ++ix) {
-      readers_[ix] = reader::Factory::NewReader(type_);
+      readers_[ix] = NewReader();
     }
   }
 
   // Loading the needed data
   Load(it00, it11);
+
+  // Reading the next grid in the direction of the integration
+  Prefetch(t0 <= t1 ? last_index_ + 1 : first_index_ - 1);
 }
 
 }  // namespace lagrangian
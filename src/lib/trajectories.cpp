@@ -0,0 +1,120 @@
+// This file is part of lagrangian library.
+//
+// lagrangian is free software: you can redistribute it and/or modify
+// it under the terms of GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// lagrangian is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of GNU Lesser General Public License
+// along with lagrangian. If not, see <http://www.gnu.org/licenses/>.
+#include "lagrangian/trajectories.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "lagrangian/thread_pool.hpp"
+#include "lagrangian/trace.hpp"
+
+// ___________________________________________________________________________//
+
+namespace lagrangian {
+
+/// Number of particles handed out at once to the threads
+static const size_t kParticlesPerTask = 256;
+
+// ___________________________________________________________________________//
+
+Trajectories::Trajectories(std::vector<double> x, std::vector<double> y)
+    : x0_(std::move(x)), y0_(std::move(y)) {
+  if (x0_.size() != y0_.size()) {
+    throw std::invalid_argument(
+        "the number of longitudes and latitudes must be equal");
+  }
+  x_.resize(x0_.size());
+  y_.resize(y0_.size());
+}
+
+// ___________________________________________________________________________//
+
+auto Trajectories::Steps(const Integration &integration) -> size_t {
+  auto it = integration.GetIterator();
+  size_t result = 0;
+
+  while (it.GoAfter()) {
+    ++result;
+    ++it;
+  }
+  return result;
+}
+
+// ___________________________________________________________________________//
+
+void Trajectories::Compute(Integration &integration, const int num_threads,
+                           const Observer &observer) {
+  const auto spherical_equatorial =
+      integration.get_field()->get_coordinates_type() ==
+      Field::kSphericalEquatorial;
+  auto particles = Particles(size(), 1, integration.get_start_time(),
+                             spherical_equatorial);
+  ActiveSet indexes;
+  indexes.reserve(size());
+
+  for (size_t index = 0; index < size(); ++index) {
+    particles.SetStencil(index, x0_[index], y0_[index], 0);
+    indexes.push_back(index);
+  }
+
+  auto it = integration.GetIterator();
+  ThreadPool pool(num_threads);
+
+  while (it.GoAfter()) {
+    integration.Fetch(it(), pool);
+
+    // Positions of the particles at the current date
+    pool.ParallelFor(
+        size(),
+        [&](const size_t first, const size_t last, size_t /*worker*/) {
+          for (auto index = first; index < last; ++index) {
+            if (particles.IsMissing(index)) {
+              x_[index] = y_[index] = std::numeric_limits<double>::quiet_NaN();
+            } else {
+              x_[index] = particles.get_x(0, index);
+              y_[index] = particles.get_y(0, index);
+            }
+          }
+        },
+        kParticlesPerTask);
+    observer(it(), x_.data(), y_.data());
+
+    auto date =
+        DateTime(DateTime::FromUnixTime(it())).ToString("%Y-%m-%d %H:%M:%S");
+    Debug(str(boost::format("Start time step %s (%d particles)") % date %
+              indexes.size()));
+
+    pool.ParallelFor(
+        indexes.size(),
+        [&](const size_t first, const size_t last, size_t /*worker*/) {
+          CellProperties cell;
+          particles.Compute(integration.get_rk4(), it, indexes.data() + first,
+                            last - first, cell);
+        },
+        kParticlesPerTask);
+
+    // Removing the particles no longer tracked
+    indexes.Erase(
+        [&particles](const size_t index) -> bool {
+          return particles.IsMissing(index);
+        },
+        pool);
+
+    ++it;
+  }
+}
+
+}  // namespace lagrangian
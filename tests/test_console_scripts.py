@@ -153,6 +153,35 @@ class TestConsoleScripts(unittest.TestCase):
         finally:
             os.unlink(output_file)
 
+    def test_path_netcdf(self):
+        from lagrangian.console_scripts.path import main
+
+        with tempfile.NamedTemporaryFile(suffix='.nc',
+                                         delete=False) as temp_output:
+            output_file = temp_output.name
+
+        sys.argv = [
+            'path', self.ini, self.pos, '2010-01-01', '2010-01-02', '--output',
+            output_file, '--format', 'netcdf', '--threads', '2'
+        ]
+
+        try:
+            main()
+
+            with netCDF4.Dataset(output_file) as dataset:
+                time = dataset.variables['time'][:]
+                x = dataset.variables['x'][:]
+                y = dataset.variables['y'][:]
+            self.assertEqual(x.shape, (5, 9))
+            self.assertEqual(y.shape, (5, 9))
+            numpy.testing.assert_array_equal(numpy.diff(time), 6 * 3600)
+            self.assertAlmostEqual(x[0, 1], 1.433333, delta=1e-6)
+            self.assertAlmostEqual(y[0, 1], 43.6, delta=1e-6)
+            self.assertAlmostEqual(x[-1, 8], 70.048066, delta=1e-6)
+            self.assertAlmostEqual(y[-1, 8], 12.080719, delta=1e-6)
+        finally:
+            os.unlink(output_file)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -15,6 +15,8 @@
 import datetime
 import unittest
 
+import numpy
+
 import lagrangian
 
 
@@ -27,6 +29,17 @@ class Field(lagrangian.field.Python):
         return (x * 1e-9, y * 1e-9)
 
 
+class FieldMany(lagrangian.field.Python):
+
+    def __init__(self):
+        super().__init__(self)
+        self.calls = 0
+
+    def compute_many(self, _, x, y):
+        self.calls += 1
+        return (x * 1e-9, y * 1e-9)
+
+
 class TestIntegration(unittest.TestCase):
 
     def setUp(self):
@@ -115,6 +128,191 @@ class TestIntegration(unittest.TestCase):
         fle = lagrangian.FiniteLyapunovExponents()
         self.assertTrue(integration.exponents(position, fle))
 
+    def test_separation(self):
+        """The fast test of the separation gives the result of the comparison
+        of the exact distance with the minimal separation"""
+
+        def create(min_separation, delta):
+            return lagrangian.FiniteLyapunovExponentsIntegration(
+                datetime.datetime(2000, 1, 1), datetime.datetime(2000, 1, 31),
+                datetime.timedelta(days=1), lagrangian.IntegrationMode.FSLE,
+                min_separation, delta, Field())
+
+        for delta in [1e-5, 0.01, 1, 60]:
+            for y in [0, 45, -89]:
+                for stencil in [
+                        lagrangian.Stencil.TRIPLET,
+                        lagrangian.Stencil.QUINTUPLET
+                ]:
+                    position = create(delta, delta).set_initial_point(
+                        10, y, stencil)
+                    distance = position.max_distance()
+                    for min_separation in [
+                            distance * (1 - 1e-15), distance,
+                            distance * (1 + 1e-15), distance * 0.5,
+                            distance * 2, 180, -1
+                    ]:
+                        integration = create(min_separation, delta)
+                        self.assertEqual(integration.separation(position),
+                                         distance > min_separation)
+
+    def test_fast_spherical(self):
+        """The points moved on the sphere with polynomials follow the
+        trajectories computed with trigonometric functions"""
+        start = datetime.datetime(2000, 1, 1)
+        end = datetime.datetime(2000, 1, 31)
+        field = lagrangian.field.Vonkarman()
+        for x0, y0 in [(0.5, -0.5), (1, 0.75), (3.5, 0.25)]:
+            positions = []
+            for fast_spherical in [False, True]:
+                integration = lagrangian.Integration(
+                    start, end, datetime.timedelta(hours=6), field)
+                integration.fast_spherical = fast_spherical
+                self.assertEqual(integration.fast_spherical, fast_spherical)
+                x, y = x0, y0
+                it = integration.iterator()
+                for _ in it:
+                    position = integration.compute(it, x, y)
+                    self.assertIsNotNone(position)
+                    x, y = position
+                positions.append((x, y))
+            self.assertAlmostEqual(positions[0][0],
+                                   positions[1][0],
+                                   delta=1e-9)
+            self.assertAlmostEqual(positions[0][1],
+                                   positions[1][1],
+                                   delta=1e-9)
+
+    def test_vectorized(self):
+        """The arrays of points give the results of the points processed one
+        by one"""
+        start = datetime.datetime(2000, 1, 1)
+        x, y = numpy.meshgrid(numpy.linspace(0, 8, 80),
+                              numpy.linspace(-1, 1, 60))
+        dates = numpy.datetime64(start) + numpy.arange(
+            x.size).reshape(x.shape) * numpy.timedelta64(1, 'h')
+
+        # The method of the base class, the Python fields overriding it
+        compute = lagrangian.Field.compute
+        for field in [lagrangian.field.Vonkarman(), Field()]:
+            rk = lagrangian.RungeKutta(3600, field)
+            for t in [start, dates]:
+                u, v, mask = compute(field, t, x, y, num_threads=2)
+                x1, y1, moved = rk.compute(t, x, y, num_threads=2)
+                for item in [u, v, mask, x1, y1, moved]:
+                    self.assertEqual(item.shape, x.shape)
+                self.assertTrue(mask.all())
+                self.assertTrue(moved.all())
+                for ix in [(0, 0), (13, 27), (59, 79)]:
+                    date = t if t is start else dates[ix].astype(
+                        datetime.datetime)
+                    numpy.testing.assert_allclose(
+                        compute(field, date, x[ix], y[ix]), (u[ix], v[ix]),
+                        rtol=1e-12, atol=1e-15)
+                    numpy.testing.assert_allclose(
+                        rk.compute(date, x[ix], y[ix]), (x1[ix], y1[ix]),
+                        rtol=1e-12, atol=1e-15)
+
+        # A large set of points is processed by several threads, evaluating
+        # the Python field with the GIL
+        field = Field()
+        x = numpy.random.uniform(-10, 10, 10000)
+        y = numpy.random.uniform(-10, 10, 10000)
+        u, v, mask = compute(field, start, x, y, num_threads=4)
+        self.assertTrue(mask.all())
+        numpy.testing.assert_array_equal(u, x * 1e-9)
+        numpy.testing.assert_array_equal(v, y * 1e-9)
+
+        with self.assertRaises(ValueError):
+            compute(field, start, x, y[:-1])
+        with self.assertRaises(ValueError):
+            compute(field, dates, x, y)
+
+    def test_trajectories(self):
+        """The particles moved together follow the trajectories of the
+        particles moved one by one"""
+        start = datetime.datetime(2000, 1, 1)
+        end = datetime.datetime(2000, 1, 11)
+        path = lagrangian.Path(start, end, datetime.timedelta(hours=6),
+                               lagrangian.field.Vonkarman())
+        x0 = numpy.random.uniform(0, 8, 500)
+        y0 = numpy.random.uniform(-1, 1, 500)
+        trajectories = lagrangian.Trajectories(x0, y0)
+        self.assertEqual(len(trajectories), x0.size)
+
+        dates, x, y = trajectories.compute(path, num_threads=2)
+        steps = lagrangian.Trajectories.steps(path)
+        self.assertEqual(steps, len(list(path.iterator())))
+        self.assertEqual(dates.shape, (steps, ))
+        self.assertEqual(x.shape, (steps, x0.size))
+        self.assertEqual(y.shape, (steps, x0.size))
+        self.assertEqual(dates[0], numpy.datetime64(start))
+
+        for ix in range(0, x0.size, 50):
+            position = (x0[ix], y0[ix])
+            it = path.iterator()
+            for step, _ in enumerate(it):
+                self.assertEqual((x[step, ix], y[step, ix]), position)
+                position = path.compute(it, *position)
+                self.assertIsNotNone(position)
+
+        # The positions handed out date by date
+        records = []
+        trajectories.compute(
+            path, lambda date, *args: records.append((date, *args)))
+        self.assertEqual(len(records), steps)
+        for step, (date, xi, yi) in enumerate(records):
+            self.assertEqual(numpy.datetime64(date), dates[step])
+            numpy.testing.assert_array_equal(xi, x[step])
+            numpy.testing.assert_array_equal(yi, y[step])
+
+        with self.assertRaises(ValueError):
+            lagrangian.Trajectories(x0, y0[:-1])
+
+    def test_compute_many(self):
+        """The fields evaluating arrays of points give the results of the
+        fields evaluating the points one by one"""
+        start = datetime.datetime(2000, 1, 1)
+        field = FieldMany()
+        self.assertEqual(lagrangian.Field.compute(field, start, 1, 2),
+                         (1e-9, 2e-9))
+
+        x = numpy.random.uniform(-10, 10, 1000)
+        y = numpy.random.uniform(-10, 10, 1000)
+        expected = lagrangian.RungeKutta(3600, Field()).compute(start, x, y)
+        result = lagrangian.RungeKutta(3600, field).compute(start,
+                                                            x,
+                                                            y,
+                                                            num_threads=1)
+        for ix in range(3):
+            numpy.testing.assert_array_equal(result[ix], expected[ix])
+        self.assertLess(field.calls, x.size)
+
+        # The maps computed by several threads
+        map_properties = lagrangian.MapProperties(8, 4, 0, -1, 0.25)
+        maps = []
+        for item in [Field(), FieldMany()]:
+            integration = lagrangian.FiniteLyapunovExponentsIntegration(
+                start, datetime.datetime(2000, 1, 3),
+                datetime.timedelta(hours=6), lagrangian.IntegrationMode.FTLE,
+                0, 0.01, item)
+            map_of_ftle = lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, integration, lagrangian.Stencil.TRIPLET)
+            map_of_ftle.compute(num_threads=2)
+            maps.append(map_of_ftle.map_of_lambda1())
+        numpy.testing.assert_allclose(maps[0], maps[1], rtol=1e-12)
+
+        class Invalid(lagrangian.field.Python):
+
+            def __init__(self):
+                super().__init__(self)
+
+            def compute_many(self, _, x, y):
+                return (x[:-1], y[:-1])
+
+        with self.assertRaises(ValueError):
+            lagrangian.RungeKutta(3600, Invalid()).compute(start, x, y)
+
 
 if __name__ == '__main__':
     unittest.main()
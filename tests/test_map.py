@@ -15,8 +15,11 @@
 import datetime
 import os
 import pathlib
+import tempfile
 import unittest
 
+import numpy
+
 import lagrangian
 
 from . import SampleDataHandler
@@ -80,6 +83,380 @@ class TestMapOfFiniteLyapunovExponents(unittest.TestCase):
         assert delta_t is not None
         assert effective_separation is not None
 
+        # The maps computed in a single pass are identical to the maps
+        # computed one by one
+        maps = map_of_fsle.maps([
+            lagrangian.MapOutput.LAMBDA1, lagrangian.MapOutput.LAMBDA2,
+            lagrangian.MapOutput.THETA1, lagrangian.MapOutput.THETA2,
+            lagrangian.MapOutput.DELTA_T,
+            lagrangian.MapOutput.FINAL_SEPARATION
+        ], 0)
+        self.assertEqual(maps.shape, (6, 360, 180))
+        for ix, item in enumerate([
+                lambda1, lambda2, teta1, teta2, delta_t, effective_separation
+        ]):
+            numpy.testing.assert_array_equal(maps[ix], item)
+
+        # The maps returned own their values
+        self.assertFalse(numpy.shares_memory(lambda1, lambda2))
+        expected = lambda1.copy()
+        del map_of_fsle
+        numpy.testing.assert_array_equal(lambda1, expected)
+
+    def test_shared_nodes(self):
+        """The stencils made of the shared nodes of the grid give the same
+        exponents as the stencils advected independently"""
+        ts = lagrangian.field.TimeSerie(self.ini)
+        map_properties = lagrangian.MapProperties(40, 30, -60, 20, 0.25)
+        start = datetime.datetime(2010, 1, 1)
+        end = datetime.datetime(2010, 1, 11)
+        for stencil in [
+                lagrangian.Stencil.TRIPLET, lagrangian.Stencil.QUINTUPLET
+        ]:
+            maps = []
+            for shared_nodes in [False, True]:
+                integration = lagrangian.FiniteLyapunovExponentsIntegration(
+                    start, end, datetime.timedelta(hours=6),
+                    lagrangian.IntegrationMode.FTLE, 0, 0.25, ts)
+                map_of_ftle = lagrangian.MapOfFiniteLyapunovExponents(
+                    map_properties, integration, stencil,
+                    shared_nodes=shared_nodes)
+                map_of_ftle.compute()
+                maps.append(
+                    map_of_ftle.maps([
+                        lagrangian.MapOutput.LAMBDA1,
+                        lagrangian.MapOutput.LAMBDA2
+                    ]))
+            numpy.testing.assert_allclose(maps[0], maps[1], rtol=1e-6)
+
+        # The stencils must be as wide as the grid step
+        integration = lagrangian.FiniteLyapunovExponentsIntegration(
+            start, end, datetime.timedelta(hours=6),
+            lagrangian.IntegrationMode.FTLE, 0, 0.1, ts)
+        with self.assertRaises(ValueError):
+            lagrangian.MapOfFiniteLyapunovExponents(map_properties,
+                                                    integration,
+                                                    shared_nodes=True)
+
+    def test_variational(self):
+        """The gradient of the flow map integrated along a single trajectory
+        gives the exponents of a triplet of close particles"""
+        ts = lagrangian.field.TimeSerie(self.ini)
+        map_properties = lagrangian.MapProperties(40, 30, -60, 20, 0.25)
+        start = datetime.datetime(2010, 1, 1)
+        end = datetime.datetime(2010, 1, 11)
+        maps = []
+        for stencil in [
+                lagrangian.Stencil.TRIPLET, lagrangian.Stencil.VARIATIONAL
+        ]:
+            integration = lagrangian.FiniteLyapunovExponentsIntegration(
+                start, end, datetime.timedelta(hours=6),
+                lagrangian.IntegrationMode.FTLE, 0, 1e-5, ts)
+            map_of_ftle = lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, integration, stencil)
+            map_of_ftle.compute()
+            maps.append(map_of_ftle.map_of_lambda1())
+        mask = ~(numpy.isnan(maps[0]) | numpy.isnan(maps[1]))
+        self.assertGreater(mask.sum(), 0)
+        error = numpy.abs(maps[1] - maps[0])[mask] / numpy.abs(
+            maps[0][mask]).max()
+        self.assertLess(numpy.median(error), 1e-3)
+
+        # A single trajectory can't be made of the shared nodes of the grid
+        integration = lagrangian.FiniteLyapunovExponentsIntegration(
+            start, end, datetime.timedelta(hours=6),
+            lagrangian.IntegrationMode.FTLE, 0, 0.25, ts)
+        with self.assertRaises(ValueError):
+            lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, integration, lagrangian.Stencil.VARIATIONAL,
+                shared_nodes=True)
+
+    def test_vonkarman(self):
+        """The stencils of a map, moved by the engine specialized for the
+        field, give the exponents of the stencils moved one by one"""
+        field = lagrangian.field.Vonkarman()
+        map_properties = lagrangian.MapProperties(8, 4, 0, -1, 0.25)
+        start = datetime.datetime(2000, 1, 1)
+        end = datetime.datetime(2000, 1, 3)
+        integration = lagrangian.FiniteLyapunovExponentsIntegration(
+            start, end, datetime.timedelta(hours=6),
+            lagrangian.IntegrationMode.FTLE, 0, 0.01, field)
+        map_of_ftle = lagrangian.MapOfFiniteLyapunovExponents(
+            map_properties, integration, lagrangian.Stencil.TRIPLET)
+        map_of_ftle.compute()
+        lambda1 = map_of_ftle.map_of_lambda1()
+
+        expected = numpy.empty_like(lambda1)
+        for ix, x in enumerate(map_properties.x_axis()):
+            for iy, y in enumerate(map_properties.y_axis()):
+                position = integration.set_initial_point(
+                    x, y, lagrangian.Stencil.TRIPLET)
+                it = integration.iterator()
+                for _ in it:
+                    self.assertTrue(
+                        integration.compute(it, position,
+                                            lagrangian.CellProperties()))
+                fle = lagrangian.FiniteLyapunovExponents()
+                self.assertTrue(integration.exponents(position, fle))
+                expected[ix, iy] = fle.lambda1
+        numpy.testing.assert_allclose(lambda1, expected, rtol=1e-6)
+
+    def test_time_slabs(self):
+        """The velocities interpolated in grids blended in time once per time
+        step give the same exponents as the velocities interpolated between
+        the two grids surrounding each date"""
+        map_properties = lagrangian.MapProperties(40, 30, -60, 20, 0.25)
+        start = datetime.datetime(2010, 1, 1)
+        end = datetime.datetime(2010, 1, 11)
+        maps = []
+        for time_slabs in [False, True]:
+            ts = lagrangian.field.TimeSerie(self.ini)
+            ts.time_slabs = time_slabs
+            self.assertEqual(ts.time_slabs, time_slabs)
+            integration = lagrangian.FiniteLyapunovExponentsIntegration(
+                start, end, datetime.timedelta(hours=6),
+                lagrangian.IntegrationMode.FTLE, 0, 0.25, ts)
+            map_of_ftle = lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, integration, lagrangian.Stencil.TRIPLET)
+            map_of_ftle.compute()
+            maps.append(map_of_ftle.map_of_lambda1())
+        numpy.testing.assert_array_equal(numpy.isnan(maps[0]),
+                                         numpy.isnan(maps[1]))
+        mask = ~numpy.isnan(maps[0])
+        self.assertGreater(mask.sum(), 0)
+        error = numpy.abs(maps[1] - maps[0])[mask] / numpy.abs(
+            maps[0][mask]).max()
+        self.assertLess(numpy.median(error), 1e-9)
+
+    def test_checkpoint(self):
+        """A computation resumed from a checkpoint gives the exponents of
+        the computation never interrupted"""
+        field = lagrangian.field.Vonkarman()
+        map_properties = lagrangian.MapProperties(50, 30, 0, -1, 0.05)
+        start = datetime.datetime(2000, 1, 1)
+        step = datetime.timedelta(hours=6)
+        outputs = [
+            lagrangian.MapOutput.LAMBDA1, lagrangian.MapOutput.DELTA_T,
+            lagrangian.MapOutput.FINAL_SEPARATION
+        ]
+
+        def integration(end):
+            return lagrangian.FiniteLyapunovExponentsIntegration(
+                start, end, step, lagrangian.IntegrationMode.FSLE, 0.2,
+                0.05, field)
+
+        for shared_nodes in [False, True]:
+            fsle = integration(datetime.datetime(2000, 1, 11))
+            expected = lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, fsle, shared_nodes=shared_nodes)
+            expected.compute()
+
+            with tempfile.TemporaryDirectory() as tmp:
+                path = os.path.join(tmp, 'fsle.ckpt')
+                checkpoint = lagrangian.Checkpoint(path, 5)
+                self.assertEqual(checkpoint.filename, path)
+                self.assertEqual(checkpoint.interval, 5)
+
+                # The computation is interrupted after 12 time steps
+                interrupted = integration(datetime.datetime(2000, 1, 4))
+                lagrangian.MapOfFiniteLyapunovExponents(
+                    map_properties, interrupted,
+                    shared_nodes=shared_nodes).compute(checkpoint=checkpoint)
+
+                map_of_fsle = lagrangian.MapOfFiniteLyapunovExponents(
+                    map_properties, fsle, shared_nodes=shared_nodes)
+                map_of_fsle.restart(path)
+                map_of_fsle.compute(num_threads=2)
+                numpy.testing.assert_array_equal(
+                    map_of_fsle.maps(outputs), expected.maps(outputs))
+
+                # The checkpoint is bound to its map and its integration
+                with self.assertRaises(ValueError):
+                    lagrangian.MapOfFiniteLyapunovExponents(
+                        lagrangian.MapProperties(50, 30, 0, -1, 0.1),
+                        fsle).restart(path)
+                with self.assertRaises(ValueError):
+                    lagrangian.MapOfFiniteLyapunovExponents(
+                        map_properties,
+                        lagrangian.FiniteLyapunovExponentsIntegration(
+                            start + step, datetime.datetime(2000, 1, 11),
+                            step, lagrangian.IntegrationMode.FSLE, 0.2, 0.05,
+                            field)).restart(path)
+                with self.assertRaises(ValueError):
+                    lagrangian.MapOfFiniteLyapunovExponents(
+                        map_properties,
+                        lagrangian.FiniteLyapunovExponentsIntegration(
+                            start, datetime.datetime(2000, 1, 11), step,
+                            lagrangian.IntegrationMode.FTLE, 0, 0.05,
+                            field)).restart(path)
+                with self.assertRaises(ValueError):
+                    lagrangian.MapOfFiniteLyapunovExponents(
+                        map_properties,
+                        lagrangian.FiniteLyapunovExponentsIntegration(
+                            start, datetime.datetime(2000, 1, 11), step,
+                            lagrangian.IntegrationMode.FSLE, 0.3, 0.05,
+                            field)).restart(path)
+                with self.assertRaises(ValueError):
+                    lagrangian.MapOfFiniteLyapunovExponents(
+                        map_properties,
+                        fsle,
+                        lagrangian.Stencil.QUINTUPLET,
+                        shared_nodes=shared_nodes).restart(path)
+                with self.assertRaises(RuntimeError):
+                    map_of_fsle.restart(os.path.join(tmp, 'missing.ckpt'))
+
+    def test_tiles(self):
+        """The map computed by bands of longitudes is the map computed at
+        once"""
+        field = lagrangian.field.Vonkarman()
+        map_properties = lagrangian.MapProperties(50, 30, 0, -1, 0.05)
+        fsle = lagrangian.FiniteLyapunovExponentsIntegration(
+            datetime.datetime(2000, 1, 1), datetime.datetime(2000, 1, 11),
+            datetime.timedelta(hours=6), lagrangian.IntegrationMode.FSLE, 0.2,
+            0.05, field)
+        outputs = [
+            lagrangian.MapOutput.LAMBDA1, lagrangian.MapOutput.DELTA_T,
+            lagrangian.MapOutput.FINAL_SEPARATION
+        ]
+
+        for shared_nodes in [False, True]:
+            expected = lagrangian.MapOfFiniteLyapunovExponents(
+                map_properties, fsle, shared_nodes=shared_nodes)
+            expected.compute()
+            expected = expected.maps(outputs)
+
+            map_of_fsle = lagrangian.TiledMapOfFiniteLyapunovExponents(
+                map_properties, fsle, shared_nodes=shared_nodes)
+            tile_size = map_of_fsle.tile_size(30000, len(outputs))
+            self.assertGreater(tile_size, 1)
+            self.assertLess(tile_size, map_properties.nx)
+
+            result = numpy.full_like(expected, -1)
+            tiles = []
+
+            def callback(ix, maps):
+                self.assertEqual(maps.shape[0], len(outputs))
+                self.assertEqual(maps.shape[2], map_properties.ny)
+                tiles.append((ix, maps.shape[1]))
+                result[:, ix:ix + maps.shape[1], :] = maps
+
+            map_of_fsle.compute(outputs, callback, 30000, num_threads=2)
+            self.assertEqual(tiles[0][0], 0)
+            for (ix, nx), (next_ix, _) in zip(tiles, tiles[1:]):
+                self.assertEqual(nx, tile_size)
+                self.assertEqual(ix + nx, next_ix)
+            self.assertEqual(sum(nx for _, nx in tiles), map_properties.nx)
+            numpy.testing.assert_allclose(result, expected, rtol=1e-9)
+
+            # A single longitude must fit into the budget
+            with self.assertRaises(ValueError):
+                map_of_fsle.tile_size(100, len(outputs))
+            with self.assertRaises(ValueError):
+                map_of_fsle.compute(outputs, callback, 100)
+
+
+class TestAdvect(unittest.TestCase):
+
+    def test_snapshots(self):
+        """The snapshots taken during the advection give the positions of
+        the advections stopped at their dates"""
+        field = lagrangian.field.Vonkarman()
+        start = datetime.datetime(2000, 1, 1)
+        step = datetime.timedelta(hours=6)
+        integration = lagrangian.Path(start, datetime.datetime(2000, 1, 3),
+                                      step, field)
+        steps = len(list(integration.iterator()))
+        dates = [start + step * ix for ix in [steps, 0, 3, 5]]
+
+        advect = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+        advect.Initialize(integration)
+        x, y = advect.compute(integration, dates, num_threads=2)
+        self.assertEqual(x.shape, (4, 8, 4))
+        self.assertEqual(y.shape, (4, 8, 4))
+        numpy.testing.assert_array_equal(x[0], advect.map_of_x())
+        numpy.testing.assert_array_equal(y[0], advect.map_of_y())
+        map_properties = lagrangian.MapProperties(8, 4, 0, -1, 0.25)
+        numpy.testing.assert_array_equal(
+            x[1],
+            numpy.repeat(map_properties.x_axis()[:, numpy.newaxis], 4, 1))
+
+        for ix, date in enumerate(dates[2:]):
+            path = lagrangian.Path(start, date - step, step, field)
+            expected = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+            expected.Initialize(path)
+            expected.compute(path)
+            numpy.testing.assert_array_equal(x[ix + 2], expected.map_of_x())
+            numpy.testing.assert_array_equal(y[ix + 2], expected.map_of_y())
+
+        # Snapshots stored in single precision
+        advect.Initialize(integration)
+        x32, y32 = advect.compute(integration, dates, float32=True)
+        self.assertEqual(x32.dtype, numpy.float32)
+        numpy.testing.assert_array_equal(x32, x.astype(numpy.float32))
+        numpy.testing.assert_array_equal(y32, y.astype(numpy.float32))
+
+        # Snapshots handed out as soon as they are taken
+        snapshots = []
+        advect.Initialize(integration)
+        advect.compute(integration, dates,
+                       lambda date, *args: snapshots.append((date, *args)))
+        self.assertEqual([item[0] for item in snapshots], sorted(dates))
+        for date, xi, yi in snapshots:
+            numpy.testing.assert_array_equal(xi, x[dates.index(date)])
+            numpy.testing.assert_array_equal(yi, y[dates.index(date)])
+
+        with self.assertRaises(ValueError):
+            advect.compute(integration, [start + step / 2])
+
+    def test_checkpoint(self):
+        """The positions of the particles advected from a checkpoint
+        written on request are those of the advection never interrupted"""
+        field = lagrangian.field.Vonkarman()
+        start = datetime.datetime(2000, 1, 1)
+        step = datetime.timedelta(hours=6)
+        integration = lagrangian.Path(start, datetime.datetime(2000, 1, 3),
+                                      step, field)
+        expected = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+        expected.Initialize(integration)
+        expected.compute(integration)
+
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'advect.ckpt')
+            checkpoint = lagrangian.Checkpoint(path)
+            interrupted = lagrangian.Path(start, start + 2 * step, step,
+                                          field)
+            advect = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+            advect.Initialize(interrupted)
+            # The checkpoint is written at the end of the first time step
+            checkpoint.request()
+            advect.compute(interrupted, checkpoint=checkpoint)
+
+            advect = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+            advect.restart(integration, path)
+            snapshots = []
+            advect.compute(integration, [start, start + step],
+                           lambda date, *_: snapshots.append(date))
+            self.assertEqual(snapshots, [start + step])
+            numpy.testing.assert_array_equal(advect.map_of_x(),
+                                             expected.map_of_x())
+            numpy.testing.assert_array_equal(advect.map_of_y(),
+                                             expected.map_of_y())
+
+            # The snapshots before the restart point are set to the fill
+            # value
+            reference = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+            reference.Initialize(integration)
+            x_expected, y_expected = reference.compute(
+                integration, [start, start + step], fill_value=-1)
+            advect = lagrangian.core.Advect(8, 4, 0, -1, 0.25)
+            advect.restart(integration, path)
+            x, y = advect.compute(integration, [start, start + step],
+                                  fill_value=-1)
+            self.assertTrue(numpy.all(x[0] == -1))
+            self.assertTrue(numpy.all(y[0] == -1))
+            numpy.testing.assert_array_equal(x[1], x_expected[1])
+            numpy.testing.assert_array_equal(y[1], y_expected[1])
+
 
 if __name__ == '__main__':
     unittest.main()
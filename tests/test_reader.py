@@ -15,8 +15,11 @@
 import datetime
 import math
 import os
+import tempfile
 import unittest
 
+import numpy
+
 import lagrangian
 
 from . import SampleDataHandler
@@ -48,6 +51,152 @@ class TestReader(unittest.TestCase):
         self.assertEqual(reader.date('Grid_0001'),
                          datetime.datetime(2010, 1, 6))
 
+    def test_vectorized(self):
+        """The arrays of points give the values of the points interpolated
+        one by one"""
+        reader = lagrangian.reader.NetCDF()
+        reader.open(self.path)
+        reader.load('Grid_0001')
+        lon, lat = numpy.meshgrid(numpy.linspace(-180, 180, 181),
+                                  numpy.linspace(-90, 90, 91))
+        values, mask = reader.interpolate(lon, lat, float('nan'))
+        self.assertEqual(values.shape, lon.shape)
+        self.assertEqual(mask.shape, lon.shape)
+        self.assertTrue(mask.any())
+        numpy.testing.assert_array_equal(mask, ~numpy.isnan(values))
+        expected = numpy.array([
+            reader.interpolate(x, y, float('nan'))
+            for x, y in zip(lon.ravel(), lat.ravel())
+        ]).reshape(lon.shape)
+        numpy.testing.assert_allclose(values, expected, rtol=1e-12)
+
+        # The result does not depend on the number of threads
+        for num_threads in [1, 4]:
+            numpy.testing.assert_array_equal(
+                reader.interpolate(lon, lat, float('nan'),
+                                   num_threads=num_threads)[0], values)
+
+        with self.assertRaises(ValueError):
+            reader.interpolate(lon, lat[:-1])
+
+    def test_storage(self):
+        """Compare the interpolation of the grids stored in reduced
+        precision with the interpolation in double precision"""
+        readers = dict()
+        for storage in [
+                lagrangian.reader.Storage.FLOAT64,
+                lagrangian.reader.Storage.FLOAT32,
+                lagrangian.reader.Storage.INT16
+        ]:
+            readers[storage] = lagrangian.reader.NetCDF(storage)
+            readers[storage].open(self.path)
+            readers[storage].load_vector('Grid_0001', 'Grid_0002', 'm/s')
+
+        reference = readers[lagrangian.reader.Storage.FLOAT64]
+        x = numpy.random.uniform(-180, 180, 10000)
+        y = numpy.random.uniform(-80, 80, 10000)
+        expected = numpy.array([
+            reference.interpolate_vector(lon, lat, float('nan'))
+            for lon, lat in zip(x, y)
+        ])
+        for storage, delta in [(lagrangian.reader.Storage.FLOAT32, 1e-6),
+                               (lagrangian.reader.Storage.INT16, 1e-4)]:
+            values = numpy.array([
+                readers[storage].interpolate_vector(lon, lat, float('nan'))
+                for lon, lat in zip(x, y)
+            ])
+            # The undefined values are preserved
+            self.assertTrue(
+                numpy.all(numpy.isnan(values) == numpy.isnan(expected)))
+            mask = ~numpy.isnan(expected)
+            self.assertLess(numpy.abs(values - expected)[mask].max(), delta)
+
+    def test_bounding_box(self):
+        """The interpolation of a region of the grid gives the same values
+        as the interpolation of the whole grid"""
+        reference = lagrangian.reader.NetCDF()
+        reference.open(self.path)
+        reference.load_vector('Grid_0001', 'Grid_0002', 'm/s')
+
+        # The second region crosses the end of the longitude axis
+        for x_min, x_max in [(20, 60), (-30, 30)]:
+            reader = lagrangian.reader.NetCDF()
+            reader.set_bounding_box(x_min, x_max, -40, 40)
+            reader.open(self.path)
+            reader.load_vector('Grid_0001', 'Grid_0002', 'm/s')
+
+            x = numpy.random.uniform(x_min, x_max, 1000)
+            y = numpy.random.uniform(-40, 40, 1000)
+            # The cell joining the end and the beginning of the axis of the
+            # whole grid is extrapolated from its last node.
+            mask = numpy.mod(x, 360) < 359.5
+            x, y = x[mask], y[mask]
+            expected = numpy.array([
+                reference.interpolate_vector(lon, lat, float('nan'))
+                for lon, lat in zip(x, y)
+            ])
+            values = numpy.array([
+                reader.interpolate_vector(lon, lat, float('nan'))
+                for lon, lat in zip(x, y)
+            ])
+            numpy.testing.assert_allclose(values,
+                                          expected,
+                                          rtol=1e-9,
+                                          atol=1e-12)
+
+            # The points outside the region are outside the grid
+            self.assertTrue(
+                math.isnan(
+                    reader.interpolate_vector(x_max + 90, 0,
+                                              float('nan'))[0]))
+            self.assertTrue(
+                math.isnan(
+                    reader.interpolate_vector(x_min, 60, float('nan'))[0]))
+
+        with self.assertRaises(ValueError):
+            reader.set_bounding_box(10, 0, -40, 40)
+
+    def test_binary(self):
+        netcdf = lagrangian.reader.NetCDF()
+        netcdf.open(self.path)
+        netcdf.load_vector('Grid_0001', 'Grid_0002', 'm/s')
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            target = os.path.join(tmpdir, 'grid.bin')
+            lagrangian.reader.Binary.convert(self.path, 'Grid_0001',
+                                             'Grid_0002', 'm/s', target)
+            reader = lagrangian.reader.Binary()
+            reader.open(target)
+            self.assertEqual(reader.date('Grid_0001'),
+                             netcdf.date('Grid_0001'))
+
+            reader.load('Grid_0001')
+            self.assertAlmostEqual(reader.interpolate(0, 0),
+                                   -0.146913916157834)
+            reader.load('Grid_0001', 'cm/s')
+            self.assertAlmostEqual(reader.interpolate(0, 0),
+                                   -14.691391615783461)
+            with self.assertRaises(RuntimeError):
+                reader.load('Grid_0003')
+
+    @unittest.skipIf(os.name != 'posix', 'requires POSIX shared memory')
+    def test_shared_memory(self):
+        lagrangian.set_shared_memory(True)
+        try:
+            readers = [lagrangian.reader.NetCDF() for _ in range(2)]
+            for item in readers:
+                item.open(self.path)
+                item.load('Grid_0001', 'm/s')
+                self.assertAlmostEqual(item.interpolate(0, 0),
+                                       -0.146913916157834)
+            # The second reader must keep the grid after the first one is
+            # destroyed
+            del readers[0]
+            self.assertAlmostEqual(readers[0].interpolate(0, 0),
+                                   -0.146913916157834)
+        finally:
+            lagrangian.set_shared_memory(False)
+
 
 if __name__ == '__main__':
     unittest.main()